@@ -0,0 +1,225 @@
+#include "AOT.h"
+
+// to avoid compiler confusion, python.hpp must be include before Halide headers
+#include <boost/python.hpp>
+#include <boost/python/raw_function.hpp>
+
+#include "Halide.h"
+#include "GIL.h"
+#include "Image.h"
+
+#include <dlfcn.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace h = Halide;
+namespace p = boost::python;
+
+/// A pipeline compiled ahead of time by a Generator, loaded from a
+/// shared library and called through its halide_filter_metadata_t (the
+/// same way tools/RunGen.cpp calls it). No JIT compilation happens.
+class AOTPipeline {
+    typedef int (*argv_fn_t)(void **);
+    typedef const halide_filter_metadata_t *(*metadata_fn_t)();
+
+    argv_fn_t argv_fn;
+    const halide_filter_metadata_t *md;
+
+public:
+    AOTPipeline(const std::string &library, const std::string &function_name) {
+        // The library is never closed: the Halide runtime inside it may
+        // own worker threads and other global state.
+        void *lib = dlopen(library.c_str(), RTLD_LAZY | RTLD_LOCAL);
+        if (!lib) {
+            throw std::invalid_argument("Could not load library " + library + ": " + dlerror());
+        }
+        argv_fn = (argv_fn_t)dlsym(lib, (function_name + "_argv").c_str());
+        metadata_fn_t metadata_fn = (metadata_fn_t)dlsym(lib, (function_name + "_metadata").c_str());
+        if (!argv_fn || !metadata_fn) {
+            throw std::invalid_argument("Library " + library + " does not contain " +
+                                        function_name + "_argv and " + function_name + "_metadata. "
+                                        "Was it produced by a Generator?");
+        }
+        md = metadata_fn();
+    }
+
+    const halide_filter_metadata_t &metadata() const {
+        return *md;
+    }
+
+    int call(void **args) const {
+        return argv_fn(args);
+    }
+};
+
+namespace {
+
+h::Type halide_type_to_type(const halide_type_t &t) {
+    return h::Type((halide_type_code_t)t.code, t.bits, t.lanes);
+}
+
+halide_scalar_value_t python_object_to_scalar(p::object obj, const halide_filter_argument_t &arg) {
+    halide_scalar_value_t v;
+    const halide_type_t &t = arg.type;
+    if (t.code == halide_type_float) {
+        double d = p::extract<double>(obj);
+        if (t.bits == 32) {
+            v.u.f32 = (float)d;
+        } else {
+            v.u.f64 = d;
+        }
+    } else if (t.code == halide_type_int) {
+        int64_t i = p::extract<int64_t>(obj);
+        switch (t.bits) {
+        case 8: v.u.i8 = (int8_t)i; break;
+        case 16: v.u.i16 = (int16_t)i; break;
+        case 32: v.u.i32 = (int32_t)i; break;
+        default: v.u.i64 = i; break;
+        }
+    } else if (t.code == halide_type_uint) {
+        uint64_t u = p::extract<uint64_t>(obj);
+        switch (t.bits) {
+        case 1: v.u.b = (u != 0); break;
+        case 8: v.u.u8 = (uint8_t)u; break;
+        case 16: v.u.u16 = (uint16_t)u; break;
+        case 32: v.u.u32 = (uint32_t)u; break;
+        default: v.u.u64 = u; break;
+        }
+    } else {
+        // Handles (e.g. __user_context) may only be null.
+        if (!obj.is_none()) {
+            throw std::invalid_argument(std::string("Argument ") + arg.name + " is a handle and must be None");
+        }
+        v.u.handle = nullptr;
+    }
+    return v;
+}
+
+h::Buffer<> python_object_to_aot_buffer(p::object obj, const halide_filter_argument_t &arg) {
+    // Objects that support the buffer protocol (e.g. numpy arrays) are
+    // aliased directly; otherwise it must be a halide Buffer.
+    h::Buffer<> b;
+    if (PyObject_CheckBuffer(obj.ptr())) {
+        b = python_buffer_to_buffer(obj, arg.kind == halide_argument_kind_output_buffer);
+    } else {
+        b = python_object_to_buffer(obj);
+    }
+
+    if (b.type() != halide_type_to_type(arg.type)) {
+        throw std::invalid_argument(std::string("Argument ") + arg.name + " has the wrong type");
+    }
+    if (b.dimensions() != arg.dimensions) {
+        throw std::invalid_argument(std::string("Argument ") + arg.name + " should have " +
+                                    std::to_string(arg.dimensions) + " dimensions, but has " +
+                                    std::to_string(b.dimensions()));
+    }
+    return b;
+}
+
+std::string aot_pipeline_name(AOTPipeline &that) {
+    return that.metadata().name;
+}
+
+std::string aot_pipeline_target(AOTPipeline &that) {
+    return that.metadata().target;
+}
+
+p::list aot_pipeline_arguments(AOTPipeline &that) {
+    const halide_filter_metadata_t &md = that.metadata();
+    p::list result;
+    for (int i = 0; i < md.num_arguments; i++) {
+        const halide_filter_argument_t &arg = md.arguments[i];
+        p::dict d;
+        d["name"] = std::string(arg.name);
+        d["kind"] = (arg.kind == halide_argument_kind_input_scalar ? "input_scalar" :
+                     arg.kind == halide_argument_kind_input_buffer ? "input_buffer" :
+                     "output_buffer");
+        d["dimensions"] = arg.dimensions;
+        d["type"] = halide_type_to_type(arg.type);
+        result.append(d);
+    }
+    return result;
+}
+
+/// Call the pipeline. Positional arguments are matched, in order, with
+/// the arguments in the metadata that aren't handles; any argument can
+/// also be passed by name. Handles default to null.
+p::object aot_pipeline_call(p::tuple args, p::dict kwargs) {
+    AOTPipeline &that = p::extract<AOTPipeline &>(args[0]);
+    const halide_filter_metadata_t &md = that.metadata();
+    const int n = md.num_arguments;
+
+    std::vector<p::object> values(n);
+    int next_positional = 1, named = 0;
+    for (int i = 0; i < n; i++) {
+        const halide_filter_argument_t &arg = md.arguments[i];
+        if (kwargs.has_key(arg.name)) {
+            values[i] = kwargs[arg.name];
+            named++;
+        } else if (arg.type.code == halide_type_handle) {
+            // Leave it as None.
+        } else if (next_positional < p::len(args)) {
+            values[i] = args[next_positional++];
+        } else {
+            throw std::invalid_argument(std::string("Missing value for argument ") + arg.name);
+        }
+    }
+    if (next_positional != p::len(args)) {
+        throw std::invalid_argument("Too many arguments passed to " + std::string(md.name));
+    }
+    if (named != p::len(kwargs)) {
+        throw std::invalid_argument("Unknown named argument passed to " + std::string(md.name));
+    }
+
+    std::vector<halide_scalar_value_t> scalars(n);
+    std::vector<h::Buffer<>> buffers(n);
+    std::vector<void *> argv(n, nullptr);
+    for (int i = 0; i < n; i++) {
+        const halide_filter_argument_t &arg = md.arguments[i];
+        if (arg.kind == halide_argument_kind_input_scalar) {
+            scalars[i] = python_object_to_scalar(values[i], arg);
+            argv[i] = &scalars[i];
+        } else {
+            buffers[i] = python_object_to_aot_buffer(values[i], arg);
+            argv[i] = buffers[i].raw_buffer();
+        }
+    }
+
+    int result;
+    {
+        ScopedGILRelease release;
+        result = that.call(argv.data());
+    }
+    if (result != 0) {
+        throw std::runtime_error(std::string(md.name) + " returned error code " + std::to_string(result));
+    }
+    return p::object();
+}
+
+}  // namespace
+
+void defineAOT() {
+    p::class_<AOTPipeline>("AOTPipeline",
+                           "A pipeline compiled ahead of time by a Generator and linked "
+                           "into a shared library. Calling it doesn't require any JIT "
+                           "compilation. Buffer arguments can be halide Buffers or any "
+                           "object that supports the Python buffer protocol (e.g. numpy "
+                           "arrays), which are passed without copying. The GIL is released "
+                           "while the pipeline runs.",
+                           p::init<std::string, std::string>(
+                               p::args("self", "library", "function_name"),
+                               "Load the pipeline function_name from the shared library at "
+                               "the given path."))
+        .def("name", &aot_pipeline_name, p::arg("self"),
+             "The name of the pipeline function.")
+        .def("target", &aot_pipeline_target, p::arg("self"),
+             "The Target the pipeline was compiled for.")
+        .def("arguments", &aot_pipeline_arguments, p::arg("self"),
+             "A list of dicts describing the name, kind, dimensions and type of "
+             "each argument, in the order they are passed.")
+        .def("__call__", p::raw_function(&aot_pipeline_call, 1),
+             "Run the pipeline. Arguments are passed positionally in the order "
+             "given by arguments() (omitting handles), or by name.");
+}
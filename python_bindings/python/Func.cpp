@@ -5,6 +5,7 @@
 #include <boost/python.hpp>
 
 #include "Halide.h"
+#include "GIL.h"
 #include "Image.h"
 
 #include <boost/format.hpp>
@@ -47,27 +48,50 @@ h::Realization python_object_to_realization(p::object obj) {
     return h::Realization(buffers);
 }
 
+// Pipelines are compiled and run without holding the GIL, so that
+// several Python threads can run Halide pipelines at the same time.
+template <typename... Args>
+h::Realization func_realize_without_gil(h::Func &f, Args... args) {
+    ScopedGILRelease release;
+    return f.realize(args...);
+}
+
 template <typename... Args>
 p::object func_realize(h::Func &f, Args... args) {
-    return realization_to_python_object(f.realize(args...));
+    return realization_to_python_object(func_realize_without_gil(f, args...));
 }
 
 template <typename... Args>
 void func_realize_into(h::Func &f, Args... args) {
+    ScopedGILRelease release;
     f.realize(args...);
 }
 
 template <typename... Args>
 void func_realize_tuple(h::Func &f, p::tuple obj, Args... args) {
-    f.realize(python_object_to_realization(obj), args...);
+    h::Realization dst = python_object_to_realization(obj);
+    ScopedGILRelease release;
+    f.realize(dst, args...);
+}
+
+/// Realize into any writable object that implements the Python buffer
+/// protocol (e.g. a numpy array). The output aliases the object's memory,
+/// so no copy is made.
+template <typename... Args>
+void func_realize_into_python_buffer(h::Func &f, p::object obj, Args... args) {
+    h::Buffer<> dst = python_buffer_to_buffer(obj, true);
+    ScopedGILRelease release;
+    f.realize(dst, args...);
 }
 
 void func_compile_jit0(h::Func &that) {
+    ScopedGILRelease release;
     that.compile_jit();
     return;
 }
 
 void func_compile_jit1(h::Func &that, const h::Target &target = h::get_target_from_environment()) {
+    ScopedGILRelease release;
     that.compile_jit(target);
     return;
 }
@@ -248,6 +272,20 @@ void defineFunc() {
     const char *realize_into_doc =
         "Evaluate this function into the given buffer.";
 
+    const char *realize_into_python_buffer_doc =
+        "Evaluate this function into the memory of an object that supports "
+        "the Python buffer protocol, such as a numpy array. No copy is made.";
+
+    // Boost.Python tries overloads in the reverse order of registration,
+    // so these catch-all overloads must be registered first.
+    func_class
+        .def("realize", &func_realize_into_python_buffer<>,
+             p::args("self", "output"),
+             realize_into_python_buffer_doc)
+        .def("realize", &func_realize_into_python_buffer<h::Target>,
+             p::args("self", "output", "target"),
+             realize_into_python_buffer_doc);
+
     func_class
         .def("realize", &func_realize<>,
              p::args("self"),
@@ -0,0 +1,27 @@
+#ifndef GIL_H
+#define GIL_H
+
+#include <boost/python.hpp>
+
+/** Releases the Python global interpreter lock for as long as it is in
+ * scope, so that other Python threads can run while Halide compiles or
+ * runs a pipeline. No Python object may be touched while the lock is
+ * released. The lock is reacquired on scope exit, including when a
+ * Halide error is thrown. */
+class ScopedGILRelease {
+    PyThreadState *state;
+
+public:
+    ScopedGILRelease()
+        : state(PyEval_SaveThread()) {
+    }
+
+    ~ScopedGILRelease() {
+        PyEval_RestoreThread(state);
+    }
+
+    ScopedGILRelease(const ScopedGILRelease &) = delete;
+    ScopedGILRelease &operator=(const ScopedGILRelease &) = delete;
+};
+
+#endif  // GIL_H
@@ -474,6 +474,28 @@ void defineOperators() {
            "accurate up to the last 5 bits of the mantissa. Gets worse when "
            "approaching overflow. Vectorizes cleanly.");
 
+    p::def("fast_sin", &h::fast_sin, p::args("x"),
+           "Fast approximate cleanly vectorizable sin for Float(32) or "
+           "Float(64). Within about 2 ulp for |x| <= pi, losing precision "
+           "gradually for larger arguments. Vectorizes cleanly.");
+
+    p::def("fast_cos", &h::fast_cos, p::args("x"),
+           "Fast approximate cleanly vectorizable cos for Float(32) or "
+           "Float(64). Within about 2 ulp for |x| <= pi, losing precision "
+           "gradually for larger arguments. Vectorizes cleanly.");
+
+    p::def("fast_atan", &h::fast_atan, p::args("x"),
+           "Fast approximate cleanly vectorizable atan for Float(32) or "
+           "Float(64). Accurate to about 3 ulp. Vectorizes cleanly.");
+
+    p::def("fast_atan2", &h::fast_atan2, p::args("y", "x"),
+           "Fast approximate cleanly vectorizable atan2 for Float(32) or "
+           "Float(64). Accurate to about 3 ulp. Vectorizes cleanly.");
+
+    p::def("fast_tanh", &h::fast_tanh, p::args("x"),
+           "Fast approximate cleanly vectorizable tanh for Float(32) or "
+           "Float(64). Accurate to about 2 ulp. Vectorizes cleanly.");
+
     p::def("fast_pow", &h::fast_pow, p::args("x"),
            "Fast approximate cleanly vectorizable pow for Float(32). Returns "
            "nonsense for x < 0.0f. Accurate up to the last 5 bits of the "
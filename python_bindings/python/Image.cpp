@@ -22,6 +22,7 @@
 #include "Func.h"
 #include "Type.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -239,6 +240,37 @@ int buffer_extent(h::Buffer<T> &im, int d) {
 
 
 
+/// The numpy __array_interface__ of a Buffer, which lets numpy.asarray
+/// (and anything else that understands the protocol) use the Buffer's
+/// memory directly.
+template <typename T>
+p::dict buffer_array_interface(h::Buffer<T> &im) {
+    if (im.data() == nullptr) {
+        throw std::invalid_argument("Can't get the array interface of a Buffer with a null host pointer");
+    }
+
+    p::list shape, strides;
+    for (int i = 0; i < im.dimensions(); i++) {
+        shape.append(im.dim(i).extent());
+        strides.append((int64_t)im.dim(i).stride() * (int64_t)sizeof(T));
+    }
+
+    h::Type t = halide_type_of<T>();
+    const char *kind = t.is_float() ? "f" : t.is_uint() ? "u" : "i";
+    const char *byte_order = t.bytes() == 1 ? "|" : "<";
+
+    p::dict interface;
+    interface["shape"] = p::tuple(shape);
+    interface["strides"] = p::tuple(strides);
+    interface["typestr"] = std::string(byte_order) + kind + std::to_string(t.bytes());
+    // Buffers made from Python objects never alias read-only memory
+    // (see python_buffer_to_buffer), and all others own their memory,
+    // so the data is always writable.
+    interface["data"] = p::make_tuple((size_t)im.data(), false);
+    interface["version"] = 3;
+    return interface;
+}
+
 template <typename T>
 void defineBuffer_impl(const std::string suffix, const h::Type type) {
     using h::Buffer;
@@ -315,6 +347,11 @@ void defineBuffer_impl(const std::string suffix, const h::Type type) {
              "buffer represents this point in a function that was realized "
              "into this buffer.");
 
+    buffer_class
+        .add_property("__array_interface__", buffer_array_interface<T>,
+                      "The numpy array interface of this buffer. Allows "
+                      "numpy.asarray to use the buffer data without a copy.");
+
     buffer_class
         .def("set_min", buffer_set_min1<T>,
              p::args("self", "m0"),
@@ -476,6 +513,98 @@ h::Buffer<> python_object_to_buffer(p::object obj) {
     return h::Buffer<>();
 }
 
+h::Type python_buffer_format_to_type(const char *format, Py_ssize_t itemsize) {
+    std::string f = format ? format : "B";
+    // Native or little-endian byte order are both fine.
+    if (!f.empty() && (f[0] == '@' || f[0] == '=' || f[0] == '<')) {
+        f = f.substr(1);
+    }
+    const int bits = (int)itemsize * 8;
+    if (f.size() == 1) {
+        if (std::string("bhilq").find(f[0]) != std::string::npos) return h::Int(bits);
+        if (std::string("BHILQ").find(f[0]) != std::string::npos) return h::UInt(bits);
+        if (f[0] == 'f' || f[0] == 'd') return h::Float(bits);
+    }
+    throw std::invalid_argument("Buffer format \"" + std::string(format) + "\" has no Halide type equivalent");
+    return h::Type();
+}
+
+namespace {
+
+/// Holds on to a Py_buffer for as long as a Halide Buffer aliases its
+/// memory, so that the exporting object (e.g. a bytearray) can't
+/// reallocate or free it in the meantime.
+struct PythonBufferAllocation : h::Runtime::AllocationHeader {
+    Py_buffer view;
+
+    static void release(void *header) {
+        PythonBufferAllocation *a = (PythonBufferAllocation *)header;
+        // The last reference to the Buffer may be dropped by a thread
+        // that doesn't hold the GIL, e.g. inside a realize.
+        PyGILState_STATE state = PyGILState_Ensure();
+        PyBuffer_Release(&a->view);
+        PyGILState_Release(state);
+        delete a;
+    }
+};
+
+}  // namespace
+
+/// Will create a Halide::Buffer object pointing to the memory of any
+/// object that implements the Python buffer protocol (numpy arrays,
+/// memoryviews, array.array, bytearray, ...). No copy is made; the
+/// Buffer keeps the object's buffer export alive until the last
+/// reference to it is dropped. Read-only memory is only accepted if
+/// writable is false, which is for Buffers that Halide only reads and
+/// that are never handed back to Python.
+h::Buffer<> python_buffer_to_buffer(p::object obj, bool writable) {
+    PythonBufferAllocation *alloc = new PythonBufferAllocation;
+    Py_buffer &view = alloc->view;
+    int flags = PyBUF_STRIDES | PyBUF_FORMAT;
+    if (writable) {
+        flags |= PyBUF_WRITABLE;
+    }
+    if (PyObject_GetBuffer(obj.ptr(), &view, flags) != 0) {
+        delete alloc;
+        p::throw_error_already_set();
+    }
+
+    h::Type t;
+    std::vector<halide_dimension_t> shape(view.ndim);
+    try {
+        t = python_buffer_format_to_type(view.format, view.itemsize);
+        for (int i = 0; i < view.ndim; i++) {
+            if (view.strides[i] % view.itemsize != 0) {
+                throw std::invalid_argument("Can't create a Buffer from memory with "
+                                            "strides that aren't a multiple of the element size");
+            }
+            Py_ssize_t stride = view.strides[i] / view.itemsize;
+            if (view.shape[i] > INT32_MAX || stride > INT32_MAX || stride < INT32_MIN) {
+                throw std::invalid_argument("Can't create a Buffer from memory with "
+                                            "extents or strides that don't fit in 32 bits");
+            }
+            shape[i].min = 0;
+            shape[i].extent = (int32_t)view.shape[i];
+            shape[i].stride = (int32_t)stride;
+        }
+    } catch (...) {
+        PyBuffer_Release(&view);
+        delete alloc;
+        throw;
+    }
+
+    alloc->deallocate_fn = PythonBufferAllocation::release;
+    h::Buffer<> b(t, nullptr, (int)shape.size(), shape.data());
+    b.get()->adopt_allocation(alloc, view.buf);
+    return b;
+}
+
+p::object python_buffer_to_buffer_object(p::object obj) {
+    // The Buffer can be written to from Python, so it must not alias
+    // read-only memory.
+    return buffer_to_python_object(python_buffer_to_buffer(obj, true));
+}
+
 #ifdef USE_NUMPY
 
 bn::dtype type_to_dtype(const h::Type &t) {
@@ -491,33 +620,9 @@ bn::dtype type_to_dtype(const h::Type &t) {
     return bn::dtype::get_builtin<uint8_t>();
 }
 
-h::Type dtype_to_type(const bn::dtype &t) {
-    if (t == bn::dtype::get_builtin<uint8_t>()) return h::UInt(8);
-    if (t == bn::dtype::get_builtin<uint16_t>()) return h::UInt(16);
-    if (t == bn::dtype::get_builtin<uint32_t>()) return h::UInt(32);
-    if (t == bn::dtype::get_builtin<int8_t>()) return h::Int(8);
-    if (t == bn::dtype::get_builtin<int16_t>()) return h::Int(16);
-    if (t == bn::dtype::get_builtin<int32_t>()) return h::Int(32);
-    if (t == bn::dtype::get_builtin<float>()) return h::Float(32);
-    if (t == bn::dtype::get_builtin<double>()) return h::Float(64);
-    throw std::runtime_error("dtype_to_type received a numpy type with no known Halide type equivalent");
-    return h::Type();
-}
-
 /// Will create a Halide::Buffer object pointing to the array data
 p::object ndarray_to_buffer(bn::ndarray &array) {
-    h::Type t = dtype_to_type(array.get_dtype());
-    const int dims = array.get_nd();
-    void *host = reinterpret_cast<void *>(array.get_data());
-    halide_dimension_t *shape =
-        (halide_dimension_t *)__builtin_alloca(sizeof(halide_dimension_t) * dims);
-    for (int i = 0; i < dims; i++) {
-        shape[i].min = 0;
-        shape[i].extent = array.shape(i);
-        shape[i].stride = array.strides(i) / t.bytes();
-    }
-
-    return buffer_to_python_object(h::Buffer<>(t, host, dims, shape));
+    return python_buffer_to_buffer_object(array);
 }
 
 bn::ndarray buffer_to_ndarray(p::object buffer_object) {
@@ -609,7 +714,16 @@ void defineBuffer() {
     defineBuffer_impl<float>("_float32", h::Float(32));
     defineBuffer_impl<double>("_float64", h::Float(64));
 
-    // "Buffer" will look as a class, but instead it will be simply a factory method
+    // "Buffer" will look as a class, but instead it will be simply a factory method.
+    // Boost.Python tries overloads in the reverse order of registration, so
+    // the catch-all buffer protocol overload must be registered first.
+    p::def("Buffer", &python_buffer_to_buffer_object,
+           p::args("obj"),
+           p::with_custodian_and_ward_postcall<0, 1>(),  // the object reference count is increased
+           "Wrap any object that implements the Python buffer protocol "
+           "(e.g. a numpy array or a memoryview) in a Halide::Buffer. "
+           "Created Buffer refers to the object's memory (no copy).");
+
     p::def("Buffer", &BufferFactory::create_buffer0,
            p::args("type"),
            "Construct a zero-dimensional buffer of type T");
@@ -7,5 +7,6 @@
 void defineBuffer();
 boost::python::object buffer_to_python_object(const Halide::Buffer<> &);
 Halide::Buffer<> python_object_to_buffer(boost::python::object);
+Halide::Buffer<> python_buffer_to_buffer(boost::python::object, bool writable);
 
 #endif  // IMAGE_H
@@ -0,0 +1,58 @@
+#!/usr/bin/python3
+
+import os
+import subprocess
+import tempfile
+
+import halide as h
+import numpy as np
+
+def build_library(directory):
+    input = h.ImageParam(h.UInt(8), 2, "input")
+    offset = h.Param(h.UInt(8), "offset")
+    x, y = h.Var("x"), h.Var("y")
+
+    brighter = h.Func("brighter")
+    brighter[x, y] = input[x, y] + offset
+
+    obj = os.path.join(directory, "brighter.o")
+    lib = os.path.join(directory, "libbrighter.so")
+    brighter.compile_to_object(obj, [input, offset], "brighter")
+    subprocess.check_call(["cc", "-shared", "-o", lib, obj, "-lpthread", "-ldl"])
+    return lib
+
+def test_aot_pipeline():
+    directory = tempfile.mkdtemp()
+    pipeline = h.AOTPipeline(build_library(directory), "brighter")
+
+    assert pipeline.name() == "brighter"
+    names = [arg["name"] for arg in pipeline.arguments()]
+    assert names == ["input", "offset", "brighter"]
+
+    input = np.arange(64, dtype=np.uint8).reshape((8, 8))
+    output = np.zeros((8, 8), dtype=np.uint8)
+
+    # Positionally, then by name. The output is written in place.
+    pipeline(input, 10, output)
+    assert (output == input + 10).all()
+
+    pipeline(brighter=output, offset=3, input=input)
+    assert (output == input + 3).all()
+
+    # Halide buffers work too.
+    result = h.Buffer(h.UInt(8), 8, 8)
+    pipeline(input, 1, result)
+    assert result(3, 2) == input[3, 2] + 1
+
+    # Mismatched types are rejected.
+    try:
+        pipeline(input.astype(np.float32), 1, output)
+        assert False, "Expected an error for the wrong input type"
+    except ValueError:
+        pass
+
+    print("Success!")
+    return 0
+
+if __name__ == "__main__":
+    test_aot_pipeline()
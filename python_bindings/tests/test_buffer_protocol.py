@@ -0,0 +1,85 @@
+#!/usr/bin/python3
+
+import halide as h
+import numpy as np
+import array
+
+def test_realize_into_ndarray():
+    x, y = h.Var("x"), h.Var("y")
+    f = h.Func("f")
+    f[x, y] = x + y * 10
+
+    # Halide dimension i is numpy axis i, whatever the strides are.
+    output = np.zeros((8, 6), dtype=np.int32)
+    f.realize(output)
+    for ix in range(8):
+        for iy in range(6):
+            assert output[ix, iy] == ix + iy * 10
+
+    # Realizing into a non-contiguous view writes through to the original array.
+    output = np.zeros((6, 8), dtype=np.int32)
+    f.realize(output.T)
+    for ix in range(8):
+        for iy in range(6):
+            assert output[iy, ix] == ix + iy * 10
+
+def test_realize_into_array():
+    x = h.Var("x")
+    f = h.Func("f")
+    f[x] = h.cast(h.Float(32), x) * 0.5
+
+    output = array.array('f', [0.0] * 16)
+    f.realize(output)
+    for ix in range(16):
+        assert output[ix] == ix * 0.5
+
+def test_wrap_python_buffer():
+    data = bytearray(range(16))
+    b = h.Buffer(memoryview(data).cast('B', (4, 4)))
+    assert b.type() == h.UInt(8)
+    assert b.dimensions() == 2
+    assert b.stride(0) == 4
+    assert b.stride(1) == 1
+    assert b(1, 2) == 6
+
+    # The Buffer holds on to the export, so the bytearray can't be
+    # resized out from under it.
+    try:
+        data.extend(b"more")
+        assert False, "Resized a bytearray aliased by a Buffer"
+    except BufferError:
+        pass
+    del b
+    data.extend(b"more")
+
+    # Read-only memory can't be wrapped, because the Buffer could be
+    # written to.
+    try:
+        h.Buffer(memoryview(bytes(range(16))))
+        assert False, "Wrapped read-only memory in a Buffer"
+    except BufferError:
+        pass
+
+def test_array_interface():
+    x, y = h.Var("x"), h.Var("y")
+    f = h.Func("f")
+    f[x, y] = h.cast(h.UInt(16), x + y * 100)
+    b = f.realize(5, 3)
+
+    a = np.asarray(b)
+    assert a.dtype == np.uint16
+    assert a.shape == (5, 3)
+    assert a[4, 2] == b(4, 2)
+
+    # The array aliases the buffer.
+    a[1, 1] = 7
+    assert b(1, 1) == 7
+
+    print("Success!")
+    return 0
+
+if __name__ == "__main__":
+    test_realize_into_ndarray()
+    test_realize_into_array()
+    test_wrap_python_buffer()
+    test_array_interface()
@@ -13,6 +13,24 @@ using std::map;
 using std::pair;
 using std::make_pair;
 
+Stmt combine_checks(const vector<Stmt> &asserts) {
+    internal_assert(!asserts.empty());
+    if (asserts.size() == 1) {
+        return asserts[0];
+    }
+    // Check all the conditions at once, and only if that fails, go
+    // through them in order to find the one to report.
+    Expr all_ok;
+    Stmt failure;
+    for (size_t i = asserts.size(); i > 0; i--) {
+        const AssertStmt *a = asserts[i-1].as<AssertStmt>();
+        internal_assert(a) << "combine_checks expects only AssertStmts\n";
+        all_ok = all_ok.defined() ? (a->condition && all_ok) : a->condition;
+        failure = failure.defined() ? Block::make(asserts[i-1], failure) : asserts[i-1];
+    }
+    return IfThenElse::make(!all_ok, failure);
+}
+
 /* Find all the externally referenced buffers in a stmt */
 class FindBuffers : public IRGraphVisitor {
 public:
@@ -559,17 +577,17 @@ Stmt add_image_checks(Stmt s,
 
     // Inject the code that checks the host pointers.
     if (!no_asserts) {
-        for (size_t i = asserts_host_non_null.size(); i > 0; i--) {
-            s = Block::make(asserts_host_non_null[i-1], s);
+        if (!asserts_host_non_null.empty()) {
+            s = Block::make(combine_checks(asserts_host_non_null), s);
         }
-        for (size_t i = asserts_host_alignment.size(); i > 0; i--) {
-            s = Block::make(asserts_host_alignment[i-1], s);
+        if (!asserts_host_alignment.empty()) {
+            s = Block::make(combine_checks(asserts_host_alignment), s);
         }
     }
     // Inject the code that checks that no dimension math overflows
     if (!no_asserts) {
-        for (size_t i = dims_no_overflow_asserts.size(); i > 0; i--) {
-            s = Block::make(dims_no_overflow_asserts[i-1], s);
+        if (!dims_no_overflow_asserts.empty()) {
+            s = Block::make(combine_checks(dims_no_overflow_asserts), s);
         }
 
         // Inject the code that defines the proposed sizes.
@@ -590,18 +608,18 @@ Stmt add_image_checks(Stmt s,
 
     if (!no_asserts) {
         // Inject the code that checks the constraints are correct.
-        for (size_t i = asserts_constrained.size(); i > 0; i--) {
-            s = Block::make(asserts_constrained[i-1], s);
+        if (!asserts_constrained.empty()) {
+            s = Block::make(combine_checks(asserts_constrained), s);
         }
 
         // Inject the code that checks for out-of-bounds access to the buffers.
-        for (size_t i = asserts_required.size(); i > 0; i--) {
-            s = Block::make(asserts_required[i-1], s);
+        if (!asserts_required.empty()) {
+            s = Block::make(combine_checks(asserts_required), s);
         }
 
         // Inject the code that checks that elem_sizes are ok.
-        for (size_t i = asserts_elem_size.size(); i > 0; i--) {
-            s = Block::make(asserts_elem_size[i-1], s);
+        if (!asserts_elem_size.empty()) {
+            s = Block::make(combine_checks(asserts_elem_size), s);
         }
     }
 
@@ -617,8 +635,8 @@ Stmt add_image_checks(Stmt s,
 
     if (!no_asserts) {
         // Inject the code that checks the proposed sizes still pass the bounds checks
-        for (size_t i = asserts_proposed.size(); i > 0; i--) {
-            s = Block::make(asserts_proposed[i-1], s);
+        if (!asserts_proposed.empty()) {
+            s = Block::make(combine_checks(asserts_proposed), s);
         }
     }
 
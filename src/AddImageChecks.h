@@ -29,6 +29,12 @@ Stmt add_image_checks(Stmt s,
                       const std::map<std::string, Function> &env,
                       const FuncValueBounds &fb);
 
+/** Combine a list of AssertStmts into a single test of all of their
+ * conditions, which only if it fails goes through the asserts in
+ * order to report the first failing one. This keeps the common case
+ * to one branch, however many checks there are. */
+Stmt combine_checks(const std::vector<Stmt> &asserts);
+
 
 }
 }
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "AddParameterChecks.h"
+#include "AddImageChecks.h"
 #include "IRVisitor.h"
 #include "Substitute.h"
 #include "Target.h"
@@ -94,7 +97,8 @@ Stmt add_parameter_checks(Stmt s, const Target &t) {
         asserts.clear();
     }
 
-    // Inject the assert statements
+    // Make the assert statements
+    vector<Stmt> checks;
     for (size_t i = 0; i < asserts.size(); i++) {
         ParamAssert p = asserts[i];
         // Upgrade the types to 64-bit versions for the error call
@@ -124,7 +128,14 @@ Stmt add_parameter_checks(Stmt s, const Target &t) {
                                 {p.param_name, p.value, p.limit_value},
                                 Call::Extern);
 
-        s = Block::make(AssertStmt::make(p.condition, error), s);
+        checks.push_back(AssertStmt::make(p.condition, error));
+    }
+
+    // Inject them as one combined check. They're checked last one
+    // first, as they were when prepended one at a time.
+    if (!checks.empty()) {
+        std::reverse(checks.begin(), checks.end());
+        s = Block::make(combine_checks(checks), s);
     }
 
     return s;
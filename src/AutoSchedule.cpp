@@ -2400,6 +2400,9 @@ pair<VarOrRVar, VarOrRVar> Partitioner::split_dim(
         case TailStrategy::ShiftInwards:
             oss << ", TailStrategy::ShiftInwards)";
             break;
+        case TailStrategy::Predicate:
+            oss << ", TailStrategy::Predicate)";
+            break;
         case TailStrategy::Auto:
             oss << ")";
             break;
@@ -2646,6 +2649,23 @@ void Partitioner::generate_group_cpu_schedule(
         return;
     }
 
+    // If the output of the group is written once and is too large to
+    // stay in the last level cache until it is consumed, stream it
+    // out to memory instead of polluting the cache with it, if the
+    // machine parameters allow it.
+    if (arch_params.nontemporal_stores &&
+        g.output.stage_num == 0 && !g_out.has_update_definition()) {
+        const auto &iter = pipeline_bounds.find(out_f_name);
+        if (iter != pipeline_bounds.end()) {
+            Expr size = costs.region_size(out_f_name, iter->second);
+            if (size.defined() &&
+                can_prove(size > arch_params.last_level_cache_size)) {
+                Func(g_out).store_nontemporal();
+                sched.push_schedule(f_handle.name(), g.output.stage_num, "store_nontemporal()");
+            }
+        }
+    }
+
     // Realize tiling and update the dimension estimates
     vector<VarOrRVar> outer_dims;
     vector<VarOrRVar> inner_dims;
@@ -21,9 +21,15 @@ struct MachineParams {
     /** Indicates how much more expensive is the cost of a load compared to
      * the cost of an arithmetic operation at last level cache. */
     Expr balance;
-
-    explicit MachineParams(int32_t parallelism, int32_t llc, int32_t balance)
-        : parallelism(parallelism), last_level_cache_size(llc), balance(balance) {}
+    /** Whether root-computed stages that are written once and are
+     * larger than the last-level cache may be scheduled with
+     * Func::store_nontemporal. Off by default. */
+    bool nontemporal_stores;
+
+    explicit MachineParams(int32_t parallelism, int32_t llc, int32_t balance,
+                           bool nontemporal_stores = false)
+        : parallelism(parallelism), last_level_cache_size(llc), balance(balance),
+          nontemporal_stores(nontemporal_stores) {}
 };
 
 namespace Internal {
@@ -816,6 +816,34 @@ private:
         interval = result;
     }
 
+    void visit(const VectorReduce *op) {
+        op->value.accept(this);
+        int factor = op->value.type().lanes() / op->type.lanes();
+        switch (op->op) {
+        case VectorReduce::Add:
+            if (interval.has_upper_bound()) {
+                interval.max *= factor;
+            }
+            if (interval.has_lower_bound()) {
+                interval.min *= factor;
+            }
+            // As with Add, only float, int32 and int64 are assumed not to overflow
+            if (!op->type.is_float() && (!op->type.is_int() || op->type.bits() < 32)) {
+                bounds_of_type(op->type);
+            }
+            break;
+        case VectorReduce::Mul:
+            bounds_of_type(op->type);
+            break;
+        case VectorReduce::Min:
+        case VectorReduce::Max:
+        case VectorReduce::And:
+        case VectorReduce::Or:
+            // The result is one of the lanes of the value.
+            break;
+        }
+    }
+
     void visit(const LetStmt *) {
         internal_error << "Bounds of statement\n";
     }
@@ -975,7 +975,7 @@ public:
 
         in_stages.pop(stage_name);
 
-        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
     }
 
     void visit(const ProducerConsumer *p) {
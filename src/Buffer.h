@@ -361,6 +361,7 @@ public:
     HALIDE_BUFFER_FORWARD(device_detach_native)
     HALIDE_BUFFER_FORWARD(allocate)
     HALIDE_BUFFER_FORWARD(deallocate)
+    HALIDE_BUFFER_FORWARD(adopt_allocation)
     HALIDE_BUFFER_FORWARD(device_deallocate)
     HALIDE_BUFFER_FORWARD(device_free)
     HALIDE_BUFFER_FORWARD(fill)
@@ -151,7 +151,7 @@ class CanonicalizeGPUVars : public IRMutator {
             body.same_as(op->body)) {
             stmt = op;
         } else {
-            stmt = For::make(name, min, extent, op->for_type, op->device_api, body);
+            stmt = For::make(name, min, extent, op->for_type, op->device_api, body, op->parallel_schedule);
         }
     }
 
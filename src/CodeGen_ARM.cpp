@@ -2,7 +2,9 @@
 #include <sstream>
 
 #include "CodeGen_ARM.h"
+#include "CodeGen_Internal.h"
 #include "ConciseCasts.h"
+#include "FindIntrinsics.h"
 #include "IROperator.h"
 #include "IRMatch.h"
 #include "IREquality.h"
@@ -57,47 +59,14 @@ CodeGen_ARM::CodeGen_ARM(Target target) : CodeGen_Posix(target) {
 
         // Wider versions of the type
         Type w = t.with_bits(t.bits() * 2);
-        Type ws = Int(t.bits()*2, t.lanes());
 
-        // Vector wildcard for this type
-        Expr vector = Variable::make(t, "*");
+        // Vector wildcard for the wider type
         Expr w_vector = Variable::make(w, "*");
-        Expr ws_vector = Variable::make(ws, "*");
-
-        // Bounds of the type stored in the wider vector type
-        Expr tmin = simplify(cast(w, t.min()));
-        Expr tmax = simplify(cast(w, t.max()));
-        Expr tsmin = simplify(cast(ws, t.min()));
-        Expr tsmax = simplify(cast(ws, t.max()));
 
         Pattern p("", "", intrin_lanes, Expr(), Pattern::NarrowArgs);
 
-        // Rounding-up averaging
-        if (t.is_int()) {
-            p.intrin32 = "llvm.arm.neon.vrhadds" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.srhadd" + t_str;
-        } else {
-            p.intrin32 = "llvm.arm.neon.vrhaddu" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.urhadd" + t_str;
-        }
-
-        p.pattern = cast(t, (w_vector + w_vector + 1)/2);
-        casts.push_back(p);
-        p.pattern = cast(t, (w_vector + (w_vector + 1))/2);
-        casts.push_back(p);
-        p.pattern = cast(t, ((w_vector + 1) + w_vector)/2);
-        casts.push_back(p);
-
-        // Rounding down averaging
-        if (t.is_int()) {
-            p.intrin32 = "llvm.arm.neon.vhadds" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.shadd" + t_str;
-        } else {
-            p.intrin32 = "llvm.arm.neon.vhaddu" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.uhadd" + t_str;
-        }
-        p.pattern = cast(t, (w_vector + w_vector)/2);
-        casts.push_back(p);
+        // Saturating add and subtract, and rounding and truncating
+        // averaging, arrive as intrinsics. See visit(const Call *).
 
         // Halving subtract
         if (t.is_int()) {
@@ -109,41 +78,6 @@ CodeGen_ARM::CodeGen_ARM(Target target) : CodeGen_Posix(target) {
         }
         p.pattern = cast(t, (w_vector - w_vector)/2);
         casts.push_back(p);
-
-        // Saturating add
-        if (t.is_int()) {
-            p.intrin32 = "llvm.arm.neon.vqadds" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.sqadd" + t_str;
-        } else {
-            p.intrin32 = "llvm.arm.neon.vqaddu" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.uqadd" + t_str;
-        }
-        p.pattern = cast(t, clamp(w_vector + w_vector, tmin, tmax));
-        casts.push_back(p);
-
-        // In the unsigned case, the saturation below is unnecessary
-        if (t.is_uint()) {
-            p.pattern = cast(t, min(w_vector + w_vector, tmax));
-            casts.push_back(p);
-        }
-
-        // Saturating subtract
-        // N.B. Saturating subtracts always widen to a signed type
-        if (t.is_int()) {
-            p.intrin32 = "llvm.arm.neon.vqsubs" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.sqsub" + t_str;
-        } else {
-            p.intrin32 = "llvm.arm.neon.vqsubu" + t_str;
-            p.intrin64 = "llvm.aarch64.neon.uqsub" + t_str;
-        }
-        p.pattern = cast(t, clamp(ws_vector - ws_vector, tsmin, tsmax));
-        casts.push_back(p);
-
-        // In the unsigned case, we may detect that the top of the clamp is unnecessary
-        if (t.is_uint()) {
-            p.pattern = cast(t, max(ws_vector - ws_vector, 0));
-            casts.push_back(p);
-        }
     }
 
     casts.push_back(Pattern("vqrdmulh.v4i16", "sqrdmulh.v4i16", 4,
@@ -406,10 +340,8 @@ void CodeGen_ARM::visit(const Mul *op) {
 }
 
 Expr CodeGen_ARM::sorted_avg(Expr a, Expr b) {
-    Type ty = a.type();
-    Type wide_ty = ty.with_bits(ty.bits() * 2);
     // This will codegen to vhaddu (arm32) or uhadd (arm64).
-    return cast(ty, (cast(wide_ty, a) + cast(wide_ty, b))/2);
+    return halving_add(a, b);
 }
 
 void CodeGen_ARM::visit(const Div *op) {
@@ -428,6 +360,30 @@ void CodeGen_ARM::visit(const Div *op) {
 }
 
 void CodeGen_ARM::visit(const Add *op) {
+    #if LLVM_VERSION >= 60
+    // Four-way int8 dot products accumulated into int32 map onto
+    // sdot/udot when both sides have the same signedness.
+    if (target.bits == 64 &&
+        target.has_feature(Target::ARMDotProd) &&
+        !neon_intrinsics_disabled()) {
+        Expr acc, a, b;
+        const char *intrin = nullptr;
+        if (match_int8_dot_product(op, Int(8), Int(8), acc, a, b)) {
+            intrin = "sdot";
+        } else if (match_int8_dot_product(op, UInt(8), UInt(8), acc, a, b)) {
+            intrin = "udot";
+        }
+        if (intrin) {
+            int intrin_lanes = (op->type.lanes() % 4 == 0) ? 4 : 2;
+            std::ostringstream ss;
+            ss << "llvm.aarch64.neon." << intrin
+               << ".v" << intrin_lanes << "i32"
+               << ".v" << intrin_lanes * 4 << "i8";
+            value = call_intrin(op->type, intrin_lanes, ss.str(), {acc, a, b});
+            return;
+        }
+    }
+    #endif
     CodeGen_Posix::visit(op);
 }
 
@@ -940,6 +896,35 @@ void CodeGen_ARM::visit(const Load *op) {
 }
 
 void CodeGen_ARM::visit(const Call *op) {
+    if (op->type.is_vector() && op->type.bits() <= 32 && !neon_intrinsics_disabled()) {
+        string op32, op64;
+        if (op->is_intrinsic(Call::saturating_add)) {
+            op32 = "vqadd";
+            op64 = "qadd";
+        } else if (op->is_intrinsic(Call::saturating_sub)) {
+            op32 = "vqsub";
+            op64 = "qsub";
+        } else if (op->is_intrinsic(Call::halving_add)) {
+            op32 = "vhadd";
+            op64 = "hadd";
+        } else if (op->is_intrinsic(Call::rounding_halving_add)) {
+            op32 = "vrhadd";
+            op64 = "rhadd";
+        }
+        if (!op32.empty()) {
+            // Use the 64-bit version only when the args are 64-bits
+            // wide, and the 128-bit version for all other widths.
+            Type t = op->type;
+            int intrin_lanes = (t.bits() * t.lanes() == 64) ? t.lanes() : 128 / t.bits();
+            std::ostringstream t_str;
+            t_str << ".v" << intrin_lanes << "i" << t.bits();
+            char sign = t.is_int() ? 's' : 'u';
+            Pattern p(op32 + sign + t_str.str(), sign + op64 + t_str.str(), intrin_lanes, Expr());
+            value = call_pattern(p, t, op->args);
+            return;
+        }
+    }
+
     if (op->is_intrinsic(Call::abs) && op->type.is_uint()) {
         internal_assert(op->args.size() == 1);
         // If the arg is a subtract with narrowable args, we can use vabdl.
@@ -971,6 +956,153 @@ void CodeGen_ARM::visit(const Call *op) {
     CodeGen_Posix::visit(op);
 }
 
+void CodeGen_ARM::visit(const VectorReduce *op) {
+    const Type t = op->type;
+    const int in_lanes = op->value.type().lanes();
+    const int factor = in_lanes / t.lanes();
+
+    if (neon_intrinsics_disabled() ||
+        !(t.is_int() || t.is_uint()) || t.bits() > 32 ||
+        (op->op != VectorReduce::Add &&
+         op->op != VectorReduce::Min &&
+         op->op != VectorReduce::Max)) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    #if LLVM_VERSION >= 60
+    // Dot products of bytes of the same signedness, e.g. over an RDom
+    // vectorized by a multiple of four. sdot/udot sum groups of four
+    // adjacent products.
+    if (target.bits == 64 && target.has_feature(Target::ARMDotProd)) {
+        Expr a, b;
+        const char *intrin = nullptr;
+        if (match_int8_dot_product(op, Int(8), Int(8), a, b)) {
+            intrin = "sdot";
+        } else if (match_int8_dot_product(op, UInt(8), UInt(8), a, b)) {
+            intrin = "udot";
+        }
+        if (intrin) {
+            Type dot_t = Int(32, in_lanes / 4);
+            int intrin_lanes = (dot_t.lanes() % 4 == 0) ? 4 : 2;
+            ostringstream ss;
+            ss << "llvm.aarch64.neon." << intrin
+               << ".v" << intrin_lanes << "i32"
+               << ".v" << intrin_lanes * 4 << "i8";
+            value = call_intrin(dot_t, intrin_lanes, ss.str(), {make_zero(dot_t), a, b});
+            if (factor > 4) {
+                string name = unique_name('t');
+                sym_push(name, value);
+                Expr rest = Variable::make(dot_t, name);
+                value = codegen(VectorReduce::make(VectorReduce::Add, rest, t.lanes()));
+                sym_pop(name);
+            }
+            return;
+        }
+    }
+    #endif
+
+    // A sum of a widening cast, if the narrow type has the same
+    // signedness or is unsigned.
+    Expr narrow;
+    if (op->op == VectorReduce::Add) {
+        const Cast *c = op->value.as<Cast>();
+        if (c && c->value.type().bits() < t.bits() && c->value.type().bits() <= 16 &&
+            (c->value.type().is_uint() || (c->value.type().is_int() && t.is_int()))) {
+            narrow = c->value;
+        }
+    }
+
+    // Pairwise widening sums: vpaddl on arm, and saddlp/uaddlp on
+    // aarch64 (where total reductions are better done with addlv).
+    if (narrow.defined() && narrow.type().bits() * 2 == t.bits() && factor % 2 == 0 &&
+        !(target.bits == 64 && t.lanes() == 1)) {
+        Type pairs_t = t.with_lanes(in_lanes / 2);
+        ostringstream t_str;
+        t_str << ".v" << 128 / t.bits() << "i" << t.bits()
+              << ".v" << 128 / narrow.type().bits() << "i" << narrow.type().bits();
+        char sign = narrow.type().is_uint() ? 'u' : 's';
+        Pattern p(string("vpaddl") + sign + t_str.str(), sign + string("addlp") + t_str.str(),
+                  128 / t.bits(), Expr());
+        value = call_pattern(p, pairs_t, {narrow});
+        if (factor > 2) {
+            string name = unique_name('t');
+            sym_push(name, value);
+            Expr rest = Variable::make(pairs_t, name);
+            value = codegen(VectorReduce::make(VectorReduce::Add, rest, t.lanes()));
+            sym_pop(name);
+        }
+        return;
+    }
+
+    // The remaining instructions reduce across all the lanes of a
+    // vector, and only exist on aarch64.
+    if (target.bits != 64 || t.lanes() != 1) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    Expr v = narrow.defined() ? narrow : op->value;
+    const int bits = v.type().bits();
+    const int chunk = 128 / bits;
+    if (in_lanes > chunk && in_lanes % chunk == 0) {
+        // Reduce 128-bit pieces of the vector. Sums of widening casts
+        // are reduced separately and then added, and the other
+        // reductions combine the pieces first.
+        string name = unique_name('t');
+        Expr var = Variable::make(v.type(), name);
+        Expr e;
+        for (int i = 0; i < in_lanes; i += chunk) {
+            Expr piece = Shuffle::make_slice(var, i, 1, chunk);
+            if (narrow.defined()) {
+                piece = VectorReduce::make(VectorReduce::Add, cast(t.with_lanes(chunk), piece), 1);
+                e = e.defined() ? Add::make(e, piece) : piece;
+            } else if (!e.defined()) {
+                e = piece;
+            } else if (op->op == VectorReduce::Add) {
+                e = Add::make(e, piece);
+            } else if (op->op == VectorReduce::Min) {
+                e = Min::make(e, piece);
+            } else {
+                e = Max::make(e, piece);
+            }
+        }
+        if (!narrow.defined()) {
+            e = VectorReduce::make(op->op, e, 1);
+        }
+        value = codegen(Let::make(name, v, e));
+        return;
+    }
+
+    if (bits * in_lanes == 128 || (bits * in_lanes == 64 && bits < 32)) {
+        string intrin;
+        char sign = v.type().is_int() ? 's' : 'u';
+        if (narrow.defined()) {
+            intrin = "addlv";
+        } else if (op->op == VectorReduce::Add) {
+            intrin = "addv";
+        } else if (op->op == VectorReduce::Min) {
+            intrin = "minv";
+        } else {
+            intrin = "maxv";
+        }
+        ostringstream name;
+        name << "llvm.aarch64.neon." << sign << intrin
+             << ".i32.v" << in_lanes << "i" << bits;
+
+        // These return an i32, of which we want the low bits.
+        Value *arg = codegen(v);
+        llvm::FunctionType *fn_type = FunctionType::get(i32_t, {arg->getType()}, false);
+        llvm::Function *fn = dyn_cast_or_null<llvm::Function>(module->getOrInsertFunction(name.str(), fn_type));
+        internal_assert(fn);
+        value = builder->CreateCall(fn, {arg});
+        value = builder->CreateIntCast(value, llvm_type_of(t), t.is_int());
+        return;
+    }
+
+    CodeGen_Posix::visit(op);
+}
+
 string CodeGen_ARM::mcpu() const {
     if (target.bits == 32) {
         if (target.has_feature(Target::ARMv7s)) {
@@ -988,6 +1120,13 @@ string CodeGen_ARM::mcpu() const {
 }
 
 string CodeGen_ARM::mattrs() const {
+    // The dot-product instructions are only used on 64-bit targets.
+    std::string dot_prod;
+    #if LLVM_VERSION >= 60
+    if (target.has_feature(Target::ARMDotProd)) {
+        dot_prod = "+v8.2a,+dotprod";
+    }
+    #endif
     if (target.bits == 32) {
         if (target.has_feature(Target::ARMv7s)) {
             return "+neon";
@@ -998,9 +1137,9 @@ string CodeGen_ARM::mattrs() const {
         }
     } else {
         if (target.os == Target::IOS || target.os == Target::OSX) {
-            return "+reserve-x18";
+            return dot_prod.empty() ? "+reserve-x18" : "+reserve-x18," + dot_prod;
         } else {
-            return "";
+            return dot_prod;
         }
     }
 }
@@ -1018,4 +1157,10 @@ int CodeGen_ARM::native_vector_bits() const {
     return 128;
 }
 
+int CodeGen_ARM::max_carried_registers() const {
+    // Use at most half of the vector registers (32 on aarch64, 16 on
+    // armv7) for carrying values.
+    return target.bits == 64 ? 16 : 8;
+}
+
 }}
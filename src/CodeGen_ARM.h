@@ -35,6 +35,7 @@ protected:
     void visit(const Store *);
     void visit(const Load *);
     void visit(const Call *);
+    void visit(const VectorReduce *);
     // @}
 
     /** Various patterns to peephole match against */
@@ -68,6 +69,7 @@ protected:
     std::string mattrs() const;
     bool use_soft_float_abi() const;
     int native_vector_bits() const;
+    int max_carried_registers() const;
 
     // NEON can be disabled for older processors.
     bool neon_intrinsics_disabled() {
@@ -4,6 +4,7 @@
 #include "CodeGen_C.h"
 #include "CodeGen_Internal.h"
 #include "Substitute.h"
+#include "FindIntrinsics.h"
 #include "IROperator.h"
 #include "Param.h"
 #include "Var.h"
@@ -187,6 +188,12 @@ public:
         IRGraphVisitor::visit(op);
     }
 
+    // Vector reductions are emitted as a tree of shuffles, which
+    // uses vector types of intermediate sizes.
+    void visit(const VectorReduce *op) {
+        include(lower_vector_reduce(op));
+    }
+
     void visit(const For *op) {
         for_types_used.insert(op->for_type);
         IRGraphVisitor::visit(op);
@@ -1568,6 +1575,17 @@ void CodeGen_C::compile(const LoweredFunc &f) {
 
         // And also the metadata.
         stream << "const struct halide_filter_metadata_t *" << simple_name << "_metadata() HALIDE_FUNCTION_ATTRS;\n";
+
+        // And the batch version, which takes an array of buffers for
+        // each buffer argument.
+        if (target.has_feature(Target::Batch)) {
+            compile_batch_wrapper(simple_name, args);
+        }
+    }
+
+    if (!is_header() && f.linkage == LoweredFunc::ExternalPlusMetadata &&
+        target.has_feature(Target::Batch)) {
+        compile_batch_wrapper(simple_name, args);
     }
 
     if (!namespaces.empty()) {
@@ -1603,6 +1621,69 @@ inline const struct halide_filter_metadata_t* (*HALIDE_GET_STANDARD_METADATA_FUN
     }
 }
 
+void CodeGen_C::compile_batch_wrapper(const string &simple_name, const std::vector<LoweredArgument> &args) {
+    // The batch version has the same arguments, except that each
+    // buffer is replaced by an array of buffers, and the batch size
+    // goes last.
+    std::vector<string> names, types;
+    for (const LoweredArgument &arg : args) {
+        if (arg.is_buffer()) {
+            names.push_back(print_name(arg.name) + "_buffers");
+            types.push_back("struct halide_buffer_t **");
+        } else {
+            names.push_back(print_name(arg.name));
+            types.push_back(print_type(arg.type, AppendSpace));
+        }
+    }
+
+    const string closure_name = simple_name + "_batch_closure";
+    const string task_name = simple_name + "_batch_task";
+    if (!is_header()) {
+        // Define it like CodeGen_LLVM::add_batch_wrapper does: pack
+        // the arguments into a closure, and run one task per item of
+        // the batch with halide_do_par_for.
+        stream << "struct " << closure_name << " {\n";
+        for (size_t i = 0; i < args.size(); i++) {
+            stream << "    " << types[i] << names[i] << ";\n";
+        }
+        stream << "};\n\n";
+
+        stream << "static int " << task_name << "(void *_ucon, int _idx, uint8_t *_closure) {\n";
+        stream << "    const struct " << closure_name << " *_args = (const struct " << closure_name << " *)_closure;\n";
+        stream << "    return " << simple_name << "(";
+        for (size_t i = 0; i < args.size(); i++) {
+            stream << (i > 0 ? ", " : "") << "_args->" << names[i];
+            if (args[i].is_buffer()) {
+                stream << "[_idx]";
+            }
+        }
+        stream << ");\n";
+        stream << "}\n\n";
+    }
+
+    stream << "int " << simple_name << "_batch(";
+    for (size_t i = 0; i < args.size(); i++) {
+        stream << types[i] << names[i] << ", ";
+    }
+    stream << "int batch_size) HALIDE_FUNCTION_ATTRS";
+
+    if (is_header()) {
+        stream << ";\n";
+        return;
+    }
+
+    stream << " {\n";
+    stream << "    struct " << closure_name << " _closure = {";
+    for (size_t i = 0; i < args.size(); i++) {
+        stream << (i > 0 ? ", " : "") << names[i];
+    }
+    stream << "};\n";
+    stream << "    return halide_do_par_for("
+           << (have_user_context ? "const_cast<void *>(__user_context)" : "nullptr")
+           << ", " << task_name << ", 0, batch_size, (uint8_t *)&_closure);\n";
+    stream << "}\n";
+}
+
 void CodeGen_C::compile(const Buffer<> &buffer) {
     // Don't define buffers in headers.
     if (is_header()) {
@@ -2137,10 +2218,15 @@ void CodeGen_C::visit(const Call *op) {
         rhs << "__builtin_prefetch("
             << "((" << print_type(op->type) << " *)" << print_name(base->name)
             << " + " << print_expr(op->args[1]) << "), 1)";
+    } else if (op->is_intrinsic(Call::nontemporal_store_fence)) {
+        // The C backend emits ordinary stores, so no fence is needed.
+        rhs << "0";
     } else if (op->is_intrinsic(Call::indeterminate_expression)) {
         user_error << "Indeterminate expression occurred during constant-folding.\n";
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
         rhs << "(sizeof(halide_buffer_t))";
+    } else if (is_fixed_point_intrinsic(op)) {
+        rhs << print_expr(lower_intrinsic(op));
     } else if (op->call_type == Call::Intrinsic ||
                op->call_type == Call::PureIntrinsic) {
         // TODO: other intrinsics
@@ -2376,7 +2462,13 @@ void CodeGen_C::visit(const ProducerConsumer *op) {
 void CodeGen_C::visit(const For *op) {
     if (op->for_type == ForType::Parallel) {
         do_indent();
-        stream << "#pragma omp parallel for\n";
+        stream << "#pragma omp parallel for";
+        if (op->parallel_schedule == ParallelSchedule::Static) {
+            stream << " schedule(static)";
+        } else if (op->parallel_schedule == ParallelSchedule::Guided) {
+            stream << " schedule(guided)";
+        }
+        stream << "\n";
     } else {
         internal_assert(op->for_type == ForType::Serial)
             << "Can only emit serial or parallel for loops to C\n";
@@ -2553,6 +2645,10 @@ void CodeGen_C::visit(const Realize *op) {
     internal_error << "Cannot emit realize statements to C\n";
 }
 
+void CodeGen_C::visit(const VectorReduce *op) {
+    print_expr(lower_vector_reduce(op));
+}
+
 void CodeGen_C::visit(const Prefetch *op) {
     internal_error << "Cannot emit prefetch statements to C\n";
 }
@@ -54,6 +54,11 @@ protected:
     virtual void compile(const Buffer<> &buffer);
     // @}
 
+    /** Emit the declaration of the batched entry point of a function
+     * compiled with Target::Batch, or in source outputs, its
+     * definition. */
+    void compile_batch_wrapper(const std::string &simple_name, const std::vector<LoweredArgument> &args);
+
     /** An ID for the most recently generated ssa variable */
     std::string id;
 
@@ -200,6 +205,7 @@ protected:
     void visit(const IfThenElse *);
     void visit(const Evaluate *);
     void visit(const Shuffle *);
+    void visit(const VectorReduce *);
     void visit(const Prefetch *);
 
     void visit_binop(Type t, Expr a, Expr b, const char *op);
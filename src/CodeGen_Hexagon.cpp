@@ -217,8 +217,7 @@ void CodeGen_Hexagon::compile_func(const LoweredFunc &f,
     debug(2) << "Lowering after aligning loads:\n" << body << "\n\n";
 
     debug(1) << "Carrying values across loop iterations...\n";
-    // Use at most 16 vector registers for carrying values.
-    body = loop_carry(body, 16);
+    body = loop_carry(body, max_carried_registers(), native_vector_bits());
     body = simplify(body);
     debug(2) << "Lowering after forwarding stores:\n" << body << "\n\n";
 
@@ -1515,6 +1514,11 @@ int CodeGen_Hexagon::native_vector_bits() const {
     }
 }
 
+int CodeGen_Hexagon::max_carried_registers() const {
+    // Use at most half of the 32 HVX registers for carrying values.
+    return 16;
+}
+
 void CodeGen_Hexagon::visit(const Add *op) {
     if (op->type.is_vector()) {
         value = call_intrin(op->type,
@@ -1,8 +1,12 @@
+#include <algorithm>
+
 #include "CodeGen_Internal.h"
 #include "IROperator.h"
 #include "IRMutator.h"
 #include "CSE.h"
 #include "Debug.h"
+#include "IREquality.h"
+#include "Simplify.h"
 
 namespace Halide {
 namespace Internal {
@@ -151,6 +155,7 @@ bool function_takes_user_context(const std::string &name) {
         "halide_device_and_host_malloc",
         "halide_device_sync",
         "halide_do_par_for",
+        "halide_do_par_for_with_schedule",
         "halide_do_task",
         "halide_error",
         "halide_free",
@@ -268,6 +273,69 @@ Expr lower_euclidean_mod(Expr a, Expr b) {
 
 namespace {
 
+Expr vector_reduce_binop(VectorReduce::Operator op, Expr a, Expr b) {
+    switch (op) {
+    case VectorReduce::Add:
+        return Add::make(std::move(a), std::move(b));
+    case VectorReduce::Mul:
+        return Mul::make(std::move(a), std::move(b));
+    case VectorReduce::Min:
+        return Min::make(std::move(a), std::move(b));
+    case VectorReduce::Max:
+        return Max::make(std::move(a), std::move(b));
+    case VectorReduce::And:
+        return And::make(std::move(a), std::move(b));
+    case VectorReduce::Or:
+        return Or::make(std::move(a), std::move(b));
+    }
+    return Expr();
+}
+
+}  // namespace
+
+Expr lower_vector_reduce(const VectorReduce *op) {
+    const int lanes = op->type.lanes();
+    Expr v = op->value;
+    vector<pair<string, Expr>> lets;
+    while (v.type().lanes() > lanes) {
+        if (!v.as<Variable>()) {
+            string name = unique_name('t');
+            lets.push_back({name, v});
+            v = Variable::make(v.type(), name);
+        }
+        int n = v.type().lanes();
+        int factor = n / lanes;
+        if (factor % 2 == 0) {
+            // Halve the reduction factor. For a total reduction,
+            // combining the two halves of the vector keeps the slices
+            // dense. Otherwise, combining the even and odd lanes keeps
+            // each group of lanes together.
+            Expr a, b;
+            if (lanes == 1) {
+                a = Shuffle::make_slice(v, 0, 1, n / 2);
+                b = Shuffle::make_slice(v, n / 2, 1, n / 2);
+            } else {
+                a = Shuffle::make_slice(v, 0, 2, n / 2);
+                b = Shuffle::make_slice(v, 1, 2, n / 2);
+            }
+            v = vector_reduce_binop(op->op, a, b);
+        } else {
+            // Combine the k'th lane of every group, for each k.
+            Expr result = Shuffle::make_slice(v, 0, factor, lanes);
+            for (int k = 1; k < factor; k++) {
+                result = vector_reduce_binop(op->op, result, Shuffle::make_slice(v, k, factor, lanes));
+            }
+            v = result;
+        }
+    }
+    for (size_t i = lets.size(); i > 0; i--) {
+        v = Let::make(lets[i - 1].first, lets[i - 1].second, v);
+    }
+    return v;
+}
+
+namespace {
+
 // This mutator rewrites predicated loads and stores as unpredicated
 // loads/stores with explicit conditions, scalarizing if necessary.
 class UnpredicateLoadsStores : public IRMutator {
@@ -354,6 +422,183 @@ Stmt unpredicate_loads_stores(Stmt s) {
     return UnpredicateLoadsStores().mutate(s);
 }
 
+namespace {
+
+void flatten_sum(const Expr &e, vector<Expr> &terms) {
+    if (const Add *add = e.as<Add>()) {
+        flatten_sum(add->a, terms);
+        flatten_sum(add->b, terms);
+    } else {
+        terms.push_back(e);
+    }
+}
+
+// Given the four stride-4 slices of some vector (slice k starting at
+// element k), reconstruct that vector if it is a dense load or a
+// single vector being sliced. Returns an undefined Expr otherwise.
+Expr vector_from_quarter_slices(const vector<Expr> &slices) {
+    internal_assert(slices.size() == 4);
+    const int lanes = slices[0].type().lanes() * 4;
+
+    const Load *l0 = slices[0].as<Load>();
+    const Ramp *r0 = l0 ? l0->index.as<Ramp>() : nullptr;
+    if (r0 && is_one(l0->predicate) && is_const(r0->stride, 4)) {
+        bool dense = true;
+        for (int k = 1; k < 4 && dense; k++) {
+            const Load *lk = slices[k].as<Load>();
+            const Ramp *rk = lk ? lk->index.as<Ramp>() : nullptr;
+            dense = (rk && lk->name == l0->name && is_one(lk->predicate) &&
+                     is_const(rk->stride, 4) &&
+                     is_const(simplify(rk->base - r0->base), k));
+        }
+        if (dense) {
+            return Load::make(l0->type.with_lanes(lanes), l0->name,
+                              Ramp::make(r0->base, 1, lanes),
+                              l0->image, l0->param, const_true(lanes));
+        }
+    }
+
+    const Shuffle *s0 = slices[0].as<Shuffle>();
+    if (s0 && s0->vectors.size() == 1 && s0->is_slice() &&
+        s0->slice_begin() == 0 && s0->slice_stride() == 4 &&
+        s0->vectors[0].type().lanes() == lanes) {
+        bool same = true;
+        for (int k = 1; k < 4 && same; k++) {
+            const Shuffle *sk = slices[k].as<Shuffle>();
+            same = (sk && sk->vectors.size() == 1 && sk->is_slice() &&
+                    sk->slice_begin() == k && sk->slice_stride() == 4 &&
+                    equal(sk->vectors[0], s0->vectors[0]));
+        }
+        if (same) {
+            return s0->vectors[0];
+        }
+    }
+
+    return Expr();
+}
+
+}  // namespace
+
+bool match_int8_dot_product(const Add *op, Type a_type, Type b_type,
+                            Expr &acc, Expr &a, Expr &b) {
+    const Type t = op->type;
+    if (!(t.is_int() && t.bits() == 32 && t.lanes() >= 2)) {
+        return false;
+    }
+    internal_assert(a_type.bits() == 8 && b_type.bits() == 8);
+    a_type = a_type.with_lanes(t.lanes());
+    b_type = b_type.with_lanes(t.lanes());
+
+    vector<Expr> terms;
+    flatten_sum(op, terms);
+
+    vector<Expr> a_slices, b_slices, rest;
+    for (const Expr &e : terms) {
+        const Mul *mul = e.as<Mul>();
+        if (mul && a_slices.size() < 4) {
+            Expr ma = lossless_cast(a_type, mul->a);
+            Expr mb = lossless_cast(b_type, mul->b);
+            if (!ma.defined() || !mb.defined()) {
+                ma = lossless_cast(a_type, mul->b);
+                mb = lossless_cast(b_type, mul->a);
+            }
+            if (ma.defined() && mb.defined()) {
+                a_slices.push_back(ma);
+                b_slices.push_back(mb);
+                continue;
+            }
+        }
+        rest.push_back(e);
+    }
+
+    if (a_slices.size() != 4) {
+        return false;
+    }
+
+    // The products may appear in any order in the sum. Any consistent
+    // permutation of the slices of a and b gives the same dot
+    // product, but put them in order of their offsets into a if a is
+    // a sliced load, so that it can be reassembled into a dense load.
+    const Load *l0 = a_slices[0].as<Load>();
+    const Ramp *r0 = l0 ? l0->index.as<Ramp>() : nullptr;
+    if (r0) {
+        vector<int64_t> offsets;
+        for (const Expr &e : a_slices) {
+            const Load *l = e.as<Load>();
+            const Ramp *r = l ? l->index.as<Ramp>() : nullptr;
+            const int64_t *k = r ? as_const_int(simplify(r->base - r0->base)) : nullptr;
+            if (!k) break;
+            offsets.push_back(*k);
+        }
+        if (offsets.size() == 4) {
+            int64_t min_offset = *std::min_element(offsets.begin(), offsets.end());
+            vector<Expr> a_sorted(4), b_sorted(4);
+            bool ok = true;
+            for (int i = 0; i < 4 && ok; i++) {
+                int64_t k = offsets[i] - min_offset;
+                ok = (k < 4 && !a_sorted[k].defined());
+                if (ok) {
+                    a_sorted[k] = a_slices[i];
+                    b_sorted[k] = b_slices[i];
+                }
+            }
+            if (ok) {
+                a_slices.swap(a_sorted);
+                b_slices.swap(b_sorted);
+            }
+        }
+    }
+
+    a = vector_from_quarter_slices(a_slices);
+    b = vector_from_quarter_slices(b_slices);
+    if (!a.defined() && !b.defined()) {
+        // Neither operand is a single vector in disguise. Don't pay
+        // for two four-way interleaves.
+        return false;
+    }
+    if (!a.defined()) {
+        a = Shuffle::make_interleave(a_slices);
+    }
+    if (!b.defined()) {
+        b = Shuffle::make_interleave(b_slices);
+    }
+
+    if (rest.empty()) {
+        acc = make_zero(t);
+    } else {
+        acc = rest[0];
+        for (size_t i = 1; i < rest.size(); i++) {
+            acc = acc + rest[i];
+        }
+    }
+    return true;
+}
+
+bool match_int8_dot_product(const VectorReduce *op, Type a_type, Type b_type,
+                            Expr &a, Expr &b) {
+    const Type t = op->type;
+    const int in_lanes = op->value.type().lanes();
+    if (op->op != VectorReduce::Add || !(t.is_int() && t.bits() == 32) ||
+        (in_lanes / t.lanes()) % 4 != 0) {
+        return false;
+    }
+    internal_assert(a_type.bits() == 8 && b_type.bits() == 8);
+    a_type = a_type.with_lanes(in_lanes);
+    b_type = b_type.with_lanes(in_lanes);
+
+    const Mul *mul = op->value.as<Mul>();
+    if (!mul) {
+        return false;
+    }
+    a = lossless_cast(a_type, mul->a);
+    b = lossless_cast(b_type, mul->b);
+    if (!a.defined() || !b.defined()) {
+        a = lossless_cast(a_type, mul->b);
+        b = lossless_cast(b_type, mul->a);
+    }
+    return a.defined() && b.defined();
+}
+
 bool get_md_bool(llvm::Metadata *value, bool &result) {
     if (!value) {
         return false;
@@ -62,10 +62,37 @@ Expr lower_euclidean_div(Expr a, Expr b);
 Expr lower_euclidean_mod(Expr a, Expr b);
 ///@}
 
+/** Rewrite a horizontal vector reduction as a tree of shuffles and
+ * binary operations. Backends use this for the reductions they have
+ * no instruction for. */
+Expr lower_vector_reduce(const VectorReduce *op);
+
 /** Replace predicated loads/stores with unpredicated equivalents
  * inside branches. */
 Stmt unpredicate_loads_stores(Stmt s);
 
+/** Recognize an int32 sum containing four widening products of 8-bit
+ * values, acc + a_0*b_0 + a_1*b_1 + a_2*b_2 + a_3*b_3, where the a_k
+ * narrow losslessly to a_type and the b_k to b_type. This is the shape
+ * of a four-way unrolled int8 dot product, and maps onto instructions
+ * like vpdpbusd and sdot/udot. On success, a and b are set to the 8-bit
+ * vectors (with four times as many lanes as op) whose element 4*i + k
+ * is lane i of a_k (resp. b_k), and acc is set to the remaining terms,
+ * or zero. At least one of the operands must be reassemblable into a
+ * dense load or an existing vector. */
+bool match_int8_dot_product(const Add *op, Type a_type, Type b_type,
+                            Expr &acc, Expr &a, Expr &b);
+
+/** Recognize a sum, over groups of a multiple of four adjacent lanes,
+ * of widening products of 8-bit values. This is the shape of an int8
+ * dot product over an RDom vectorized by a multiple of four. On
+ * success, a and b are set to the 8-bit operands of the product, which
+ * have as many lanes as op->value. Summing groups of four adjacent
+ * lanes of their product is what instructions like vpdpbusd and
+ * sdot/udot do. */
+bool match_int8_dot_product(const VectorReduce *op, Type a_type, Type b_type,
+                            Expr &a, Expr &b);
+
 /** Given an llvm::Module, set llvm:TargetOptions, cpu and attr information */
 void get_target_options(const llvm::Module &module, llvm::TargetOptions &options, std::string &mcpu, std::string &mattrs);
 
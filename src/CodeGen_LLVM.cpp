@@ -12,12 +12,14 @@
 #include "Simplify.h"
 #include "JITModule.h"
 #include "CodeGen_Internal.h"
+#include "FindIntrinsics.h"
 #include "Lerp.h"
 #include "Util.h"
 #include "LLVM_Runtime_Linker.h"
 #include "MatlabWrapper.h"
 #include "IntegerDivisionTable.h"
 #include "CSE.h"
+#include "LoopCarry.h"
 
 #include "CodeGen_X86.h"
 #include "CodeGen_GPU_Host.h"
@@ -437,6 +439,7 @@ struct MangledNames {
     string extern_name;
     string argv_name;
     string metadata_name;
+    string batch_name;
 };
 
 MangledNames get_mangled_names(const std::string &name,
@@ -450,6 +453,7 @@ MangledNames get_mangled_names(const std::string &name,
     names.extern_name = names.simple_name;
     names.argv_name = names.simple_name + "_argv";
     names.metadata_name = names.simple_name + "_metadata";
+    names.batch_name = names.simple_name + "_batch";
 
     if (linkage != LoweredFunc::Internal &&
         ((mangling == NameMangling::Default &&
@@ -470,6 +474,22 @@ MangledNames get_mangled_names(const std::string &name,
         Type void_star_star(Handle(1, &inner_type));
         names.argv_name = cplusplus_function_mangled_name(names.argv_name, namespaces, type_of<int>(), { ExternFuncArgument(make_zero(void_star_star)) }, target);
         names.metadata_name = cplusplus_function_mangled_name(names.metadata_name, namespaces, type_of<const struct halide_filter_metadata_t *>(), {}, target);
+
+        // The batch wrapper takes an array of buffers for each buffer
+        // argument, then the batch size.
+        halide_handle_cplusplus_type buffer_array_type(halide_cplusplus_type_name(halide_cplusplus_type_name::Struct, "halide_buffer_t"), {}, {},
+                                                       { halide_handle_cplusplus_type::Pointer, halide_handle_cplusplus_type::Pointer } );
+        std::vector<ExternFuncArgument> batch_args;
+        for (const auto &arg : args) {
+            if (arg.kind == Argument::InputScalar) {
+                batch_args.push_back(ExternFuncArgument(make_zero(arg.type)));
+            } else if (arg.kind == Argument::InputBuffer ||
+                       arg.kind == Argument::OutputBuffer) {
+                batch_args.push_back(ExternFuncArgument(make_zero(Handle(1, &buffer_array_type))));
+            }
+        }
+        batch_args.push_back(ExternFuncArgument(make_zero(Int(32))));
+        names.batch_name = cplusplus_function_mangled_name(names.batch_name, namespaces, type_of<int>(), batch_args, target);
     }
     return names;
 }
@@ -540,6 +560,10 @@ std::unique_ptr<llvm::Module> CodeGen_LLVM::compile(const Module &input) {
             if (target.has_feature(Target::Matlab)) {
                 define_matlab_wrapper(module.get(), wrapper, metadata_getter);
             }
+
+            if (target.has_feature(Target::Batch)) {
+                add_batch_wrapper(names.batch_name, f.args);
+            }
         }
     }
 
@@ -688,9 +712,16 @@ void CodeGen_LLVM::compile_func(const LoweredFunc &f, const std::string &simple_
         }
     }
 
+    Stmt body = f.body;
+    if (max_carried_registers() > 0) {
+        debug(1) << "Carrying values across loop iterations...\n";
+        body = loop_carry(body, max_carried_registers(), native_vector_bits());
+        debug(2) << "Lowering after carrying values across loop iterations:\n" << body << "\n\n";
+    }
+
      // Generate the function body.
     debug(1) << "Generating llvm bitcode for function " << f.name << "...\n";
-    f.body.accept(this);
+    body.accept(this);
 
     // Clean up and return.
     end_func(f.args);
@@ -907,6 +938,86 @@ llvm::Function *CodeGen_LLVM::add_argv_wrapper(const std::string &name) {
     return wrapper;
 }
 
+// Make a wrapper that calls the function once for each item of a
+// batch, as the tasks of one parallel loop, so that many small
+// independent invocations share one trip through the thread pool. Each
+// buffer argument is replaced by an array of batch_size buffers, the
+// scalar arguments are shared by the whole batch, and the batch size
+// is the last argument.
+llvm::Function *CodeGen_LLVM::add_batch_wrapper(const std::string &name, const std::vector<LoweredArgument> &args) {
+    llvm::Type *buffer_ptr_t = buffer_t_type->getPointerTo();
+    std::vector<llvm::Type *> closure_types;
+    for (llvm::Function::arg_iterator i = function->arg_begin(); i != function->arg_end(); i++) {
+        if (i->getType() == buffer_ptr_t) {
+            closure_types.push_back(buffer_ptr_t->getPointerTo());
+        } else {
+            closure_types.push_back(i->getType());
+        }
+    }
+    internal_assert(closure_types.size() == args.size());
+
+    // The closure holds the wrapper's arguments, except for the batch size.
+    StructType *closure_t = StructType::create(*context, closure_types, name + "_closure");
+
+    // Make the task, which unpacks the closure and calls the function
+    // on the buffers for one item of the batch.
+    llvm::Type *voidPointerType = (llvm::Type *)(i8_t->getPointerTo());
+    llvm::Type *task_args_t[] = {voidPointerType, i32_t, voidPointerType};
+    FunctionType *task_t = FunctionType::get(i32_t, task_args_t, false);
+    llvm::Function *task = llvm::Function::Create(task_t, llvm::Function::InternalLinkage,
+                                                  name + "_task", module.get());
+    set_function_attributes_for_target(task, target);
+    builder->SetInsertPoint(BasicBlock::Create(*context, "entry", task));
+
+    llvm::Function::arg_iterator task_arg = task->arg_begin();
+    ++task_arg;
+    Value *idx = iterator_to_pointer(task_arg);
+    ++task_arg;
+    Value *closure = builder->CreatePointerCast(iterator_to_pointer(task_arg), closure_t->getPointerTo());
+
+    std::vector<Value *> call_args;
+    for (size_t i = 0; i < closure_types.size(); i++) {
+        Value *arg = builder->CreateLoad(builder->CreateConstInBoundsGEP2_32(closure_t, closure, 0, i));
+        if (closure_types[i] == buffer_ptr_t->getPointerTo()) {
+            arg = builder->CreateLoad(builder->CreateInBoundsGEP(arg, idx));
+        }
+        call_args.push_back(arg);
+    }
+    builder->CreateRet(builder->CreateCall(function, call_args));
+
+    // Make the wrapper, which packs its arguments into the closure and
+    // runs one task per item.
+    std::vector<llvm::Type *> wrapper_args_t = closure_types;
+    wrapper_args_t.push_back(i32_t);
+    FunctionType *wrapper_t = FunctionType::get(i32_t, wrapper_args_t, false);
+    llvm::Function *wrapper = llvm::Function::Create(wrapper_t, llvm::GlobalValue::ExternalLinkage, name, module.get());
+    set_function_attributes_for_target(wrapper, target);
+    builder->SetInsertPoint(BasicBlock::Create(*context, "entry", wrapper));
+
+    Value *closure_ptr = builder->CreateAlloca(closure_t);
+    Value *user_context = ConstantPointerNull::get(i8_t->getPointerTo());
+    llvm::Function::arg_iterator wrapper_arg = wrapper->arg_begin();
+    for (size_t i = 0; i < closure_types.size(); i++, wrapper_arg++) {
+        Value *arg = iterator_to_pointer(wrapper_arg);
+        builder->CreateStore(arg, builder->CreateConstInBoundsGEP2_32(closure_t, closure_ptr, 0, i));
+        if (args[i].name == "__user_context") {
+            user_context = builder->CreatePointerCast(arg, i8_t->getPointerTo());
+        }
+    }
+    Value *batch_size = iterator_to_pointer(wrapper_arg);
+
+    llvm::Function *do_par_for = module->getFunction("halide_do_par_for");
+    internal_assert(do_par_for) << "Could not find halide_do_par_for in initial module\n";
+    Value *par_for_args[] = {user_context, task, ConstantInt::get(i32_t, 0), batch_size,
+                             builder->CreatePointerCast(closure_ptr, i8_t->getPointerTo())};
+    builder->CreateRet(builder->CreateCall(do_par_for, par_for_args));
+
+    llvm::raw_os_ostream os(std::cerr);
+    llvm::verifyFunction(*task, &os);
+    llvm::verifyFunction(*wrapper, &os);
+    return wrapper;
+}
+
 llvm::Function *CodeGen_LLVM::embed_metadata_getter(const std::string &metadata_name,
         const std::string &function_name, const std::vector<LoweredArgument> &args) {
     Constant *zero = ConstantInt::get(i32_t, 0);
@@ -1718,6 +1829,9 @@ void CodeGen_LLVM::visit(const Load *op) {
             }
 
             value = shuffle_vectors(flipped, indices);
+        } else if (ramp && stride && stride->value > 2 &&
+                   stride->value <= 8 && stride->value < ramp->lanes) {
+            value = codegen_strided_vector_load(op, (int)stride->value);
         } else if (ramp) {
             // Gather without generating the indices as a vector
             Value *ptr = codegen_buffer_pointer(op->name, op->type.element_of(), ramp->base);
@@ -1969,6 +2083,77 @@ void CodeGen_LLVM::codegen_predicated_vector_store(const Store *op) {
     }
 }
 
+Value *CodeGen_LLVM::codegen_strided_vector_load(const Load *op, int stride) {
+    const Ramp *ramp = op->index.as<Ramp>();
+    internal_assert(ramp && is_one(op->predicate));
+    const int lanes = ramp->lanes;
+
+    // Cover the elements from the first lane to the last with dense
+    // loads of the same width. The last load is shifted back to end
+    // exactly at the last lane, so that we don't read past the end
+    // of the buffer.
+    const int span = (lanes - 1) * stride + 1;
+    const int num_loads = (span + lanes - 1) / lanes;
+    vector<int> offsets(num_loads);
+    for (int i = 0; i < num_loads; i++) {
+        offsets[i] = std::min(i * lanes, span - lanes);
+    }
+
+    // Each lane of the result comes from one of the loads.
+    vector<int> source(lanes);
+    for (int j = 0; j < lanes; j++) {
+        source[j] = std::min(j * stride / lanes, num_loads - 1);
+    }
+
+    // Do each load, and move the lanes it supplies into place.
+    vector<Value *> pieces(num_loads);
+    vector<int> first(num_loads), last(num_loads);
+    for (int i = 0; i < num_loads; i++) {
+        Expr base = simplify(ramp->base + offsets[i]);
+        Expr index = Ramp::make(base, make_one(base.type()), lanes);
+        Value *v = codegen(Load::make(op->type, op->name, index, op->image, op->param, op->predicate));
+        vector<int> indices(lanes, -1);
+        for (int j = 0; j < lanes; j++) {
+            if (source[j] == i) {
+                indices[j] = j * stride - offsets[i];
+            }
+        }
+        pieces[i] = shuffle_vectors(v, indices);
+        first[i] = last[i] = i;
+    }
+
+    // Merge adjacent pieces pairwise, so the shuffles form a tree of
+    // depth log2(num_loads).
+    while (pieces.size() > 1) {
+        vector<Value *> merged;
+        vector<int> merged_first, merged_last;
+        for (size_t i = 0; i < pieces.size(); i += 2) {
+            if (i + 1 == pieces.size()) {
+                merged.push_back(pieces[i]);
+                merged_first.push_back(first[i]);
+                merged_last.push_back(last[i]);
+                continue;
+            }
+            vector<int> indices(lanes, -1);
+            for (int j = 0; j < lanes; j++) {
+                if (source[j] >= first[i] && source[j] <= last[i]) {
+                    indices[j] = j;
+                } else if (source[j] >= first[i+1] && source[j] <= last[i+1]) {
+                    indices[j] = j + lanes;
+                }
+            }
+            merged.push_back(shuffle_vectors(pieces[i], pieces[i+1], indices));
+            merged_first.push_back(first[i]);
+            merged_last.push_back(last[i+1]);
+        }
+        pieces.swap(merged);
+        first.swap(merged_first);
+        last.swap(merged_last);
+    }
+
+    return pieces[0];
+}
+
 Value *CodeGen_LLVM::codegen_dense_vector_load(const Load *load, Value *vpred) {
     debug(4) << "Vectorize predicated dense vector load:\n\t" << Expr(load) << "\n";
 
@@ -2645,6 +2830,10 @@ void CodeGen_LLVM::visit(const Call *op) {
 
         value = builder->CreateCall(prefetch_fn, args);
 
+    } else if (op->is_intrinsic(Call::nontemporal_store_fence)) {
+        // Only targets with weakly-ordered streaming stores need an
+        // actual fence instruction. They override this.
+        value = ConstantInt::get(i32_t, 0);
     } else if (op->is_intrinsic(Call::signed_integer_overflow)) {
         user_error << "Signed integer overflow occurred during constant-folding. Signed"
             " integer overflow for int32 and int64 is undefined behavior in"
@@ -2654,6 +2843,20 @@ void CodeGen_LLVM::visit(const Call *op) {
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
         llvm::DataLayout d(module.get());
         value = ConstantInt::get(i32_t, (int)d.getTypeAllocSize(buffer_t_type));
+    } else if (is_fixed_point_intrinsic(op)) {
+        #if LLVM_VERSION >= 80
+        if (op->is_intrinsic(Call::saturating_add) ||
+            op->is_intrinsic(Call::saturating_sub)) {
+            // LLVM has target-independent saturating arithmetic.
+            std::ostringstream ss;
+            ss << "llvm." << (op->type.is_int() ? 's' : 'u')
+               << (op->is_intrinsic(Call::saturating_add) ? "add" : "sub")
+               << ".sat.v" << op->type.lanes() << "i" << op->type.bits();
+            value = call_intrin(op->type, op->type.lanes(), ss.str(), op->args);
+            return;
+        }
+        #endif
+        value = codegen(lower_intrinsic(op));
     } else if (op->call_type == Call::Intrinsic ||
                op->call_type == Call::PureIntrinsic) {
         internal_error << "Unknown intrinsic: " << op->name << "\n";
@@ -2936,6 +3139,29 @@ void CodeGen_LLVM::return_with_error_code(llvm::Value *error_code) {
     builder->CreateBr(get_destructor_block());
 }
 
+namespace {
+
+// Find the buffers named by the non-temporal store fences in a
+// producer.
+class FindNontemporalBuffers : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        if (op->is_intrinsic(Call::nontemporal_store_fence)) {
+            for (Expr arg : op->args) {
+                const StringImm *buf = arg.as<StringImm>();
+                internal_assert(buf);
+                buffers.insert(buf->value);
+            }
+        }
+        IRVisitor::visit(op);
+    }
+public:
+    std::set<string> buffers;
+};
+
+}
+
 void CodeGen_LLVM::visit(const ProducerConsumer *op) {
     string name;
     if (op->is_producer) {
@@ -2946,7 +3172,27 @@ void CodeGen_LLVM::visit(const ProducerConsumer *op) {
     BasicBlock *produce = BasicBlock::Create(*context, name, function);
     builder->CreateBr(produce);
     builder->SetInsertPoint(produce);
+
+    // Stores to the buffers fenced in this producer are
+    // non-temporal, but only within it, so that a later function in
+    // the same module that writes to a buffer with the same name
+    // doesn't inherit them.
+    std::vector<string> newly_nontemporal;
+    if (op->is_producer) {
+        FindNontemporalBuffers finder;
+        op->body.accept(&finder);
+        for (const string &buf : finder.buffers) {
+            if (nontemporal_buffers.insert(buf).second) {
+                newly_nontemporal.push_back(buf);
+            }
+        }
+    }
+
     codegen(op->body);
+
+    for (const string &buf : newly_nontemporal) {
+        nontemporal_buffers.erase(buf);
+    }
 }
 
 void CodeGen_LLVM::visit(const For *op) {
@@ -3064,10 +3310,17 @@ void CodeGen_LLVM::visit(const For *op) {
         // Return success
         return_with_error_code(ConstantInt::get(i32_t, 0));
 
-        // Move the builder back to the main function and call do_par_for
+        // Move the builder back to the main function and call
+        // do_par_for. Loops with a schedule other than the default
+        // pass it along as a hint to the thread pool.
         builder->restoreIP(call_site);
-        llvm::Function *do_par_for = module->getFunction("halide_do_par_for");
-        internal_assert(do_par_for) << "Could not find halide_do_par_for in initial module\n";
+        std::string do_par_for_name = "halide_do_par_for";
+        std::vector<Value *> args;
+        if (op->parallel_schedule != ParallelSchedule::Dynamic) {
+            do_par_for_name = "halide_do_par_for_with_schedule";
+        }
+        llvm::Function *do_par_for = module->getFunction(do_par_for_name);
+        internal_assert(do_par_for) << "Could not find " << do_par_for_name << " in initial module\n";
         #if LLVM_VERSION < 50
         do_par_for->setDoesNotAlias(5);
         #else
@@ -3075,8 +3328,18 @@ void CodeGen_LLVM::visit(const For *op) {
         #endif
         //do_par_for->setDoesNotCapture(5);
         ptr = builder->CreatePointerCast(ptr, i8_t->getPointerTo());
-        Value *args[] = {user_context, function, min, extent, ptr};
-        debug(4) << "Creating call to do_par_for\n";
+        args = {user_context, function, min, extent, ptr};
+        switch (op->parallel_schedule) {
+        case ParallelSchedule::Dynamic:
+            break;
+        case ParallelSchedule::Static:
+            args.push_back(ConstantInt::get(i32_t, halide_parallel_schedule_static));
+            break;
+        case ParallelSchedule::Guided:
+            args.push_back(ConstantInt::get(i32_t, halide_parallel_schedule_guided));
+            break;
+        }
+        debug(4) << "Creating call to " << do_par_for_name << "\n";
         Value *result = builder->CreateCall(do_par_for, args);
 
         debug(3) << "Leaving parallel for loop over " << op->name << "\n";
@@ -3154,6 +3417,13 @@ void CodeGen_LLVM::visit(const Store *op) {
             int store_lanes = value_type.lanes();
             int native_lanes = native_bits / value_type.bits();
 
+            // Streaming stores are marked with !nontemporal metadata.
+            MDNode *nontemporal_md = nullptr;
+            if (nontemporal_buffers.count(op->name)) {
+                Metadata *one = ConstantAsMetadata::get(ConstantInt::get(i32_t, 1));
+                nontemporal_md = MDNode::get(*context, {one});
+            }
+
             for (int i = 0; i < store_lanes; i += native_lanes) {
                 int slice_lanes = std::min(native_lanes, store_lanes - i);
                 Expr slice_base = simplify(ramp->base + i);
@@ -3164,6 +3434,9 @@ void CodeGen_LLVM::visit(const Store *op) {
                 Value *vec_ptr = builder->CreatePointerCast(elt_ptr, slice_val->getType()->getPointerTo());
                 StoreInst *store = builder->CreateAlignedStore(slice_val, vec_ptr, alignment);
                 add_tbaa_metadata(store, op->name, slice_index);
+                if (nontemporal_md) {
+                    store->setMetadata(LLVMContext::MD_nontemporal, nontemporal_md);
+                }
             }
         } else if (ramp) {
             Type ptr_type = value_type.element_of();
@@ -3220,11 +3493,28 @@ void CodeGen_LLVM::visit(const Provide *op) {
     internal_error << "Provide encountered during codegen\n";
 }
 
+namespace {
+// Is this statement nothing but assertions? combine_checks guards
+// the error paths of runtime checks with these.
+bool only_asserts(const Stmt &s) {
+    if (const Block *b = s.as<Block>()) {
+        return only_asserts(b->first) && only_asserts(b->rest);
+    }
+    return s.as<AssertStmt>() != nullptr;
+}
+}
+
 void CodeGen_LLVM::visit(const IfThenElse *op) {
     BasicBlock *true_bb = BasicBlock::Create(*context, "true_bb", function);
     BasicBlock *false_bb = BasicBlock::Create(*context, "false_bb", function);
     BasicBlock *after_bb = BasicBlock::Create(*context, "after_bb", function);
-    builder->CreateCondBr(codegen(op->condition), true_bb, false_bb);
+    Value *cond = codegen(op->condition);
+    if (!op->else_case.defined() && only_asserts(op->then_case)) {
+        // Only failing checks take this branch.
+        builder->CreateCondBr(builder->CreateNot(cond), false_bb, true_bb, very_likely_branch);
+    } else {
+        builder->CreateCondBr(cond, true_bb, false_bb);
+    }
 
     builder->SetInsertPoint(true_bb);
     codegen(op->then_case);
@@ -3273,6 +3563,10 @@ void CodeGen_LLVM::visit(const Shuffle *op) {
     }
 }
 
+void CodeGen_LLVM::visit(const VectorReduce *op) {
+    value = codegen(lower_vector_reduce(op));
+}
+
 Value *CodeGen_LLVM::create_alloca_at_entry(llvm::Type *t, int n, bool zero_initialize, const string &name) {
     IRBuilderBase::InsertPoint here = builder->saveIP();
     BasicBlock *entry = &builder->GetInsertBlock()->getParent()->getEntryBlock();
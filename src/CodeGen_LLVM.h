@@ -115,6 +115,11 @@ protected:
     /** What's the natural vector bit-width to use for loads, stores, etc. */
     virtual int native_vector_bits() const = 0;
 
+    /** How many native vector registers may be used to carry loaded
+     * values across loop iterations (see loop_carry). Zero disables
+     * loop carrying. */
+    virtual int max_carried_registers() const {return 0;}
+
     /** State needed by llvm for code generation, including the
      * current module, function, context, builder, and most recently
      * generated llvm value. */
@@ -355,6 +360,7 @@ protected:
     virtual void visit(const IfThenElse *);
     virtual void visit(const Evaluate *);
     virtual void visit(const Shuffle *);
+    virtual void visit(const VectorReduce *);
     virtual void visit(const Prefetch *);
     // @}
 
@@ -393,6 +399,11 @@ protected:
      * guarantee their alignment) */
     std::set<std::string> external_buffer;
 
+    /** Which buffers should be written with non-temporal stores
+     * within the producers currently being generated (see \ref
+     * Func::store_nontemporal) */
+    std::set<std::string> nontemporal_buffers;
+
     /** The user_context argument. May be a constant null if the
      * function is being compiled without a user context. */
     llvm::Value *get_user_context() const;
@@ -482,8 +493,16 @@ private:
 
     llvm::Function *add_argv_wrapper(const std::string &name);
 
+    /** Make a wrapper that runs the function on a batch of sets of
+     * buffers in one parallel loop. Used with Target::Batch. */
+    llvm::Function *add_batch_wrapper(const std::string &name, const std::vector<LoweredArgument> &args);
+
     llvm::Value *codegen_dense_vector_load(const Load *load, llvm::Value *vpred = nullptr);
 
+    /** Load a vector with a small constant stride using dense loads
+     * over its span, followed by a tree of two-vector shuffles. */
+    llvm::Value *codegen_strided_vector_load(const Load *load, int stride);
+
     virtual void codegen_predicated_vector_load(const Load *op);
     virtual void codegen_predicated_vector_store(const Store *op);
 };
@@ -1,12 +1,17 @@
 #include <iostream>
 
 #include "CodeGen_X86.h"
+#include "CodeGen_Internal.h"
 #include "ConciseCasts.h"
+#include "FindIntrinsics.h"
 #include "JITModule.h"
 #include "IROperator.h"
 #include "IRMatch.h"
 #include "Debug.h"
 #include "Util.h"
+#include "Bounds.h"
+#include "CSE.h"
+#include "Simplify.h"
 #include "Var.h"
 #include "Param.h"
 #include "LLVM_Headers.h"
@@ -32,6 +37,21 @@ CodeGen_X86::CodeGen_X86(Target t) : CodeGen_Posix(t) {
 
 namespace {
 
+bool get_mul_args(const Expr &e, Expr &a, Expr &b) {
+    if (const Mul *mul = e.as<Mul>()) {
+        a = mul->a;
+        b = mul->b;
+        return true;
+    }
+    const Call *call = e.as<Call>();
+    if (call && call->is_intrinsic(Call::widening_mul)) {
+        a = call->args[0];
+        b = call->args[1];
+        return true;
+    }
+    return false;
+}
+
 // i32(i16_a)*i32(i16_b) +/- i32(i16_c)*i32(i16_d) can be done by
 // interleaving a, c, and b, d, and then using pmaddwd. We
 // recognize it here, and implement it in the initial module.
@@ -39,18 +59,19 @@ bool should_use_pmaddwd(Expr a, Expr b, vector<Expr> &result) {
     Type t = a.type();
     internal_assert(b.type() == t);
 
-    const Mul *ma = a.as<Mul>();
-    const Mul *mb = b.as<Mul>();
-
-    if (!(ma && mb && t.is_int() && t.bits() == 32 && (t.lanes() >= 4))) {
+    // The products may already have been recognized as widening
+    // multiplies of i16s.
+    Expr ma_a, ma_b, mb_a, mb_b;
+    if (!(t.is_int() && t.bits() == 32 && (t.lanes() >= 4) &&
+          get_mul_args(a, ma_a, ma_b) && get_mul_args(b, mb_a, mb_b))) {
         return false;
     }
 
     Type narrow = t.with_bits(16);
-    vector<Expr> args = {lossless_cast(narrow, ma->a),
-                         lossless_cast(narrow, ma->b),
-                         lossless_cast(narrow, mb->a),
-                         lossless_cast(narrow, mb->b)};
+    vector<Expr> args = {lossless_cast(narrow, ma_a),
+                         lossless_cast(narrow, ma_b),
+                         lossless_cast(narrow, mb_a),
+                         lossless_cast(narrow, mb_b)};
     if (!args[0].defined() || !args[1].defined() ||
         !args[2].defined() || !args[3].defined()) {
         return false;
@@ -60,10 +81,68 @@ bool should_use_pmaddwd(Expr a, Expr b, vector<Expr> &result) {
     return true;
 }
 
+// The AVX-512 target features are not cumulative, so check for the
+// ones that imply the instruction set extension we want.
+bool has_feature_or_superset(const Target &t, Target::Feature f) {
+    if (f == Target::AVX512) {
+        return t.features_any_of({Target::AVX512, Target::AVX512_KNL,
+                                  Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+    } else if (f == Target::AVX512_Skylake) {
+        // AVX-512BW, AVX-512VL and AVX-512DQ
+        return t.features_any_of({Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+    }
+    return t.has_feature(f);
 }
 
+}
+
+
+bool CodeGen_X86::can_use_vpdpbusd(int lanes) const {
+    #if LLVM_VERSION >= 60
+    // The 256-bit form needs AVX-512VL.
+    return (target.has_feature(Target::AVX512_VNNI) &&
+            (lanes >= 16 ||
+             (lanes >= 8 && has_feature_or_superset(target, Target::AVX512_Skylake))));
+    #else
+    return false;
+    #endif
+}
+
+Value *CodeGen_X86::call_vpdpbusd(Type t, Value *acc, Value *a, Value *b) {
+    llvm::Type *result_type = llvm_type_of(t);
+    vector<Value *> args = {acc,
+                            builder->CreateBitCast(a, result_type),
+                            builder->CreateBitCast(b, result_type)};
+    #if LLVM_VERSION >= 70
+    if (t.lanes() >= 16) {
+        return call_intrin(result_type, 16, "llvm.x86.avx512.vpdpbusd.512", args);
+    } else {
+        return call_intrin(result_type, 8, "llvm.x86.avx512.vpdpbusd.256", args);
+    }
+    #else
+    // Before LLVM 7 the intrinsics take a write mask.
+    if (t.lanes() >= 16) {
+        args.push_back(ConstantInt::get(i16_t, -1));
+        return call_intrin(result_type, 16, "llvm.x86.avx512.mask.vpdpbusd.512", args);
+    } else {
+        args.push_back(ConstantInt::get(i8_t, -1));
+        return call_intrin(result_type, 8, "llvm.x86.avx512.mask.vpdpbusd.256", args);
+    }
+    #endif
+}
 
 void CodeGen_X86::visit(const Add *op) {
+    // Four-way int8 dot products accumulated into int32 map onto
+    // vpdpbusd, which multiplies unsigned bytes by signed bytes.
+    if (can_use_vpdpbusd(op->type.lanes())) {
+        Expr acc, a, b;
+        if (match_int8_dot_product(op, UInt(8), Int(8), acc, a, b) ||
+            match_int8_dot_product(op, Int(8), UInt(8), acc, b, a)) {
+            value = call_vpdpbusd(op->type, codegen(acc), codegen(a), codegen(b));
+            return;
+        }
+    }
+
     vector<Expr> matches;
     if (should_use_pmaddwd(op->a, op->b, matches)) {
         codegen(Call::make(op->type, "pmaddwd", matches, Call::Extern));
@@ -207,87 +286,6 @@ void CodeGen_X86::visit(const Cast *op) {
         return;
     }
 
-    vector<Expr> matches;
-
-    struct Pattern {
-        Target::Feature feature;
-        bool wide_op;
-        Type type;
-        int min_lanes;
-        string intrin;
-        Expr pattern;
-    };
-
-    static Pattern patterns[] = {
-        {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.padds.b",
-         i8_sat(wild_i16x_ + wild_i16x_)},
-        {Target::FeatureEnd, true, Int(8, 16), 0, "llvm.x86.sse2.psubs.b",
-         i8_sat(wild_i16x_ - wild_i16x_)},
-        {Target::FeatureEnd, true, UInt(8, 16), 0, "llvm.x86.sse2.paddus.b",
-         u8_sat(wild_u16x_ + wild_u16x_)},
-        {Target::FeatureEnd, true, UInt(8, 16), 0, "llvm.x86.sse2.psubus.b",
-         u8(max(wild_i16x_ - wild_i16x_, 0))},
-        {Target::FeatureEnd, true, Int(16, 8), 0, "llvm.x86.sse2.padds.w",
-         i16_sat(wild_i32x_ + wild_i32x_)},
-        {Target::FeatureEnd, true, Int(16, 8), 0, "llvm.x86.sse2.psubs.w",
-         i16_sat(wild_i32x_ - wild_i32x_)},
-        {Target::FeatureEnd, true, UInt(16, 8), 0, "llvm.x86.sse2.paddus.w",
-         u16_sat(wild_u32x_ + wild_u32x_)},
-        {Target::FeatureEnd, true, UInt(16, 8), 0, "llvm.x86.sse2.psubus.w",
-         u16(max(wild_i32x_ - wild_i32x_, 0))},
-
-        // Only use the avx2 version if we have > 8 lanes
-        {Target::AVX2, true, Int(16, 16), 9, "llvm.x86.avx2.pmulh.w",
-         i16((wild_i32x_ * wild_i32x_) / 65536)},
-        {Target::AVX2, true, UInt(16, 16), 9, "llvm.x86.avx2.pmulhu.w",
-         u16((wild_u32x_ * wild_u32x_) / 65536)},
-
-        {Target::FeatureEnd, true, Int(16, 8), 0, "llvm.x86.sse2.pmulh.w",
-         i16((wild_i32x_ * wild_i32x_) / 65536)},
-        {Target::FeatureEnd, true, UInt(16, 8), 0, "llvm.x86.sse2.pmulhu.w",
-         u16((wild_u32x_ * wild_u32x_) / 65536)},
-        {Target::FeatureEnd, true, UInt(8, 16), 0, "llvm.x86.sse2.pavg.b",
-         u8(((wild_u16x_ + wild_u16x_) + 1) / 2)},
-        {Target::FeatureEnd, true, UInt(16, 8), 0, "llvm.x86.sse2.pavg.w",
-         u16(((wild_u32x_ + wild_u32x_) + 1) / 2)},
-        {Target::FeatureEnd, false, Int(16, 8), 0, "packssdwx8",
-         i16_sat(wild_i32x_)},
-        {Target::FeatureEnd, false, Int(8, 16), 0, "packsswbx16",
-         i8_sat(wild_i16x_)},
-        {Target::FeatureEnd, false, UInt(8, 16), 0, "packuswbx16",
-         u8_sat(wild_i16x_)},
-        {Target::SSE41, false, UInt(16, 8), 0, "packusdwx8",
-         u16_sat(wild_i32x_)}
-    };
-
-    for (size_t i = 0; i < sizeof(patterns)/sizeof(patterns[0]); i++) {
-        const Pattern &pattern = patterns[i];
-
-        if (!target.has_feature(pattern.feature)) {
-            continue;
-        }
-
-        if (op->type.lanes() < pattern.min_lanes) {
-            continue;
-        }
-
-        if (expr_match(pattern.pattern, op, matches)) {
-            bool match = true;
-            if (pattern.wide_op) {
-                // Try to narrow the matches to the target type.
-                for (size_t i = 0; i < matches.size(); i++) {
-                    matches[i] = lossless_cast(op->type, matches[i]);
-                    if (!matches[i].defined()) match = false;
-                }
-            }
-            if (match) {
-                value = call_intrin(op->type, pattern.type.lanes(), pattern.intrin, matches);
-                return;
-            }
-        }
-    }
-
-
     #if LLVM_VERSION >= 38
     // Workaround for https://llvm.org/bugs/show_bug.cgi?id=24512
     // LLVM uses a numerically unstable method for vector
@@ -320,12 +318,7 @@ Expr CodeGen_X86::mulhi_shr(Expr a, Expr b, int shr) {
     Type ty = a.type();
     if (ty.is_vector() && ty.bits() == 16) {
         // We can use pmulhu for this op.
-        Expr p;
-        if (ty.is_uint()) {
-            p = u16(u32(a) * u32(b) / 65536);
-        } else {
-            p = i16(i32(a) * i32(b) / 65536);
-        }
+        Expr p = mul_hi(a, b);
         if (shr) {
             p = p >> shr;
         }
@@ -383,6 +376,102 @@ void CodeGen_X86::visit(const Max *op) {
 }
 
 void CodeGen_X86::visit(const Call *op) {
+    if (op->type.is_vector() && is_fixed_point_intrinsic(op)) {
+        struct Pattern {
+            Target::Feature feature;
+            Type type;
+            int min_lanes;
+            string intrin;
+            Expr pattern;
+        };
+
+        static Pattern patterns[] = {
+            // Only use the avx512 versions if we have more lanes than
+            // fit in an avx2 vector. These are implemented in
+            // x86_avx512.ll and x86_avx512_skylake.ll.
+            {Target::AVX512_Skylake, Int(8, 64), 33, "paddsbx64",
+             saturating_add(wild_i8x_, wild_i8x_)},
+            {Target::AVX512_Skylake, Int(8, 64), 33, "psubsbx64",
+             saturating_sub(wild_i8x_, wild_i8x_)},
+            {Target::AVX512_Skylake, UInt(8, 64), 33, "paddusbx64",
+             saturating_add(wild_u8x_, wild_u8x_)},
+            {Target::AVX512_Skylake, UInt(8, 64), 33, "psubusbx64",
+             saturating_sub(wild_u8x_, wild_u8x_)},
+            {Target::AVX512_Skylake, Int(16, 32), 17, "paddswx32",
+             saturating_add(wild_i16x_, wild_i16x_)},
+            {Target::AVX512_Skylake, Int(16, 32), 17, "psubswx32",
+             saturating_sub(wild_i16x_, wild_i16x_)},
+            {Target::AVX512_Skylake, UInt(16, 32), 17, "padduswx32",
+             saturating_add(wild_u16x_, wild_u16x_)},
+            {Target::AVX512_Skylake, UInt(16, 32), 17, "psubuswx32",
+             saturating_sub(wild_u16x_, wild_u16x_)},
+            {Target::AVX512_Skylake, Int(16, 32), 17, "pmulhwx32",
+             mul_hi(wild_i16x_, wild_i16x_)},
+            {Target::AVX512_Skylake, UInt(16, 32), 17, "pmulhuwx32",
+             mul_hi(wild_u16x_, wild_u16x_)},
+            {Target::AVX512_Skylake, UInt(8, 64), 33, "pavgbx64",
+             rounding_halving_add(wild_u8x_, wild_u8x_)},
+            {Target::AVX512_Skylake, UInt(16, 32), 17, "pavgwx32",
+             rounding_halving_add(wild_u16x_, wild_u16x_)},
+            {Target::AVX512_Skylake, Int(8, 32), 17, "packsswbx32",
+             saturating_narrow(Int(8), wild_i16x_)},
+            {Target::AVX512, Int(16, 16), 9, "packssdwx16",
+             saturating_narrow(Int(16), wild_i32x_)},
+
+            {Target::FeatureEnd, Int(8, 16), 0, "llvm.x86.sse2.padds.b",
+             saturating_add(wild_i8x_, wild_i8x_)},
+            {Target::FeatureEnd, Int(8, 16), 0, "llvm.x86.sse2.psubs.b",
+             saturating_sub(wild_i8x_, wild_i8x_)},
+            {Target::FeatureEnd, UInt(8, 16), 0, "llvm.x86.sse2.paddus.b",
+             saturating_add(wild_u8x_, wild_u8x_)},
+            {Target::FeatureEnd, UInt(8, 16), 0, "llvm.x86.sse2.psubus.b",
+             saturating_sub(wild_u8x_, wild_u8x_)},
+            {Target::FeatureEnd, Int(16, 8), 0, "llvm.x86.sse2.padds.w",
+             saturating_add(wild_i16x_, wild_i16x_)},
+            {Target::FeatureEnd, Int(16, 8), 0, "llvm.x86.sse2.psubs.w",
+             saturating_sub(wild_i16x_, wild_i16x_)},
+            {Target::FeatureEnd, UInt(16, 8), 0, "llvm.x86.sse2.paddus.w",
+             saturating_add(wild_u16x_, wild_u16x_)},
+            {Target::FeatureEnd, UInt(16, 8), 0, "llvm.x86.sse2.psubus.w",
+             saturating_sub(wild_u16x_, wild_u16x_)},
+
+            // Only use the avx2 version if we have > 8 lanes
+            {Target::AVX2, Int(16, 16), 9, "llvm.x86.avx2.pmulh.w",
+             mul_hi(wild_i16x_, wild_i16x_)},
+            {Target::AVX2, UInt(16, 16), 9, "llvm.x86.avx2.pmulhu.w",
+             mul_hi(wild_u16x_, wild_u16x_)},
+
+            {Target::FeatureEnd, Int(16, 8), 0, "llvm.x86.sse2.pmulh.w",
+             mul_hi(wild_i16x_, wild_i16x_)},
+            {Target::FeatureEnd, UInt(16, 8), 0, "llvm.x86.sse2.pmulhu.w",
+             mul_hi(wild_u16x_, wild_u16x_)},
+            {Target::FeatureEnd, UInt(8, 16), 0, "llvm.x86.sse2.pavg.b",
+             rounding_halving_add(wild_u8x_, wild_u8x_)},
+            {Target::FeatureEnd, UInt(16, 8), 0, "llvm.x86.sse2.pavg.w",
+             rounding_halving_add(wild_u16x_, wild_u16x_)},
+            {Target::FeatureEnd, Int(16, 8), 0, "packssdwx8",
+             saturating_narrow(Int(16), wild_i32x_)},
+            {Target::FeatureEnd, Int(8, 16), 0, "packsswbx16",
+             saturating_narrow(Int(8), wild_i16x_)},
+            {Target::FeatureEnd, UInt(8, 16), 0, "packuswbx16",
+             saturating_narrow(UInt(8), wild_i16x_)},
+            {Target::SSE41, UInt(16, 8), 0, "packusdwx8",
+             saturating_narrow(UInt(16), wild_i32x_)}
+        };
+
+        vector<Expr> matches;
+        for (const Pattern &pattern : patterns) {
+            if (!has_feature_or_superset(target, pattern.feature) ||
+                op->type.lanes() < pattern.min_lanes) {
+                continue;
+            }
+            if (expr_match(pattern.pattern, op, matches)) {
+                value = call_intrin(op->type, pattern.type.lanes(), pattern.intrin, matches);
+                return;
+            }
+        }
+    }
+
     constexpr bool need_workaround = LLVM_VERSION < 40;
     if (need_workaround && target.has_feature(Target::AVX2) &&
         op->is_intrinsic(Call::shift_left) &&
@@ -404,11 +493,339 @@ void CodeGen_X86::visit(const Call *op) {
                           cast(wider, op->args[0]) <<
                           cast(wider, op->args[1]));
         codegen(equiv);
+    } else if (op->is_intrinsic(Call::nontemporal_store_fence)) {
+        // movnt stores are weakly ordered, so make them visible to
+        // other threads before anything that follows.
+        llvm::Function *fn = module->getFunction("llvm.x86.sse.sfence");
+        if (!fn) {
+            FunctionType *fn_type = FunctionType::get(void_t, false);
+            fn = llvm::Function::Create(fn_type, llvm::Function::ExternalLinkage,
+                                        "llvm.x86.sse.sfence", module.get());
+        }
+        builder->CreateCall(fn);
+        value = ConstantInt::get(i32_t, 0);
     } else {
         CodeGen_Posix::visit(op);
     }
 }
 
+void CodeGen_X86::visit(const VectorReduce *op) {
+    const Type t = op->type;
+    const int in_lanes = op->value.type().lanes();
+    const int factor = in_lanes / t.lanes();
+
+    if (op->op != VectorReduce::Add || !(t.is_int() || t.is_uint())) {
+        CodeGen_Posix::visit(op);
+        return;
+    }
+
+    // Both instructions below do part of the reduction. Sum the
+    // partial results to finish it.
+    auto finish = [&](Value *partial, Type partial_t) {
+        string name = unique_name('t');
+        sym_push(name, partial);
+        Expr rest = cast(t.with_lanes(partial_t.lanes()), Variable::make(partial_t, name));
+        if (partial_t.lanes() > t.lanes()) {
+            rest = VectorReduce::make(VectorReduce::Add, rest, t.lanes());
+        }
+        value = codegen(rest);
+        sym_pop(name);
+    };
+
+    // Dot products of unsigned and signed bytes, e.g. over an RDom
+    // vectorized by a multiple of four. vpdpbusd sums groups of four
+    // adjacent products.
+    if (can_use_vpdpbusd(in_lanes / 4)) {
+        Expr a, b;
+        if (match_int8_dot_product(op, UInt(8), Int(8), a, b) ||
+            match_int8_dot_product(op, Int(8), UInt(8), b, a)) {
+            Type dot_t = Int(32, in_lanes / 4);
+            Value *zero = codegen(make_zero(dot_t));
+            finish(call_vpdpbusd(dot_t, zero, codegen(a), codegen(b)), dot_t);
+            return;
+        }
+    }
+
+    // Sums of unsigned bytes, possibly widened. psadbw computes the
+    // exact sum of each group of eight bytes (as the sum of absolute
+    // differences with zero) in a 64-bit lane, and a wrapping sum is
+    // the low bits of the exact one.
+    Expr bytes = lossless_cast(UInt(8, in_lanes), op->value);
+    if (bytes.defined() && factor % 8 == 0 && in_lanes % 16 == 0) {
+        Type sad_t = UInt(64, in_lanes / 8);
+        vector<Expr> args = {bytes, make_zero(bytes.type())};
+        if (target.has_feature(Target::AVX2) && in_lanes % 32 == 0) {
+            finish(call_intrin(sad_t, 4, "llvm.x86.avx2.psad.bw", args), sad_t);
+        } else {
+            finish(call_intrin(sad_t, 2, "llvm.x86.sse2.psad.bw", args), sad_t);
+        }
+        return;
+    }
+
+    // Sums of products of 16-bit integers. pmaddwd multiplies and adds
+    // adjacent pairs of lanes.
+    Expr a, b;
+    if (t.is_int() && t.bits() == 32 && factor % 2 == 0 && in_lanes >= 8 &&
+        get_mul_args(op->value, a, b)) {
+        a = lossless_cast(Int(16, in_lanes), a);
+        b = lossless_cast(Int(16, in_lanes), b);
+        if (a.defined() && b.defined()) {
+            Type pairs_t = t.with_lanes(in_lanes / 2);
+            if (target.has_feature(Target::AVX2) && in_lanes % 16 == 0) {
+                finish(call_intrin(pairs_t, 8, "llvm.x86.avx2.pmadd.wd", {a, b}), pairs_t);
+            } else {
+                finish(call_intrin(pairs_t, 4, "llvm.x86.sse2.pmadd.wd", {a, b}), pairs_t);
+            }
+            return;
+        }
+    }
+
+    CodeGen_Posix::visit(op);
+}
+
+void CodeGen_X86::visit(const Let *op) {
+    bool track = op->value.type().is_vector();
+    if (track) {
+        let_bounds.push(op->name, bounds_of_expr_in_scope(op->value, let_bounds));
+    }
+    CodeGen_Posix::visit(op);
+    if (track) {
+        let_bounds.pop(op->name);
+    }
+}
+
+void CodeGen_X86::visit(const LetStmt *op) {
+    bool track = op->value.type().is_vector();
+    if (track) {
+        let_bounds.push(op->name, bounds_of_expr_in_scope(op->value, let_bounds));
+    }
+    CodeGen_Posix::visit(op);
+    if (track) {
+        let_bounds.pop(op->name);
+    }
+}
+
+bool CodeGen_X86::known_in_allocation(const Load *op, int64_t min, int64_t max) {
+    if (min > max) {
+        return false;
+    }
+    if (op->image.defined()) {
+        // An embedded buffer. Work out the range of flattened indices
+        // relative to its host pointer.
+        int64_t lo = 0, hi = 0;
+        for (int i = 0; i < op->image.dimensions(); i++) {
+            int64_t span = (int64_t)(op->image.dim(i).extent() - 1) * op->image.dim(i).stride();
+            if (span > 0) {
+                hi += span;
+            } else {
+                lo += span;
+            }
+        }
+        return lo <= min && max <= hi;
+    }
+    if (allocations.contains(op->name)) {
+        // An internal allocation, indexed from zero.
+        const Allocation &alloc = allocations.get(op->name);
+        return (alloc.constant_bytes > 0 && min >= 0 &&
+                (max + 1) * op->type.bytes() <= alloc.constant_bytes);
+    }
+    // The size of other buffers isn't known until runtime.
+    return false;
+}
+
+Value *CodeGen_X86::codegen_table_lookup(const Load *op) {
+    const Type t = op->type;
+    const int lanes = t.lanes();
+
+    // The index must be known to lie in a small constant range that is
+    // inside the buffer, because the whole range is loaded. The bounds
+    // may be looser than the indices actually used, so this is only
+    // safe when the size of the buffer is known.
+    Interval bounds = bounds_of_expr_in_scope(op->index, let_bounds);
+    if (!bounds.is_bounded()) {
+        return nullptr;
+    }
+    const int64_t *min_index = as_const_int(simplify(bounds.min));
+    const int64_t *max_index = as_const_int(simplify(bounds.max));
+    if (!min_index || !max_index || *max_index - *min_index < 1 ||
+        !known_in_allocation(op, *min_index, *max_index)) {
+        return nullptr;
+    }
+    const int table_size = (int)(*max_index - *min_index + 1);
+
+    // Pick the widest in-register permute that holds the whole table.
+    string intrin;
+    int intrin_lanes = 0;
+    int copies = 1;
+    if (t.bits() == 8 && table_size <= 16 && target.has_feature(Target::SSE41)) {
+        // pshufb permutes bytes within each 128-bit lane.
+        if (target.has_feature(Target::AVX2) && lanes >= 32) {
+            intrin = "llvm.x86.avx2.pshuf.b";
+            intrin_lanes = 32;
+            copies = 2;
+        } else {
+            intrin = "llvm.x86.ssse3.pshuf.b.128";
+            intrin_lanes = 16;
+        }
+    } else if (t.bits() == 32 && table_size <= 8 && target.has_feature(Target::AVX2)) {
+        intrin = t.is_float() ? "llvm.x86.avx2.permps" : "llvm.x86.avx2.permd";
+        intrin_lanes = 8;
+    } else {
+        return nullptr;
+    }
+    const int table_lanes = intrin_lanes / copies;
+    internal_assert(table_size <= table_lanes);
+
+    // Load every entry that may be looked up. These were checked to
+    // be inside the buffer above.
+    Expr base = make_const(Int(32), *min_index);
+    Expr table = Load::make(t.with_lanes(table_size), op->name, Ramp::make(base, 1, table_size),
+                            op->image, op->param, const_true(table_size));
+    Value *table_value = slice_vector(codegen(table), 0, table_lanes);
+    if (copies > 1) {
+        table_value = concat_vectors(vector<Value *>(copies, table_value));
+    }
+
+    Type index_t = Int(t.bits(), lanes);
+    Value *index = codegen(simplify(cast(index_t, op->index - base)));
+
+    llvm::Type *slice_t = VectorType::get(llvm_type_of(t.element_of()), intrin_lanes);
+    llvm::Type *index_slice_t = VectorType::get(llvm_type_of(index_t.element_of()), intrin_lanes);
+    FunctionType *fn_type = FunctionType::get(slice_t, {slice_t, index_slice_t}, false);
+    llvm::Function *fn = dyn_cast_or_null<llvm::Function>(module->getOrInsertFunction(intrin, fn_type));
+    internal_assert(fn);
+
+    vector<Value *> results;
+    for (int i = 0; i < lanes; i += intrin_lanes) {
+        Value *slice_index = slice_vector(index, i, intrin_lanes);
+        results.push_back(builder->CreateCall(fn, {table_value, slice_index}));
+    }
+    return slice_vector(concat_vectors(results), 0, lanes);
+}
+
+Value *CodeGen_X86::codegen_gather(const Load *op) {
+    const Type t = op->type;
+    const int lanes = t.lanes();
+
+    // Gathers only pay for themselves when they replace at least a
+    // full 256-bit vector of 32 or 64-bit scalar loads.
+    if ((t.bits() != 32 && t.bits() != 64) || t.is_handle() ||
+        t.bits() * lanes < 256 || !target.has_feature(Target::AVX2)) {
+        return nullptr;
+    }
+
+    Value *base = codegen_buffer_pointer(op->name, t.element_of(), make_zero(Int(32)));
+    Value *index = codegen(op->index);
+    Value *mask = is_one(op->predicate) ? nullptr : codegen(op->predicate);
+
+    if (has_feature_or_superset(target, Target::AVX512)) {
+        // llvm selects AVX-512 gathers for masked.gather directly.
+        llvm::DataLayout d(module.get());
+        if (d.getPointerSize() == 8) {
+            index = builder->CreateIntCast(index, VectorType::get(i64_t, lanes), true);
+        }
+        Value *ptrs = builder->CreateInBoundsGEP(base, index);
+        Instruction *gather = builder->CreateMaskedGather(ptrs, t.bytes(), mask);
+        add_tbaa_metadata(gather, op->name, op->index);
+        return gather;
+    }
+
+    // On AVX2, llvm would scalarize masked.gather on most cpus, so
+    // call the vpgather intrinsics directly. They take 32-bit
+    // indices, a mask with the sign bit of each active lane set, and
+    // a scale for the indices.
+    string intrin = "llvm.x86.avx2.gather.d.";
+    intrin += t.is_float() ? (t.bits() == 32 ? "ps.256" : "pd.256") : (t.bits() == 32 ? "d.256" : "q.256");
+    const int intrin_lanes = 256 / t.bits();
+    llvm::Type *slice_t = VectorType::get(llvm_type_of(t.element_of()), intrin_lanes);
+    llvm::Type *mask_int_t = VectorType::get(llvm_type_of(Int(t.bits())), intrin_lanes);
+    llvm::Type *index_slice_t = VectorType::get(i32_t, intrin_lanes);
+    base = builder->CreatePointerCast(base, i8_t->getPointerTo());
+
+    FunctionType *fn_type = FunctionType::get(slice_t, {slice_t, base->getType(), index_slice_t, slice_t, i8_t}, false);
+    llvm::Function *fn = dyn_cast_or_null<llvm::Function>(module->getOrInsertFunction(intrin, fn_type));
+    internal_assert(fn);
+
+    vector<Value *> results;
+    for (int i = 0; i < lanes; i += intrin_lanes) {
+        // Lanes past the end of the vector must be disabled, because
+        // their indices are undefined.
+        vector<Constant *> active(intrin_lanes);
+        for (int j = 0; j < intrin_lanes; j++) {
+            active[j] = ConstantInt::get(llvm_type_of(Int(t.bits())), i + j < lanes ? -1 : 0, true);
+        }
+        Value *slice_mask = ConstantVector::get(active);
+        if (mask) {
+            Value *pred = builder->CreateSExt(slice_vector(mask, i, intrin_lanes), mask_int_t);
+            slice_mask = builder->CreateAnd(slice_mask, pred);
+        }
+        slice_mask = builder->CreateBitCast(slice_mask, slice_t);
+
+        Value *slice_index = slice_vector(index, i, intrin_lanes);
+        CallInst *gather = builder->CreateCall(fn, {Constant::getNullValue(slice_t), base, slice_index,
+                                                    slice_mask, ConstantInt::get(i8_t, t.bytes())});
+        gather->setOnlyReadsMemory();
+        gather->setDoesNotThrow();
+        results.push_back(gather);
+    }
+    return slice_vector(concat_vectors(results), 0, lanes);
+}
+
+void CodeGen_X86::visit(const Load *op) {
+    if (op->type.is_vector() && !op->index.as<Ramp>()) {
+        // Data-dependent indices. A lookup in a table small enough to
+        // hold in a register is a permute. Otherwise try a gather.
+        Value *v = nullptr;
+        if (is_one(op->predicate)) {
+            v = codegen_table_lookup(op);
+        }
+        if (!v) {
+            v = codegen_gather(op);
+        }
+        if (v) {
+            value = v;
+            return;
+        }
+    }
+    CodeGen_Posix::visit(op);
+}
+
+bool CodeGen_X86::codegen_scatter(const Store *op) {
+    const Type t = op->value.type();
+    const int lanes = t.lanes();
+
+    // Only AVX-512 has scatters.
+    if ((t.bits() != 32 && t.bits() != 64) || t.is_handle() ||
+        t.bits() * lanes < 256 || !has_feature_or_superset(target, Target::AVX512)) {
+        return false;
+    }
+
+    // Lanes are written in order, so when several lanes write the
+    // same address, the last one wins, as it would if they were
+    // stored one at a time.
+    Value *val = codegen(op->value);
+    Value *base = codegen_buffer_pointer(op->name, t.element_of(), make_zero(Int(32)));
+    Value *index = codegen(op->index);
+    Value *mask = is_one(op->predicate) ? nullptr : codegen(op->predicate);
+    llvm::DataLayout d(module.get());
+    if (d.getPointerSize() == 8) {
+        index = builder->CreateIntCast(index, VectorType::get(i64_t, lanes), true);
+    }
+    Value *ptrs = builder->CreateInBoundsGEP(base, index);
+    Instruction *scatter = builder->CreateMaskedScatter(val, ptrs, t.bytes(), mask);
+    add_tbaa_metadata(scatter, op->name, op->index);
+    return true;
+}
+
+void CodeGen_X86::visit(const Store *op) {
+    if (op->value.type().is_vector() &&
+        !op->index.as<Ramp>() && !op->index.as<Let>() &&
+        codegen_scatter(op)) {
+        return;
+    }
+    CodeGen_Posix::visit(op);
+}
+
 string CodeGen_X86::mcpu() const {
     #if LLVM_VERSION >= 40
     if (target.has_feature(Target::AVX512_Cannonlake)) return "cannonlake";
@@ -455,6 +872,11 @@ string CodeGen_X86::mattrs() const {
         if (target.has_feature(Target::AVX512_Cannonlake)) {
             features += ",+avx512ifma,+avx512vbmi";
         }
+        #if LLVM_VERSION >= 60
+        if (target.has_feature(Target::AVX512_VNNI)) {
+            features += ",+avx512vnni";
+        }
+        #endif
     }
     #endif
     return features;
@@ -478,4 +900,14 @@ int CodeGen_X86::native_vector_bits() const {
     }
 }
 
+int CodeGen_X86::max_carried_registers() const {
+    // Use at most half of the vector registers for carrying
+    // values. 32-bit code only has 8 of them, even with AVX-512. In
+    // 64-bit code there are 32 with AVX-512, and 16 otherwise.
+    if (target.bits == 32) {
+        return 4;
+    }
+    return native_vector_bits() == 512 ? 16 : 8;
+}
+
 }}
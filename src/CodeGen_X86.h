@@ -6,6 +6,8 @@
  */
 
 #include "CodeGen_Posix.h"
+#include "Interval.h"
+#include "Scope.h"
 #include "Target.h"
 
 namespace llvm {
@@ -28,9 +30,19 @@ protected:
     std::string mattrs() const;
     bool use_soft_float_abi() const;
     int native_vector_bits() const;
+    int max_carried_registers() const;
 
     Expr mulhi_shr(Expr a, Expr b, int shr);
 
+    /** Whether vpdpbusd can produce a vector of int32s with the given
+     * number of lanes, and a call to it that adds the four-way dot
+     * products of the unsigned bytes of a and the signed bytes of b to
+     * acc. */
+    // @{
+    bool can_use_vpdpbusd(int lanes) const;
+    llvm::Value *call_vpdpbusd(Type t, llvm::Value *acc, llvm::Value *a, llvm::Value *b);
+    // @}
+
     using CodeGen_Posix::visit;
 
     /** Nodes for which we want to emit specific sse/avx intrinsics */
@@ -48,7 +60,29 @@ protected:
     void visit(const EQ *);
     void visit(const NE *);
     void visit(const Select *);
+    void visit(const VectorReduce *);
+    void visit(const Load *);
+    void visit(const Store *);
+    void visit(const Let *);
+    void visit(const LetStmt *);
+    // @}
+
+    /** Vector loads and stores with data-dependent indices. These
+     * return nullptr (or false) if the load or store is better done
+     * one lane at a time. */
+    // @{
+    llvm::Value *codegen_table_lookup(const Load *);
+    llvm::Value *codegen_gather(const Load *);
+    bool codegen_scatter(const Store *);
     // @}
+
+    /** Whether the flattened indices [min, max] of the buffer loaded
+     * by op are known at compile time to be inside it. */
+    bool known_in_allocation(const Load *op, int64_t min, int64_t max);
+
+    /** Bounds of the vector lets in scope, used to find loads from
+     * small tables. */
+    Scope<Interval> let_bounds;
 };
 
 }}
@@ -326,6 +326,24 @@ private:
             expr = Shuffle::make({op}, indices);
         }
     }
+
+    void visit(const VectorReduce *op) {
+        if (op->type.is_scalar()) {
+            expr = op;
+        } else {
+            // Gather the groups of lanes that reduce to the lanes we
+            // want, then reduce those.
+            int factor = op->value.type().lanes() / op->type.lanes();
+            std::vector<int> indices;
+            for (int i = 0; i < new_lanes; i++) {
+                int group = starting_lane + lane_stride * i;
+                for (int j = 0; j < factor; j++) {
+                    indices.push_back(group * factor + j);
+                }
+            }
+            expr = VectorReduce::make(op->op, Shuffle::make({op->value}, indices), new_lanes);
+        }
+    }
 };
 
 Expr extract_odd_lanes(Expr e, const Scope<int> &lets) {
@@ -370,6 +388,16 @@ Expr extract_mod3_lanes(Expr e, int lane, const Scope<int> &lets) {
     return simplify(e);
 }
 
+Expr extract_strided_lanes(Expr e, int lane, int stride, const Scope<int> &lets) {
+    internal_assert(e.type().lanes() % stride == 0);
+    Deinterleaver d(lets);
+    d.starting_lane = lane;
+    d.lane_stride = stride;
+    d.new_lanes = e.type().lanes()/stride;
+    e = d.mutate(e);
+    return simplify(e);
+}
+
 Expr extract_lane(Expr e, int lane) {
     Scope<int> lets;
     Deinterleaver d(lets);
@@ -390,30 +418,52 @@ class Interleaver : public IRMutator {
     bool should_deinterleave;
     int num_lanes;
 
-    Expr deinterleave_expr(Expr e) {
-        if (e.type().lanes() <= num_lanes) {
-            // Just scalarize
+    // Split e into num_lanes vectors of every num_lanes'th lane and
+    // interleave them again. Powers of two are split by repeatedly
+    // taking the even and odd lanes, so that the .even_lanes and
+    // .odd_lanes lets can be used.
+    Expr deinterleave_expr(Expr e, int num_lanes) {
+        if (num_lanes == 1) {
             return e;
-        } else if (num_lanes == 2) {
+        } else if (num_lanes % 2 == 0) {
             Expr a = extract_even_lanes(e, vector_lets);
             Expr b = extract_odd_lanes(e, vector_lets);
-            return Shuffle::make_interleave({a, b});
+            if (num_lanes == 2) {
+                return Shuffle::make_interleave({a, b});
+            }
+            // Deinterleave each half by the remaining factor, and
+            // interleave the pieces back together in order.
+            const Shuffle *sa = deinterleave_expr(a, num_lanes / 2).as<Shuffle>();
+            const Shuffle *sb = deinterleave_expr(b, num_lanes / 2).as<Shuffle>();
+            if (!sa || !sa->is_interleave() || !sb || !sb->is_interleave()) {
+                return e;
+            }
+            std::vector<Expr> pieces;
+            for (size_t i = 0; i < sa->vectors.size(); i++) {
+                pieces.push_back(sa->vectors[i]);
+                pieces.push_back(sb->vectors[i]);
+            }
+            return Shuffle::make_interleave(pieces);
         } else if (num_lanes == 3) {
             Expr a = extract_mod3_lanes(e, 0, vector_lets);
             Expr b = extract_mod3_lanes(e, 1, vector_lets);
             Expr c = extract_mod3_lanes(e, 2, vector_lets);
             return Shuffle::make_interleave({a, b, c});
-        } else if (num_lanes == 4) {
-            Expr a = extract_even_lanes(e, vector_lets);
-            Expr b = extract_odd_lanes(e, vector_lets);
-            Expr aa = extract_even_lanes(a, vector_lets);
-            Expr ab = extract_odd_lanes(a, vector_lets);
-            Expr ba = extract_even_lanes(b, vector_lets);
-            Expr bb = extract_odd_lanes(b, vector_lets);
-            return Shuffle::make_interleave({aa, ba, ab, bb});
         } else {
-            // Give up and don't do anything clever for >4
+            std::vector<Expr> pieces;
+            for (int i = 0; i < num_lanes; i++) {
+                pieces.push_back(extract_strided_lanes(e, i, num_lanes, vector_lets));
+            }
+            return Shuffle::make_interleave(pieces);
+        }
+    }
+
+    Expr deinterleave_expr(Expr e) {
+        if (e.type().lanes() <= num_lanes) {
+            // Just scalarize
             return e;
+        } else {
+            return deinterleave_expr(e, num_lanes);
         }
     }
 
@@ -468,7 +518,7 @@ class Interleaver : public IRMutator {
 
     void visit(const Mod *op) {
         const Ramp *r = op->a.as<Ramp>();
-        for (int i = 2; i <= 4; ++i) {
+        for (int i = 2; i <= 8; ++i) {
             if (r &&
                 is_const(op->b, i) &&
                 (r->type.lanes() % i) == 0) {
@@ -482,7 +532,7 @@ class Interleaver : public IRMutator {
 
     void visit(const Div *op) {
         const Ramp *r = op->a.as<Ramp>();
-        for (int i = 2; i <= 4; ++i) {
+        for (int i = 2; i <= 8; ++i) {
             if (r &&
                 is_const(op->b, i) &&
                 (r->type.lanes() % i) == 0) {
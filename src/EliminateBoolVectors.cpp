@@ -207,6 +207,24 @@ private:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        Expr value = mutate(op->value);
+        if (op->type.is_bool() && !value.type().is_bool()) {
+            // The value is now a mask of all ones or zeros, so and and
+            // or become min and max.
+            VectorReduce::Operator reduce_op =
+                op->op == VectorReduce::And ? VectorReduce::Min : VectorReduce::Max;
+            expr = VectorReduce::make(reduce_op, value, op->type.lanes());
+            if (op->type.is_scalar()) {
+                expr = expr != make_zero(expr.type());
+            }
+        } else if (!value.same_as(op->value)) {
+            expr = VectorReduce::make(op->op, value, op->type.lanes());
+        } else {
+            expr = op;
+        }
+    }
+
     template <typename NodeType, typename LetType>
     NodeType visit_let(const LetType *op) {
         Expr value = mutate(op->value);
@@ -64,6 +64,7 @@ enum class IRNodeType {
     Evaluate,
     Shuffle,
     Prefetch,
+    VectorReduce,
 };
 
 /** The abstract base classes for a node in the Halide IR. */
@@ -321,6 +322,28 @@ enum class DeviceAPI {
     Hexagon
 };
 
+/** An enum describing how the iterations of a parallel loop are
+ * handed out to the threads of the thread pool. Used by schedules, and
+ * in the For loop IR node. */
+enum class ParallelSchedule {
+    /** Threads claim one iteration at a time. Balances the load best,
+     * but every iteration costs a trip through the thread pool's
+     * lock. */
+    Dynamic,
+
+    /** The iterations are divided into one contiguous block per
+     * thread up front. Cheapest, for loops whose iterations all cost
+     * about the same. */
+    Static,
+
+    /** Threads claim chunks of iterations that shrink as the loop
+     * runs, in proportion to the number of iterations remaining
+     * divided by the number of threads, as OpenMP's guided
+     * schedule does. For loops with many iterations of uneven
+     * cost. */
+    Guided
+};
+
 /** An array containing all the device apis. Useful for iterating
  * through them. */
 const DeviceAPI all_device_apis[] = {DeviceAPI::None,
@@ -0,0 +1,349 @@
+#include "FindIntrinsics.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::vector;
+
+namespace {
+
+Expr make_intrinsic(Type t, const char *name, const vector<Expr> &args) {
+    return Call::make(t, name, args, Call::PureIntrinsic);
+}
+
+}  // namespace
+
+Expr widening_mul(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t.with_bits(t.bits() * 2), Call::widening_mul, {std::move(a), std::move(b)});
+}
+
+Expr saturating_add(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t, Call::saturating_add, {std::move(a), std::move(b)});
+}
+
+Expr saturating_sub(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t, Call::saturating_sub, {std::move(a), std::move(b)});
+}
+
+Expr halving_add(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t, Call::halving_add, {std::move(a), std::move(b)});
+}
+
+Expr rounding_halving_add(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t, Call::rounding_halving_add, {std::move(a), std::move(b)});
+}
+
+Expr mul_hi(Expr a, Expr b) {
+    Type t = a.type();
+    return make_intrinsic(t, Call::mul_hi, {std::move(a), std::move(b)});
+}
+
+Expr saturating_narrow(Type t, Expr a) {
+    t = t.with_lanes(a.type().lanes());
+    return make_intrinsic(t, Call::saturating_narrow, {std::move(a)});
+}
+
+bool is_fixed_point_intrinsic(const Call *op) {
+    return (op->is_intrinsic(Call::widening_mul) ||
+            op->is_intrinsic(Call::saturating_add) ||
+            op->is_intrinsic(Call::saturating_sub) ||
+            op->is_intrinsic(Call::halving_add) ||
+            op->is_intrinsic(Call::rounding_halving_add) ||
+            op->is_intrinsic(Call::mul_hi) ||
+            op->is_intrinsic(Call::saturating_narrow));
+}
+
+namespace {
+
+bool is_int_vector(Type t) {
+    return t.is_vector() && (t.is_int() || t.is_uint());
+}
+
+int64_t min_value(Type t) {
+    return t.is_uint() ? 0 : -(int64_t(1) << (t.bits() - 1));
+}
+
+int64_t max_value(Type t) {
+    return t.is_uint() ? (int64_t(1) << t.bits()) - 1 : (int64_t(1) << (t.bits() - 1)) - 1;
+}
+
+bool const_shift_amount(const Expr &e, int *amount) {
+    if (const int64_t *i = as_const_int(e)) {
+        *amount = (int)*i;
+        return true;
+    } else if (const uint64_t *u = as_const_uint(e)) {
+        *amount = (int)*u;
+        return true;
+    }
+    return false;
+}
+
+// Peel min and max against constants off of e, recording the bounds.
+Expr strip_bounds(Expr e, Expr &lo, Expr &hi) {
+    while (true) {
+        const Min *mn = e.as<Min>();
+        const Max *mx = e.as<Max>();
+        if (mn && !hi.defined() && is_const(mn->b)) {
+            hi = mn->b;
+            e = mn->a;
+        } else if (mx && !lo.defined() && is_const(mx->b)) {
+            lo = mx->b;
+            e = mx->a;
+        } else {
+            return e;
+        }
+    }
+}
+
+// Is e a cast from t, possibly broadcast?
+bool is_widening_cast(const Expr &e, Type t) {
+    if (const Broadcast *b = e.as<Broadcast>()) {
+        return is_widening_cast(b->value, t.element_of());
+    }
+    const Cast *c = e.as<Cast>();
+    return c && c->value.type() == t;
+}
+
+void flatten_sum(const Expr &e, vector<Expr> &terms) {
+    if (const Add *add = e.as<Add>()) {
+        flatten_sum(add->a, terms);
+        flatten_sum(add->b, terms);
+    } else {
+        terms.push_back(e);
+    }
+}
+
+class FindIntrinsics : public IRMutator {
+    using IRMutator::visit;
+
+    // Narrow both operands of a binary op to t, and look for
+    // intrinsics within them.
+    bool narrow_args(Type t, const Expr &a, const Expr &b, Expr &na, Expr &nb) {
+        t = t.with_lanes(a.type().lanes());
+        na = lossless_cast(t, a);
+        nb = lossless_cast(t, b);
+        if (!na.defined() || !nb.defined()) {
+            return false;
+        }
+        na = mutate(na);
+        nb = mutate(nb);
+        return true;
+    }
+
+    // cast(t, clamp(w, t.min(), t.max())), with either bound omitted
+    // if the operation can't exceed it.
+    Expr find_saturating(const Cast *op) {
+        Type t = op->type, w = op->value.type();
+        Expr lo, hi;
+        Expr v = strip_bounds(op->value, lo, hi);
+        if (!lo.defined() && !hi.defined()) {
+            return Expr();
+        }
+        if ((lo.defined() && !is_const(lo, min_value(t))) ||
+            (hi.defined() && !is_const(hi, max_value(t)))) {
+            return Expr();
+        }
+
+        Expr a, b;
+        if (w.bits() >= t.bits() * 2) {
+            const Add *add = v.as<Add>();
+            const Sub *sub = v.as<Sub>();
+            if (add && hi.defined() && (lo.defined() || t.is_uint()) &&
+                narrow_args(t, add->a, add->b, a, b)) {
+                return saturating_add(a, b);
+            }
+            if (sub && w.is_int() && lo.defined() && (hi.defined() || t.is_uint()) &&
+                narrow_args(t, sub->a, sub->b, a, b)) {
+                return saturating_sub(a, b);
+            }
+        }
+
+        if (hi.defined() && (lo.defined() || w.is_uint())) {
+            return saturating_narrow(t, mutate(v));
+        }
+        return Expr();
+    }
+
+    // cast(t, (w + w) / 2) and cast(t, (w + w + 1) / 2)
+    Expr find_averaging(const Cast *op) {
+        Type t = op->type, w = op->value.type();
+        if (w.bits() < t.bits() * 2) {
+            return Expr();
+        }
+
+        Expr sum;
+        int shift = 0;
+        const Div *div = op->value.as<Div>();
+        const Call *call = op->value.as<Call>();
+        if (div && is_const(div->b, 2)) {
+            sum = div->a;
+        } else if (call && call->is_intrinsic(Call::shift_right) &&
+                   const_shift_amount(call->args[1], &shift) && shift == 1) {
+            sum = call->args[0];
+        } else {
+            return Expr();
+        }
+
+        vector<Expr> terms;
+        flatten_sum(sum, terms);
+        bool round = false;
+        if (terms.size() == 3) {
+            for (size_t i = 0; i < terms.size(); i++) {
+                if (is_one(terms[i])) {
+                    terms.erase(terms.begin() + i);
+                    round = true;
+                    break;
+                }
+            }
+        }
+        Expr a, b;
+        if (terms.size() != 2 || !narrow_args(t, terms[0], terms[1], a, b)) {
+            return Expr();
+        }
+        return round ? rounding_halving_add(a, b) : halving_add(a, b);
+    }
+
+    // cast(t, (w * w) / 2^(t.bits() + k)), for 0 <= k < t.bits()
+    Expr find_mul_hi(const Cast *op) {
+        Type t = op->type, w = op->value.type();
+        if (w.bits() != t.bits() * 2 || w.code() != t.code()) {
+            return Expr();
+        }
+
+        Expr prod;
+        int shift = 0;
+        const Div *div = op->value.as<Div>();
+        const Call *call = op->value.as<Call>();
+        if (div && is_const_power_of_two_integer(div->b, &shift)) {
+            prod = div->a;
+        } else if (call && call->is_intrinsic(Call::shift_right) &&
+                   const_shift_amount(call->args[1], &shift)) {
+            prod = call->args[0];
+        }
+
+        const Mul *mul = prod.as<Mul>();
+        Expr a, b;
+        if (!mul || shift < t.bits() || shift >= w.bits() ||
+            !narrow_args(t, mul->a, mul->b, a, b)) {
+            return Expr();
+        }
+        Expr result = mul_hi(a, b);
+        if (shift > t.bits()) {
+            result = result >> (shift - t.bits());
+        }
+        return result;
+    }
+
+    void visit(const Cast *op) {
+        Type t = op->type, w = op->value.type();
+        if (is_int_vector(t) && is_int_vector(w) &&
+            t.bits() <= 32 && w.bits() > t.bits()) {
+            // Match the outermost pattern first, so that a narrowing
+            // cast of a widening multiply is not split in two.
+            Expr e = find_saturating(op);
+            if (!e.defined()) {
+                e = find_averaging(op);
+            }
+            if (!e.defined()) {
+                e = find_mul_hi(op);
+            }
+            if (e.defined()) {
+                expr = e;
+                return;
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+    void visit(const Mul *op) {
+        Type w = op->type;
+        if (is_int_vector(w) && w.bits() >= 16) {
+            Type t = w.with_bits(w.bits() / 2);
+            bool a_widens = is_widening_cast(op->a, t);
+            bool b_widens = is_widening_cast(op->b, t);
+            Expr a, b;
+            if ((a_widens || b_widens) &&
+                (a_widens || is_const(op->a)) &&
+                (b_widens || is_const(op->b)) &&
+                narrow_args(t, op->a, op->b, a, b)) {
+                expr = widening_mul(a, b);
+                return;
+            }
+        }
+        IRMutator::visit(op);
+    }
+
+    void visit(const For *op) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Device backends do their own instruction selection.
+            stmt = op;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+};
+
+class LowerIntrinsics : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Call *op) {
+        if (!is_fixed_point_intrinsic(op)) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        vector<Expr> args(op->args.size());
+        for (size_t i = 0; i < args.size(); i++) {
+            args[i] = mutate(op->args[i]);
+        }
+
+        Type t = op->type;
+        Type arg_t = args[0].type();
+        Type wide = arg_t.with_bits(arg_t.bits() * 2);
+        if (op->is_intrinsic(Call::widening_mul)) {
+            expr = cast(t, args[0]) * cast(t, args[1]);
+        } else if (op->is_intrinsic(Call::saturating_add)) {
+            expr = saturating_cast(t, cast(wide, args[0]) + cast(wide, args[1]));
+        } else if (op->is_intrinsic(Call::saturating_sub)) {
+            Type signed_wide = Int(wide.bits(), wide.lanes());
+            Expr diff = cast(signed_wide, args[0]) - cast(signed_wide, args[1]);
+            if (t.is_uint()) {
+                // The difference can't exceed the max of the type.
+                expr = cast(t, max(diff, 0));
+            } else {
+                expr = saturating_cast(t, diff);
+            }
+        } else if (op->is_intrinsic(Call::halving_add)) {
+            expr = cast(t, (cast(wide, args[0]) + cast(wide, args[1])) / 2);
+        } else if (op->is_intrinsic(Call::rounding_halving_add)) {
+            expr = cast(t, (cast(wide, args[0]) + cast(wide, args[1]) + 1) / 2);
+        } else if (op->is_intrinsic(Call::mul_hi)) {
+            expr = cast(t, (cast(wide, args[0]) * cast(wide, args[1])) /
+                        make_const(wide, int64_t(1) << t.bits()));
+        } else {
+            internal_assert(op->is_intrinsic(Call::saturating_narrow));
+            expr = saturating_cast(t, args[0]);
+        }
+    }
+};
+
+}  // namespace
+
+Stmt find_intrinsics(const Stmt &s) {
+    return FindIntrinsics().mutate(s);
+}
+
+Expr lower_intrinsic(const Call *op) {
+    return LowerIntrinsics().mutate(Expr(op));
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,53 @@
+#ifndef HALIDE_FIND_INTRINSICS_H
+#define HALIDE_FIND_INTRINSICS_H
+
+/** \file
+ * Defines the lowering pass that rewrites saturating, averaging,
+ * widening and multiply-high integer vector arithmetic into explicit
+ * intrinsics, and the fallbacks that turn them back into plain
+ * arithmetic.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Construct the intrinsics recognized by find_intrinsics. The
+ * arguments of the binary ones must have the same integer type.
+ *
+ * widening_mul computes its result in a type with twice the bits.
+ * saturating_add and saturating_sub clamp to the range of the argument
+ * type. halving_add and rounding_halving_add compute (a + b) / 2 and
+ * (a + b + 1) / 2 without overflow. mul_hi is the high half of
+ * widening_mul. saturating_narrow clamps a to the range of the
+ * narrower integer type t (with a's lanes) and casts to it. */
+// @{
+Expr widening_mul(Expr a, Expr b);
+Expr saturating_add(Expr a, Expr b);
+Expr saturating_sub(Expr a, Expr b);
+Expr halving_add(Expr a, Expr b);
+Expr rounding_halving_add(Expr a, Expr b);
+Expr mul_hi(Expr a, Expr b);
+Expr saturating_narrow(Type t, Expr a);
+// @}
+
+/** Is this call one of the intrinsics above? */
+bool is_fixed_point_intrinsic(const Call *op);
+
+/** Replace the various ways of spelling the operations above on
+ * integer vectors with the corresponding intrinsic, so that
+ * instruction selection does not depend on how an expression was
+ * written. Loops that run on a device API are left untouched. */
+Stmt find_intrinsics(const Stmt &s);
+
+/** Rewrite a fixed-point intrinsic, and any nested in its arguments,
+ * as arithmetic on wider types. This is the portable fallback for
+ * backends that have no instruction for an intrinsic, and produces the
+ * canonical form that their peephole patterns match. */
+Expr lower_intrinsic(const Call *op);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -269,6 +269,103 @@ bool var_name_match(string candidate, string var) {
     if (candidate == var) return true;
     return Internal::ends_with(candidate, "." + var);
 }
+
+class CallsFunction : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    void visit(const Call *op) {
+        if (op->call_type == Call::Halide && op->name == func) {
+            result = true;
+        }
+        IRGraphVisitor::visit(op);
+    }
+public:
+    const string &func;
+    bool result = false;
+
+    CallsFunction(const string &f) : func(f) {}
+};
+
+class UsesRVars : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    void visit(const Variable *op) {
+        if (op->reduction_domain.defined()) {
+            result = true;
+        }
+    }
+public:
+    bool result = false;
+};
+
+// Is this an update of the form f(args) = f(args) op e, where op is
+// one that vectorization can turn into a reduction across the lanes
+// (+, -, *, min, max, &&, ||), and neither e nor the args depend on
+// f? Vectorizing an RVar of such an update computes the same
+// reduction, in a different order.
+bool is_lane_reduction(const string &func_name, const Definition &def) {
+    if (def.values().size() != 1) {
+        return false;
+    }
+    UsesRVars uses_rvars;
+    for (const Expr &arg : def.args()) {
+        arg.accept(&uses_rvars);
+    }
+    if (uses_rvars.result) {
+        return false;
+    }
+
+    Expr value = def.values()[0], a, b;
+    bool commutative = true;
+    if (const Add *op = value.as<Add>()) {
+        a = op->a;
+        b = op->b;
+    } else if (const Sub *op = value.as<Sub>()) {
+        a = op->a;
+        b = op->b;
+        commutative = false;
+    } else if (const Mul *op = value.as<Mul>()) {
+        a = op->a;
+        b = op->b;
+    } else if (const Min *op = value.as<Min>()) {
+        a = op->a;
+        b = op->b;
+    } else if (const Max *op = value.as<Max>()) {
+        a = op->a;
+        b = op->b;
+    } else if (const And *op = value.as<And>()) {
+        a = op->a;
+        b = op->b;
+    } else if (const Or *op = value.as<Or>()) {
+        a = op->a;
+        b = op->b;
+    } else {
+        return false;
+    }
+
+    auto is_self_reference = [&](const Expr &e) {
+        const Call *call = e.as<Call>();
+        if (!call || call->call_type != Call::Halide || call->name != func_name ||
+            call->args.size() != def.args().size()) {
+            return false;
+        }
+        for (size_t i = 0; i < call->args.size(); i++) {
+            if (!equal(call->args[i], def.args()[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (commutative && !is_self_reference(a)) {
+        std::swap(a, b);
+    }
+    if (!is_self_reference(a)) {
+        return false;
+    }
+    CallsFunction calls(func_name);
+    b.accept(&calls);
+    return !calls.result;
+}
 }
 
 const std::string &Stage::name() const {
@@ -285,7 +382,12 @@ void Stage::set_dim_type(VarOrRVar var, ForType t) {
 
             // If it's an rvar and the for type is parallel, we need to
             // validate that this doesn't introduce a race condition.
-            if (!dims[i].is_pure() && var.is_rvar &&
+            // Vectorizing a simple reduction is safe, because the
+            // vectorizer reduces across the lanes.
+            bool vectorized_reduction =
+                (t == ForType::Vectorized &&
+                 is_lane_reduction(split_string(stage_name, ".update(")[0], definition));
+            if (!dims[i].is_pure() && var.is_rvar && !vectorized_reduction &&
                 (t == ForType::Vectorized || t == ForType::Parallel ||
                  t == ForType::GPUBlock || t == ForType::GPUThread)) {
                 user_assert(definition.schedule().allow_race_conditions())
@@ -340,6 +442,26 @@ void Stage::set_dim_device_api(VarOrRVar var, DeviceAPI device_api) {
     }
 }
 
+void Stage::set_dim_parallel_schedule(VarOrRVar var, ParallelSchedule schedule) {
+    bool found = false;
+    vector<Dim> &dims = definition.schedule().dims();
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (var_name_match(dims[i].var, var.name())) {
+            found = true;
+            dims[i].parallel_schedule = schedule;
+        }
+    }
+
+    if (!found) {
+        user_error << "In schedule for " << stage_name
+                   << ", could not find dimension "
+                   << var.name()
+                   << " to set to parallel schedule " << schedule
+                   << " in vars for function\n"
+                   << dump_argument_list();
+    }
+}
+
 std::string Stage::dump_argument_list() const {
     std::ostringstream oss;
     oss << "Vars:";
@@ -989,9 +1111,10 @@ void Stage::split(const string &old, const string &outer, const string &inner, E
     }
 
     if (exact) {
-        user_assert(tail == TailStrategy::GuardWithIf)
+        user_assert(tail == TailStrategy::GuardWithIf ||
+                    tail == TailStrategy::Predicate)
             << "When splitting Var " << old_name
-            << " the tail strategy must be GuardWithIf or Auto. "
+            << " the tail strategy must be GuardWithIf, Predicate or Auto. "
             << "Anything else may change the meaning of the algorithm\n";
     }
 
@@ -1376,6 +1499,12 @@ Stage &Stage::parallel(VarOrRVar var) {
     return *this;
 }
 
+Stage &Stage::parallel(VarOrRVar var, ParallelSchedule schedule) {
+    set_dim_type(var, ForType::Parallel);
+    set_dim_parallel_schedule(var, schedule);
+    return *this;
+}
+
 Stage &Stage::vectorize(VarOrRVar var) {
     set_dim_type(var, ForType::Vectorized);
     return *this;
@@ -1890,6 +2019,12 @@ Func &Func::parallel(VarOrRVar var) {
     return *this;
 }
 
+Func &Func::parallel(VarOrRVar var, ParallelSchedule schedule) {
+    invalidate_cache();
+    Stage(func.definition(), name(), args(), func.schedule()).parallel(var, schedule);
+    return *this;
+}
+
 Func &Func::vectorize(VarOrRVar var) {
     invalidate_cache();
     Stage(func.definition(), name(), args(), func.schedule()).vectorize(var);
@@ -2342,6 +2477,27 @@ Func &Func::store_root() {
     return store_at(LoopLevel::root());
 }
 
+Func &Func::slide_in_strips(int num_strips) {
+    user_assert(num_strips > 0)
+        << "Number of strips passed to slide_in_strips of Func "
+        << name() << " must be positive.\n";
+    invalidate_cache();
+    func.schedule().sliding_window_strips() = num_strips;
+    return *this;
+}
+
+Func &Func::compute_ahead() {
+    invalidate_cache();
+    func.schedule().compute_ahead() = true;
+    return *this;
+}
+
+Func &Func::store_nontemporal() {
+    invalidate_cache();
+    func.schedule().nontemporal_stores() = true;
+    return *this;
+}
+
 Func &Func::compute_inline() {
     return compute_at(LoopLevel::inlined());
 }
@@ -60,6 +60,7 @@ class Stage {
 
     void set_dim_type(VarOrRVar var, Internal::ForType t);
     void set_dim_device_api(VarOrRVar var, DeviceAPI device_api);
+    void set_dim_parallel_schedule(VarOrRVar var, ParallelSchedule schedule);
     void split(const std::string &old, const std::string &outer, const std::string &inner,
                Expr factor, bool exact, TailStrategy tail);
     void remove(const std::string &var);
@@ -178,6 +179,7 @@ public:
     EXPORT Stage &fuse(VarOrRVar inner, VarOrRVar outer, VarOrRVar fused);
     EXPORT Stage &serial(VarOrRVar var);
     EXPORT Stage &parallel(VarOrRVar var);
+    EXPORT Stage &parallel(VarOrRVar var, ParallelSchedule schedule);
     EXPORT Stage &vectorize(VarOrRVar var);
     EXPORT Stage &unroll(VarOrRVar var);
     EXPORT Stage &parallel(VarOrRVar var, Expr task_size, TailStrategy tail = TailStrategy::Auto);
@@ -1151,6 +1153,17 @@ public:
     /** Mark a dimension to be traversed in parallel */
     EXPORT Func &parallel(VarOrRVar var);
 
+    /** Mark a dimension to be traversed in parallel, and choose how
+     * the thread pool hands out its iterations to threads. The
+     * default, ParallelSchedule::Dynamic, hands them out one at a
+     * time. For loops with many cheap iterations, or iterations of
+     * very uneven cost (e.g. over sparse regions, or across a
+     * specialization), ParallelSchedule::Static or Guided claim
+     * iterations in chunks instead, avoiding a trip through the thread
+     * pool's lock for each one. Only the default thread pool uses
+     * this hint; a custom do_par_for sees the loop as usual. */
+    EXPORT Func &parallel(VarOrRVar var, ParallelSchedule schedule);
+
     /** Split a dimension by the given task_size, and the parallelize the
      * outer dimension. This creates parallel tasks that have size
      * task_size. After this call, var refers to the outer dimension of
@@ -1164,7 +1177,14 @@ public:
      * e.g. because it is the inner dimension following a split by a
      * constant factor. For most uses of vectorize you want the two
      * argument form. The variable to be vectorized should be the
-     * innermost one. */
+     * innermost one.
+     *
+     * An RVar of an update of the form f(x) = f(x) op e, where op is
+     * +, -, *, min, max, && or ||, x does not depend on the RDom, and
+     * e does not refer to f, may be vectorized. Each vector is then combined into
+     * f(x) with a reduction across its lanes. Like rfactor, this
+     * reassociates the reduction, which can change the rounding of
+     * floating point sums. */
     EXPORT Func &vectorize(VarOrRVar var);
 
     /** Mark a dimension to be completely unrolled. The dimension
@@ -1929,6 +1949,77 @@ public:
      * outside the outermost loop. */
     EXPORT Func &store_root();
 
+    /** Normally the sliding window optimization described in \ref
+     * Func::store_at only happens over serial loops. If this Func
+     * is stored outside of a parallel loop and computed inside it,
+     * this directive instead splits that parallel loop into at most
+     * num_strips strips that run in parallel. Each strip computes the
+     * full footprint of this Func on its first iteration (the
+     * warm-up), and then slides serially over the rest of the
+     * strip. For example:
+     *
+     \code
+     g.store_root().compute_at(f, y).slide_in_strips(32);
+     f.parallel(y);
+     \endcode
+     *
+     * Halide bounds the cost of the redundant warm-ups. If the
+     * footprint of g along y is statically known, strips are made
+     * long enough that the recomputation at the start of each strip
+     * is at most an eighth of the work done in steady state, so
+     * fewer than num_strips strips may be used for short loops. The
+     * strips share the storage of g, so they write identical
+     * values to the rows where they overlap. */
+    EXPORT Func &slide_in_strips(int num_strips);
+
+    /** Compute this Func one iteration ahead of the loop it is
+     * computed at. Each iteration computes the region of this Func
+     * that the next iteration will need (the first iteration also
+     * computes its own), and stores it in this Func's storage ahead
+     * of the consumer. This only reorders the work: the region for
+     * the next iteration is still computed on the same thread,
+     * before the consumer works on the current one, so the two do
+     * not overlap in time. What it buys is that the loads done to
+     * produce the region are made in their own simple streaming
+     * loop, rather than interleaved with the consumer's work. Unlike
+     * \ref Func::prefetch, which only issues cache hints, the data
+     * is actually staged into this Func's storage. Typically used on
+     * a wrapper that copies tiles of an input:
+     *
+     \code
+     Func staged = input.in(f);
+     f.tile(x, y, xo, yo, xi, yi, 64, 64);
+     staged.store_at(f, yo).compute_at(f, xo).compute_ahead();
+     \endcode
+     *
+     * Like the sliding window optimization, this requires the Func
+     * to be stored outside of the serial loop it is computed at, and
+     * its footprint to move monotonically along a single dimension
+     * as that loop progresses. Storage folding then shrinks the
+     * storage to a circular buffer that holds two iterations' worth
+     * of values. */
+    EXPORT Func &compute_ahead();
+
+    /** Write the dense vector stores to this Func's buffer with
+     * non-temporal (streaming) stores, which go straight to memory
+     * instead of first pulling each cache line into the cache. This
+     * is a win for large compute_root outputs that are written once
+     * and not read again until long after, because it saves both the
+     * read-for-ownership traffic and the eviction of more useful data
+     * from the last level cache. It is a loss if a consumer reads the
+     * values back soon after they are written. A store fence is
+     * inserted at the end of the producer (and at the end of each
+     * parallel task within it), so consumers always see the stored
+     * values. Only affects targets with streaming stores (e.g. x86),
+     * and only vector stores that are known to be aligned to the
+     * vector width, so this is usually combined with align_storage
+     * and align_bounds (or set_host_alignment and aligned bounds on
+     * an output buffer). The autoscheduler only turns this on if
+     * MachineParams::nontemporal_stores is set, in which case it does
+     * so for stages it computes at root whose output is larger than
+     * the last level cache. */
+    EXPORT Func &store_nontemporal();
+
     /** Aggressively inline all uses of this function. This is the
      * default schedule, so you're unlikely to need to call this. For
      * a Func with an update definition, that means it gets computed
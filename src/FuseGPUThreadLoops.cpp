@@ -305,7 +305,7 @@ class ExtractSharedAllocations : public IRMutator {
                 allocations.swap(old);
             }
 
-            stmt = For::make(op->name, mutate(op->min), mutate(op->extent), op->for_type, op->device_api, body);
+            stmt = For::make(op->name, mutate(op->min), mutate(op->extent), op->for_type, op->device_api, body, op->parallel_schedule);
         }
     }
 
@@ -629,7 +629,7 @@ class FuseGPUThreadLoopsSingleKernel : public IRMutator {
             if (body.same_as(op->body)) {
                 stmt = op;
             } else {
-                stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+                stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
             }
         } else {
             IRMutator::visit(op);
@@ -697,7 +697,7 @@ class ZeroGPULoopMins : public IRMutator {
             internal_assert(op);
             Expr adjusted = Variable::make(Int(32), op->name) + op->min;
             Stmt body = substitute(op->name, adjusted, op->body);
-            stmt = For::make(op->name, 0, op->extent, op->for_type, op->device_api, body);
+            stmt = For::make(op->name, 0, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
         }
 
         in_non_glsl_gpu = old_in_non_glsl_gpu;
@@ -675,7 +675,7 @@ class InjectHexagonRpc : public IRMutator {
         // After moving this to Hexagon, it doesn't need to be marked
         // Hexagon anymore.
         Stmt body = For::make(loop->name, loop->min, loop->extent, loop->for_type,
-                              DeviceAPI::None, loop->body);
+                              DeviceAPI::None, loop->body, loop->parallel_schedule);
         body = remove_trivial_for_loops(body);
 
         // Build a closure for the device code.
@@ -325,7 +325,8 @@ Stmt ProducerConsumer::make_consume(const std::string &name, Stmt body) {
     return ProducerConsumer::make(name, false, std::move(body));
 }
 
-Stmt For::make(const std::string &name, Expr min, Expr extent, ForType for_type, DeviceAPI device_api, Stmt body) {
+Stmt For::make(const std::string &name, Expr min, Expr extent, ForType for_type, DeviceAPI device_api, Stmt body,
+               ParallelSchedule parallel_schedule) {
     internal_assert(min.defined()) << "For of undefined\n";
     internal_assert(extent.defined()) << "For of undefined\n";
     internal_assert(min.type().is_scalar()) << "For with vector min\n";
@@ -339,6 +340,7 @@ Stmt For::make(const std::string &name, Expr min, Expr extent, ForType for_type,
     node->for_type = for_type;
     node->device_api = device_api;
     node->body = std::move(body);
+    node->parallel_schedule = parallel_schedule;
     return node;
 }
 
@@ -661,6 +663,22 @@ Expr Shuffle::make_extract_element(Expr vector, int i) {
     return make_slice(std::move(vector), i, 1, 1);
 }
 
+Expr VectorReduce::make(VectorReduce::Operator op, Expr value, int lanes) {
+    internal_assert(value.defined()) << "VectorReduce of undefined\n";
+    internal_assert(lanes > 0) << "VectorReduce must have at least one lane\n";
+    internal_assert(value.type().lanes() % lanes == 0)
+        << "VectorReduce of " << value.type().lanes() << " lanes to "
+        << lanes << " lanes, which is not a divisor\n";
+    internal_assert((op != And && op != Or) || value.type().is_bool())
+        << "VectorReduce with And or Or must be of boolean type\n";
+
+    VectorReduce *node = new VectorReduce;
+    node->type = value.type().with_lanes(lanes);
+    node->op = op;
+    node->value = std::move(value);
+    return node;
+}
+
 bool Shuffle::is_interleave() const {
     int lanes = vectors.front().type().lanes();
 
@@ -761,6 +779,7 @@ template<> EXPORT void ExprNode<Ramp>::accept(IRVisitor *v) const { v->visit((co
 template<> EXPORT void ExprNode<Broadcast>::accept(IRVisitor *v) const { v->visit((const Broadcast *)this); }
 template<> EXPORT void ExprNode<Call>::accept(IRVisitor *v) const { v->visit((const Call *)this); }
 template<> EXPORT void ExprNode<Shuffle>::accept(IRVisitor *v) const { v->visit((const Shuffle *)this); }
+template<> EXPORT void ExprNode<VectorReduce>::accept(IRVisitor *v) const { v->visit((const VectorReduce *)this); }
 template<> EXPORT void ExprNode<Let>::accept(IRVisitor *v) const { v->visit((const Let *)this); }
 template<> EXPORT void StmtNode<LetStmt>::accept(IRVisitor *v) const { v->visit((const LetStmt *)this); }
 template<> EXPORT void StmtNode<AssertStmt>::accept(IRVisitor *v) const { v->visit((const AssertStmt *)this); }
@@ -818,6 +837,14 @@ Call::ConstString Call::select_mask = "select_mask";
 Call::ConstString Call::extract_mask_element = "extract_mask_element";
 Call::ConstString Call::require = "require";
 Call::ConstString Call::size_of_halide_buffer_t = "size_of_halide_buffer_t";
+Call::ConstString Call::nontemporal_store_fence = "nontemporal_store_fence";
+Call::ConstString Call::widening_mul = "widening_mul";
+Call::ConstString Call::saturating_add = "saturating_add";
+Call::ConstString Call::saturating_sub = "saturating_sub";
+Call::ConstString Call::halving_add = "halving_add";
+Call::ConstString Call::rounding_halving_add = "rounding_halving_add";
+Call::ConstString Call::mul_hi = "mul_hi";
+Call::ConstString Call::saturating_narrow = "saturating_narrow";
 
 Call::ConstString Call::buffer_get_min = "_halide_buffer_get_min";
 Call::ConstString Call::buffer_get_extent = "_halide_buffer_get_extent";
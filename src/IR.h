@@ -512,7 +512,15 @@ struct Call : public ExprNode<Call> {
         select_mask,
         extract_mask_element,
         require,
-        size_of_halide_buffer_t;
+        size_of_halide_buffer_t,
+        nontemporal_store_fence,
+        widening_mul,
+        saturating_add,
+        saturating_sub,
+        halving_add,
+        rounding_halving_add,
+        mul_hi,
+        saturating_narrow;
 
     // We also declare some symbolic names for some of the runtime
     // functions that we want to construct Call nodes to here to avoid
@@ -652,7 +660,12 @@ struct For : public StmtNode<For> {
     DeviceAPI device_api;
     Stmt body;
 
-    EXPORT static Stmt make(const std::string &name, Expr min, Expr extent, ForType for_type, DeviceAPI device_api, Stmt body);
+    /** How the iterations are handed out to threads, if the loop is
+     * parallel. */
+    ParallelSchedule parallel_schedule;
+
+    EXPORT static Stmt make(const std::string &name, Expr min, Expr extent, ForType for_type, DeviceAPI device_api, Stmt body,
+                            ParallelSchedule parallel_schedule = ParallelSchedule::Dynamic);
 
     bool is_parallel() const {
         return (for_type == ForType::Parallel ||
@@ -716,6 +729,29 @@ struct Shuffle : public ExprNode<Shuffle> {
     static const IRNodeType _node_type = IRNodeType::Shuffle;
 };
 
+/** Horizontally reduce a vector to a vector with fewer lanes, by
+ * combining groups of adjacent lanes with an associative and
+ * commutative operator. Lane i of the result combines lanes i * k to
+ * (i + 1) * k - 1 of the value, where k is the ratio of the lane
+ * counts. */
+struct VectorReduce : public ExprNode<VectorReduce> {
+    enum Operator {
+        Add,
+        Mul,
+        Min,
+        Max,
+        And,
+        Or,
+    };
+
+    Expr value;
+    Operator op;
+
+    EXPORT static Expr make(Operator op, Expr value, int lanes);
+
+    static const IRNodeType _node_type = IRNodeType::VectorReduce;
+};
+
 /** Represent a multi-dimensional region of a Func or an ImageParam that
  * needs to be prefetched. */
 struct Prefetch : public StmtNode<Prefetch> {
@@ -89,6 +89,7 @@ private:
     void visit(const IfThenElse *);
     void visit(const Evaluate *);
     void visit(const Shuffle *);
+    void visit(const VectorReduce *);
     void visit(const Prefetch *);
 };
 
@@ -362,6 +363,7 @@ void IRComparer::visit(const For *op) {
 
     compare_names(s->name, op->name);
     compare_scalar(s->for_type, op->for_type);
+    compare_scalar(s->parallel_schedule, op->parallel_schedule);
     compare_expr(s->min, op->min);
     compare_expr(s->extent, op->extent);
     compare_stmt(s->body, op->body);
@@ -451,6 +453,14 @@ void IRComparer::visit(const Shuffle *op) {
     }
 }
 
+void IRComparer::visit(const VectorReduce *op) {
+    const VectorReduce *e = expr.as<VectorReduce>();
+
+    compare_scalar(e->op, op->op);
+    // We've already compared types, so it's enough to compare the value
+    compare_expr(e->value, op->value);
+}
+
 void IRComparer::visit(const Prefetch *op) {
     const Prefetch *s = expr.as<Prefetch>();
 
@@ -221,6 +221,16 @@ public:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        const VectorReduce *e = expr.as<VectorReduce>();
+        if (result && e && op->op == e->op && types_match(op->type, e->type)) {
+            expr = e->value;
+            op->value.accept(this);
+        } else {
+            result = false;
+        }
+    }
+
     void visit(const Call *op) {
         const Call *e = expr.as<Call>();
         if (result && e &&
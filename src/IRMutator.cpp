@@ -221,7 +221,8 @@ void IRMutator::visit(const For *op) {
         stmt = op;
     } else {
         stmt = For::make(op->name, std::move(min), std::move(extent),
-                         op->for_type, op->device_api, std::move(body));
+                         op->for_type, op->device_api, std::move(body),
+                         op->parallel_schedule);
     }
 }
 
@@ -375,6 +376,15 @@ void IRMutator::visit(const Shuffle *op) {
     }
 }
 
+void IRMutator::visit(const VectorReduce *op) {
+    Expr value = mutate(op->value);
+    if (value.same_as(op->value)) {
+        expr = op;
+    } else {
+        expr = VectorReduce::make(op->op, std::move(value), op->type.lanes());
+    }
+}
+
 
 Stmt IRGraphMutator::mutate(const Stmt &s) {
     auto iter = stmt_replacements.find(s);
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <sstream>
 #include <cmath>
+#include <cfloat>
 #include <algorithm>
 
 #include "IROperator.h"
@@ -46,6 +47,33 @@ Expr evaluate_polynomial(const Expr &x, float *coeff, int n) {
         return odd_terms * std::move(x) + even_terms;
     }
 }
+
+// The same, with double-precision coefficients, for polynomials in
+// either Float(32) or Float(64).
+Expr evaluate_polynomial(const Expr &x, const double *coeff, int n) {
+    internal_assert(n >= 2);
+
+    Type t = x.type();
+    Expr x2 = x * x;
+
+    Expr even_terms = Internal::make_const(t, coeff[0]);
+    Expr odd_terms = Internal::make_const(t, coeff[1]);
+
+    for (int i = 2; i < n; i++) {
+        Expr &terms = (i & 1) ? odd_terms : even_terms;
+        if (coeff[i] == 0.0) {
+            terms *= x2;
+        } else {
+            terms = terms * x2 + Internal::make_const(t, coeff[i]);
+        }
+    }
+
+    if ((n & 1) == 0) {
+        return even_terms * x + odd_terms;
+    } else {
+        return odd_terms * x + even_terms;
+    }
+}
 }
 
 namespace Internal {
@@ -484,8 +512,115 @@ void range_reduce_log(const Expr &input, Expr *reduced, Expr *exponent) {
     *reduced = reinterpret(type, blended);
 }
 
+namespace {
+
+// Cephes' exp, for Float(64). Denormal results flush to zero.
+Expr halide_exp_f64(Expr x_full) {
+    Type type = x_full.type();
+    Type int_type = Int(64, type.lanes());
+    auto c = [&](double v) {return make_const(type, v);};
+
+    Expr x = clamp(std::move(x_full), c(-746.0), c(710.0));
+    Expr k_real = floor(x * c(1.4426950408889634073599) + c(0.5));
+    Expr k = cast(int_type, k_real);
+
+    x -= k_real * c(6.93145751953125E-1);
+    x -= k_real * c(1.42860682030941723212E-6);
+
+    // A Pade approximation, exp(x) = 1 + 2x P(x^2) / (Q(x^2) - x P(x^2))
+    const double p_coeff[] = {
+        1.26177193074810590878E-4,
+        3.02994407707441961300E-2,
+        9.99999999999999999910E-1};
+    const double q_coeff[] = {
+        3.00198505138664455042E-6,
+        2.52448340349684104192E-3,
+        2.27265548208155028766E-1,
+        2.00000000000000000009E0};
+    Expr xx = x * x;
+    Expr px = x * evaluate_polynomial(xx, p_coeff, 3);
+    Expr qx = evaluate_polynomial(xx, q_coeff, 4);
+    Expr result = px / (qx - px) * c(2.0) + c(1.0);
+
+    // Multiply by 2^k as 2 * 2^(k-1), so that results just below the
+    // overflow threshold don't overflow the exponent field first.
+    Expr biased = k + 1022;
+    Expr two_to_the_k_minus_one = reinterpret(type, biased << 52);
+    result = (result * c(2.0)) * two_to_the_k_minus_one;
+
+    result = select(biased > 0, result, make_zero(type));
+
+    return common_subexpression_elimination(result);
+}
+
+// Cephes' log, for Float(64).
+Expr halide_log_f64(Expr x_full) {
+    Type type = x_full.type();
+    Type int_type = Int(64, type.lanes());
+    auto c = [&](double v) {return make_const(type, v);};
+
+    Expr nan = Call::make(type, "nan_f64", {}, Call::PureExtern);
+    Expr neg_inf = Call::make(type, "neg_inf_f64", {}, Call::PureExtern);
+    Expr inf = Call::make(type, "inf_f64", {}, Call::PureExtern);
+
+    Expr use_nan = x_full < c(0.0);
+    Expr use_neg_inf = x_full == c(0.0);
+    Expr use_inf = x_full > c(DBL_MAX);
+    Expr exceptional = use_nan || use_neg_inf || use_inf;
+
+    Expr x = select(exceptional, make_one(type), x_full);
+
+    // Scale denormals up into the normal range.
+    Expr denormal = x < c(DBL_MIN);
+    x = select(denormal, x * c(18014398509481984.0), x);
+
+    // Split x into an exponent and a mantissa in [sqrt(0.5), sqrt(2)).
+    Expr bits = reinterpret(int_type, x);
+    Expr e = (bits >> 52) - select(denormal, make_const(int_type, 1023 + 54), make_const(int_type, 1023));
+    Expr m = reinterpret(type, (bits & make_const(int_type, (int64_t)0x000fffffffffffffLL)) |
+                         make_const(int_type, (int64_t)0x3ff0000000000000LL));
+    Expr high = m > c(1.41421356237309504880);
+    m = select(high, m * c(0.5), m);
+    Expr exponent = cast(type, select(high, e + 1, e));
+
+    // log(1 + f) = f - f^2/2 + f^3 P(f) / Q(f)
+    const double p_coeff[] = {
+        1.01875663804580931796E-4,
+        4.97494994976747001425E-1,
+        4.70579119878881725854E0,
+        1.44989225341610930846E1,
+        1.79368678507819816313E1,
+        7.70838733755885391666E0};
+    const double q_coeff[] = {
+        1.0,
+        1.12873587189167450590E1,
+        4.52279145837532221105E1,
+        8.29875266912776603211E1,
+        7.11544750618563894466E1,
+        2.31251620126765340583E1};
+    Expr f = m - c(1.0);
+    Expr z = f * f;
+    Expr y = f * (z * (evaluate_polynomial(f, p_coeff, 6) / evaluate_polynomial(f, q_coeff, 6)));
+
+    // Add in the exponent times log(2), which is split in two for
+    // extra precision.
+    y += exponent * c(-2.121944400546905827679e-4);
+    y -= z * c(0.5);
+    Expr result = f + y;
+    result += exponent * c(0.693359375);
+
+    result = select(exceptional, select(use_nan, nan, use_neg_inf, neg_inf, inf), result);
+
+    return common_subexpression_elimination(result);
+}
+
+}
+
 Expr halide_log(Expr x_full) {
     Type type = x_full.type();
+    if (type.element_of() == Float(64)) {
+        return halide_log_f64(std::move(x_full));
+    }
     internal_assert(type.element_of() == Float(32));
 
     Expr nan = Call::make(type, "nan_f32", {}, Call::PureExtern);
@@ -530,6 +665,9 @@ Expr halide_log(Expr x_full) {
 
 Expr halide_exp(Expr x_full) {
     Type type = x_full.type();
+    if (type.element_of() == Float(64)) {
+        return halide_exp_f64(std::move(x_full));
+    }
     internal_assert(type.element_of() == Float(32));
 
     float ln2_part1 = 0.6931457519f;
@@ -615,6 +753,201 @@ Expr halide_erf(Expr x_full) {
     return result;
 }
 
+namespace {
+
+// Cephes' sinf/cosf and sin/cos. Subtract the nearest multiple of
+// pi/2 (in three parts, for precision), evaluate the sin or cos
+// polynomial on the remainder according to the quadrant, and fix up
+// the sign.
+Expr sin_or_cos(Expr x_full, bool cosine) {
+    Type type = x_full.type();
+    bool is_f64 = type.element_of() == Float(64);
+    internal_assert(is_f64 || type.element_of() == Float(32));
+    Type int_type = Int(32, type.lanes());
+    auto c = [&](double v) {return make_const(type, v);};
+
+    Expr k_real = round(x_full * c(0.63661977236758134308));
+    // Only the quadrant, k mod 4, matters. Take it before converting
+    // to an integer, so that large arguments don't overflow. This is
+    // exact, as k_real / 4 is.
+    Expr k = cast(int_type, k_real - c(4.0) * floor(k_real * c(0.25)));
+
+    Expr r;
+    if (is_f64) {
+        r = x_full - k_real * c(1.57079625129699707031);
+        r -= k_real * c(7.54978941586159635336E-8);
+        r -= k_real * c(5.39030285815811905290E-15);
+    } else {
+        r = x_full - k_real * c(1.5703125);
+        r -= k_real * c(4.837512969970703125e-4);
+        r -= k_real * c(7.54978995489188216e-8);
+    }
+    Expr z = r * r;
+
+    const double sin_f32[] = {
+        -1.9515295891E-4,
+        8.3321608736E-3,
+        -1.6666654611E-1};
+    const double cos_f32[] = {
+        2.443315711809948E-005,
+        -1.388731625493765E-003,
+        4.166664568298827E-002};
+    const double sin_f64[] = {
+        1.58962301576546568060E-10,
+        -2.50507477628578072866E-8,
+        2.75573136213857245213E-6,
+        -1.98412698295895385996E-4,
+        8.33333333332211858878E-3,
+        -1.66666666666666307295E-1};
+    const double cos_f64[] = {
+        -1.13585365213876817300E-11,
+        2.08757008419747316778E-9,
+        -2.75573141792967388112E-7,
+        2.48015872888517045348E-5,
+        -1.38888888888730564116E-3,
+        4.16666666666665929218E-2};
+
+    Expr s, co;
+    if (is_f64) {
+        s = r * z * evaluate_polynomial(z, sin_f64, 6) + r;
+        co = z * z * evaluate_polynomial(z, cos_f64, 6) + (c(1.0) - z * c(0.5));
+    } else {
+        s = r * z * evaluate_polynomial(z, sin_f32, 3) + r;
+        co = z * z * evaluate_polynomial(z, cos_f32, 3) + (c(1.0) - z * c(0.5));
+    }
+
+    // cos(x) = sin(x + pi/2)
+    if (cosine) {
+        k += 1;
+    }
+    Expr one = make_one(int_type), two = make_two(int_type);
+    Expr result = select((k & one) == one, co, s);
+    result = select((k & two) == two, -result, result);
+
+    return common_subexpression_elimination(result);
+}
+
+}
+
+Expr halide_sin(Expr x_full) {
+    return sin_or_cos(std::move(x_full), false);
+}
+
+Expr halide_cos(Expr x_full) {
+    return sin_or_cos(std::move(x_full), true);
+}
+
+Expr halide_atan(Expr x_full) {
+    Type type = x_full.type();
+    bool is_f64 = type.element_of() == Float(64);
+    internal_assert(is_f64 || type.element_of() == Float(32));
+    auto c = [&](double v) {return make_const(type, v);};
+
+    // Reduce the magnitude into [0, tan(pi/8)] (or [0, 0.66] for
+    // Float(64)) using atan(x) = pi/2 - atan(1/x) and atan(x) = pi/4 +
+    // atan((x-1)/(x+1)).
+    Expr ax = abs(x_full);
+    Expr big = ax > c(2.41421356237309504880);
+    Expr mid = ax > c(is_f64 ? 0.66 : 0.41421356237309504880);
+    Expr t = (select(big, c(-1.0), mid, ax - c(1.0), ax) /
+              select(big, ax, mid, ax + c(1.0), c(1.0)));
+    Expr y = select(big, c(1.57079632679489661923), mid, c(0.78539816339744830962), c(0.0));
+    Expr z = t * t;
+
+    if (is_f64) {
+        const double p_coeff[] = {
+            -8.750608600031904122785E-1,
+            -1.615753718733365076637E1,
+            -7.500855792314704667340E1,
+            -1.228866684490136173410E2,
+            -6.485021904942025371773E1};
+        const double q_coeff[] = {
+            1.0,
+            2.485846490142306297962E1,
+            1.650270098316988542046E2,
+            4.328810604912902668951E2,
+            4.853903996359136964868E2,
+            1.945506571482613964425E2};
+        Expr p = t * (z * (evaluate_polynomial(z, p_coeff, 5) / evaluate_polynomial(z, q_coeff, 6))) + t;
+        // The low bits of pi/2 and pi/4 that don't fit in y.
+        const double more_bits = 6.123233995736765886130E-17;
+        y += p + select(big, c(more_bits), mid, c(more_bits * 0.5), c(0.0));
+    } else {
+        const double p_coeff[] = {
+            8.05374449538e-2,
+            -1.38776856032E-1,
+            1.99777106478E-1,
+            -3.33329491539E-1};
+        y += t * z * evaluate_polynomial(z, p_coeff, 4) + t;
+    }
+
+    Expr result = select(x_full < c(0.0), -y, y);
+
+    return common_subexpression_elimination(result);
+}
+
+Expr halide_atan2(Expr y, Expr x) {
+    Type type = y.type();
+    internal_assert(x.type() == type);
+    Type int_type = Int(type.bits(), type.lanes());
+    auto c = [&](double v) {return make_const(type, v);};
+
+    // Compute the angle in the first octant, then reflect it into the
+    // right one. Testing the sign bits instead of comparing against
+    // zero gets signed zeros right.
+    Expr ax = abs(x), ay = abs(y);
+    Expr num = min(ax, ay), den = max(ax, ay);
+    Expr a = halide_atan(select(den == c(0.0), c(0.0), num / den));
+    a = select(ay > ax, c(1.57079632679489661923) - a, a);
+    a = select(reinterpret(int_type, x) < 0, c(3.14159265358979323846) - a, a);
+    Expr result = select(reinterpret(int_type, y) < 0, -a, a);
+
+    return common_subexpression_elimination(result);
+}
+
+Expr halide_tanh(Expr x_full) {
+    Type type = x_full.type();
+    bool is_f64 = type.element_of() == Float(64);
+    internal_assert(is_f64 || type.element_of() == Float(32));
+    auto c = [&](double v) {return make_const(type, v);};
+
+    // For large magnitudes, tanh(x) = 1 - 2 / (exp(2x) + 1). The
+    // result is +/-1 to within precision well before the clamp.
+    Expr ax = abs(x_full);
+    Expr e = halide_exp(min(ax, c(20.0)) * c(2.0));
+    Expr big = c(1.0) - c(2.0) / (e + c(1.0));
+    big = select(x_full < c(0.0), -big, big);
+
+    // For small ones, where the above loses precision, use an odd
+    // polynomial (or rational function for Float(64)).
+    Expr s = x_full * x_full;
+    Expr small;
+    if (is_f64) {
+        const double p_coeff[] = {
+            -9.64399179425052238628E-1,
+            -9.92877231001918586564E1,
+            -1.61468768441708447952E3};
+        const double q_coeff[] = {
+            1.0,
+            1.12811678491632931402E2,
+            2.23548839060100448583E3,
+            4.84406305325125486048E3};
+        small = x_full * s * (evaluate_polynomial(s, p_coeff, 3) / evaluate_polynomial(s, q_coeff, 4)) + x_full;
+    } else {
+        const double p_coeff[] = {
+            -5.70498872745E-3,
+            2.06390887954E-2,
+            -5.37397155531E-2,
+            1.33314422036E-1,
+            -3.33332819422E-1};
+        small = x_full * s * evaluate_polynomial(s, p_coeff, 5) + x_full;
+    }
+
+    Expr result = select(ax >= c(0.625), big, small);
+
+    return common_subexpression_elimination(result);
+}
+
 Expr raise_to_integer_power(Expr e, int64_t p) {
     Expr result;
     if (p == 0) {
@@ -763,7 +1096,10 @@ Expr strided_ramp_base(Expr e, int stride) {
 } // namespace Internal
 
 Expr fast_log(Expr x) {
-    user_assert(x.type() == Float(32)) << "fast_log only works for Float(32)";
+    if (x.type() == Float(64)) {
+        return Internal::halide_log(std::move(x));
+    }
+    user_assert(x.type() == Float(32)) << "fast_log only works for Float(32) or Float(64)";
 
     Expr reduced, exponent;
     range_reduce_log(x, &reduced, &exponent);
@@ -787,7 +1123,10 @@ Expr fast_log(Expr x) {
 }
 
 Expr fast_exp(Expr x_full) {
-    user_assert(x_full.type() == Float(32)) << "fast_exp only works for Float(32)";
+    if (x_full.type() == Float(64)) {
+        return Internal::halide_exp(std::move(x_full));
+    }
+    user_assert(x_full.type() == Float(32)) << "fast_exp only works for Float(32) or Float(64)";
 
     Expr scaled = x_full / logf(2.0);
     Expr k_real = floor(scaled);
@@ -814,6 +1153,32 @@ Expr fast_exp(Expr x_full) {
     result = common_subexpression_elimination(result);
     return result;
 }
+
+Expr fast_sin(Expr x) {
+    user_assert(x.type() == Float(32) || x.type() == Float(64)) << "fast_sin only works for Float(32) or Float(64)";
+    return Internal::halide_sin(std::move(x));
+}
+
+Expr fast_cos(Expr x) {
+    user_assert(x.type() == Float(32) || x.type() == Float(64)) << "fast_cos only works for Float(32) or Float(64)";
+    return Internal::halide_cos(std::move(x));
+}
+
+Expr fast_atan(Expr x) {
+    user_assert(x.type() == Float(32) || x.type() == Float(64)) << "fast_atan only works for Float(32) or Float(64)";
+    return Internal::halide_atan(std::move(x));
+}
+
+Expr fast_atan2(Expr y, Expr x) {
+    user_assert(y.type() == x.type() && (x.type() == Float(32) || x.type() == Float(64)))
+        << "fast_atan2 only works for two Float(32) or two Float(64) arguments";
+    return Internal::halide_atan2(std::move(y), std::move(x));
+}
+
+Expr fast_tanh(Expr x) {
+    user_assert(x.type() == Float(32) || x.type() == Float(64)) << "fast_tanh only works for Float(32) or Float(64)";
+    return Internal::halide_tanh(std::move(x));
+}
 Expr stringify(const std::vector<Expr> &args) {
     return Internal::Call::make(type_of<const char *>(), Internal::Call::stringify,
                                 args, Internal::Call::Intrinsic);
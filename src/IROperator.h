@@ -159,11 +159,35 @@ EXPORT Expr lossless_cast(Type t, Expr e);
  */
 EXPORT void match_types(Expr &a, Expr &b);
 
-/** Halide's vectorizable transcendentals. */
+/** Halide's vectorizable transcendentals. These are polynomial
+ * approximations built from arithmetic, selects and bit manipulation,
+ * and work on scalars or vectors of Float(32) or Float(64) (halide_erf
+ * is Float(32) only). Measured maximum errors:
+ *
+ \code
+             Float(32)      Float(64)
+   log       3.3 ulp        1 ulp
+   exp       2.2 ulp        2.1 ulp
+   sin, cos  1.6 ulp        2.1 ulp
+   atan      2.9 ulp        1 ulp
+   atan2     3.2 ulp        1.8 ulp
+   tanh      1.6 ulp        1.5 ulp
+ \endcode
+ *
+ * sin and cos are within 1.6 ulp for |x| <= pi. Beyond that the
+ * argument reduction loses precision gradually: the absolute error
+ * stays below 1e-7 for Float(32) |x| < 8192, and below 2e-16 for
+ * Float(64) |x| < 1e9. Denormal results of exp flush to zero.
+ */
 // @{
 EXPORT Expr halide_log(Expr a);
 EXPORT Expr halide_exp(Expr a);
 EXPORT Expr halide_erf(Expr a);
+EXPORT Expr halide_sin(Expr a);
+EXPORT Expr halide_cos(Expr a);
+EXPORT Expr halide_atan(Expr a);
+EXPORT Expr halide_atan2(Expr y, Expr x);
+EXPORT Expr halide_tanh(Expr a);
 // @}
 
 /** Raise an expression to an integer power by repeatedly multiplying
@@ -911,7 +935,7 @@ inline Expr select(Expr c0, Expr v0, Expr c1, Expr v1, Args&&... args) {
 
 /** Return the sine of a floating-point expression. If the argument is
  * not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * well. See fast_sin for a vectorizable approximation. */
 inline Expr sin(Expr x) {
     user_assert(x.defined()) << "sin of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -939,7 +963,7 @@ inline Expr asin(Expr x) {
 
 /** Return the cosine of a floating-point expression. If the argument
  * is not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * well. See fast_cos for a vectorizable approximation. */
 inline Expr cos(Expr x) {
     user_assert(x.defined()) << "cos of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -981,7 +1005,7 @@ inline Expr tan(Expr x) {
 
 /** Return the arctangent of a floating-point expression. If the
  * argument is not floating-point, it is cast to Float(32). Does not
- * vectorize well. */
+ * vectorize well. See fast_atan for a vectorizable approximation. */
 inline Expr atan(Expr x) {
     user_assert(x.defined()) << "atan of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -995,7 +1019,7 @@ inline Expr atan(Expr x) {
 
 /** Return the angle of a floating-point gradient. If the argument is
  * not floating-point, it is cast to Float(32). Does not vectorize
- * well. */
+ * well. See fast_atan2 for a vectorizable approximation. */
 inline Expr atan2(Expr y, Expr x) {
     user_assert(x.defined() && y.defined()) << "atan2 of undefined Expr\n";
 
@@ -1070,7 +1094,8 @@ inline Expr acosh(Expr x) {
 
 /** Return the hyperbolic tangent of a floating-point expression.  If
  * the argument is not floating-point, it is cast to Float(32). Does
- * not vectorize well. */
+ * not vectorize well. See fast_tanh for a vectorizable
+ * approximation. */
 inline Expr tanh(Expr x) {
     user_assert(x.defined()) << "tanh of undefined Expr\n";
     if (x.type() == Float(64)) {
@@ -1190,15 +1215,45 @@ inline Expr erf(Expr x) {
 
 /** Fast approximate cleanly vectorizable log for Float(32). Returns
  * nonsense for x <= 0.0f. Accurate up to the last 5 bits of the
- * mantissa. Vectorizes cleanly. */
+ * mantissa. Vectorizes cleanly. For Float(64), this is a polynomial
+ * approximation accurate to about 1 ulp that handles x <= 0 like
+ * log. */
 EXPORT Expr fast_log(Expr x);
 
 /** Fast approximate cleanly vectorizable exp for Float(32). Returns
  * nonsense for inputs that would overflow or underflow. Typically
  * accurate up to the last 5 bits of the mantissa. Gets worse when
- * approaching overflow. Vectorizes cleanly. */
+ * approaching overflow. Vectorizes cleanly. For Float(64), this is a
+ * polynomial approximation accurate to about 2 ulp that saturates to
+ * inf on overflow and flushes denormal results to zero. */
 EXPORT Expr fast_exp(Expr x);
 
+/** Fast approximate cleanly vectorizable sin and cos for Float(32)
+ * or Float(64). Within 1.6 ulp (Float(32)) or 2.1 ulp (Float(64))
+ * for |x| <= pi. Beyond that the argument reduction loses precision
+ * gradually: the absolute error stays below 1e-7 for Float(32) |x| <
+ * 8192, and below 2e-16 for Float(64) |x| < 1e9. Vectorizes
+ * cleanly. */
+// @{
+EXPORT Expr fast_sin(Expr x);
+EXPORT Expr fast_cos(Expr x);
+// @}
+
+/** Fast approximate cleanly vectorizable atan for Float(32) or
+ * Float(64). Accurate to 2.9 ulp (Float(32)) or 1 ulp
+ * (Float(64)). Vectorizes cleanly. */
+EXPORT Expr fast_atan(Expr x);
+
+/** Fast approximate cleanly vectorizable atan2 for Float(32) or
+ * Float(64). Accurate to 3.2 ulp (Float(32)) or 1.8 ulp
+ * (Float(64)). Vectorizes cleanly. */
+EXPORT Expr fast_atan2(Expr y, Expr x);
+
+/** Fast approximate cleanly vectorizable tanh for Float(32) or
+ * Float(64). Accurate to 1.6 ulp (Float(32)) or 1.5 ulp
+ * (Float(64)). Vectorizes cleanly. */
+EXPORT Expr fast_tanh(Expr x);
+
 /** Fast approximate cleanly vectorizable pow for Float(32). Returns
  * nonsense for x < 0.0f. Accurate up to the last 5 bits of the
  * mantissa for typical exponents. Gets worse when approaching
@@ -95,6 +95,21 @@ ostream &operator<<(ostream &out, const DeviceAPI &api) {
     return out;
 }
 
+ostream &operator<<(ostream &out, const ParallelSchedule &schedule) {
+    switch (schedule) {
+    case ParallelSchedule::Dynamic:
+        out << "dynamic";
+        break;
+    case ParallelSchedule::Static:
+        out << "static";
+        break;
+    case ParallelSchedule::Guided:
+        out << "guided";
+        break;
+    }
+    return out;
+}
+
 ostream &operator<<(ostream &stream, const LoopLevel &loop_level) {
     return stream << "loop_level("
         << (loop_level.defined() ? loop_level.to_string() : "undefined")
@@ -200,6 +215,30 @@ ostream &operator<<(ostream &out, const ForType &type) {
     return out;
 }
 
+ostream &operator<<(ostream &out, const VectorReduce::Operator &op) {
+    switch (op) {
+    case VectorReduce::Add:
+        out << "Add";
+        break;
+    case VectorReduce::Mul:
+        out << "Mul";
+        break;
+    case VectorReduce::Min:
+        out << "Min";
+        break;
+    case VectorReduce::Max:
+        out << "Max";
+        break;
+    case VectorReduce::And:
+        out << "And";
+        break;
+    case VectorReduce::Or:
+        out << "Or";
+        break;
+    }
+    return out;
+}
+
 ostream &operator<<(ostream &out, const NameMangling &m) {
     switch(m) {
     case NameMangling::Default:
@@ -570,7 +609,12 @@ void IRPrinter::visit(const ProducerConsumer *op) {
 void IRPrinter::visit(const For *op) {
 
     do_indent();
-    stream << op->for_type << op->device_api << " (" << op->name << ", ";
+    stream << op->for_type << op->device_api;
+    if (op->for_type == ForType::Parallel &&
+        op->parallel_schedule != ParallelSchedule::Dynamic) {
+        stream << "<" << op->parallel_schedule << ">";
+    }
+    stream << " (" << op->name << ", ";
     print(op->min);
     stream << ", ";
     print(op->extent);
@@ -756,4 +800,14 @@ void IRPrinter::visit(const Shuffle *op) {
     }
 }
 
+void IRPrinter::visit(const VectorReduce *op) {
+    stream << "("
+           << op->type
+           << ")vector_reduce("
+           << op->op
+           << ", ";
+    print(op->value);
+    stream << ")";
+}
+
 }}
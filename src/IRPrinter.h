@@ -36,6 +36,9 @@ EXPORT std::ostream &operator<<(std::ostream &stream, const Module &);
 /** Emit a halide device api type in a human readable form */
 EXPORT std::ostream &operator<<(std::ostream &stream, const DeviceAPI &);
 
+/** Emit a halide parallel loop schedule in a human readable form */
+EXPORT std::ostream &operator<<(std::ostream &stream, const ParallelSchedule &);
+
 /** Emit a halide LoopLevel in a human readable form */
 EXPORT std::ostream &operator<<(std::ostream &stream, const LoopLevel &);
 
@@ -60,6 +63,9 @@ EXPORT std::ostream &operator<<(std::ostream &stream, const Stmt &);
  * readable form */
 EXPORT std::ostream &operator<<(std::ostream &stream, const ForType &);
 
+/** Emit a horizontal vector reduction operator in a human readable form */
+EXPORT std::ostream &operator<<(std::ostream &stream, const VectorReduce::Operator &);
+
 /** Emit a halide name mangling value in a human readable format */
 EXPORT std::ostream &operator<<(std::ostream &stream, const NameMangling &);
 
@@ -139,6 +145,7 @@ protected:
     void visit(const IfThenElse *);
     void visit(const Evaluate *);
     void visit(const Shuffle *);
+    void visit(const VectorReduce *);
     void visit(const Prefetch *);
 };
 }
@@ -238,6 +238,10 @@ void IRVisitor::visit(const Shuffle *op) {
     }
 }
 
+void IRVisitor::visit(const VectorReduce *op) {
+    op->value.accept(this);
+}
+
 void IRGraphVisitor::include(const Expr &e) {
     if (visited.count(e.get())) {
         return;
@@ -475,5 +479,9 @@ void IRGraphVisitor::visit(const Shuffle *op) {
     }
 }
 
+void IRGraphVisitor::visit(const VectorReduce *op) {
+    include(op->value);
+}
+
 }
 }
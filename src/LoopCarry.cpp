@@ -131,6 +131,16 @@ Expr scratch_index(int i, Type t) {
     }
 }
 
+/** Is a Stmt a Store, possibly wrapped in LetStmts? After CSE, the
+ * rows of a stencil whose outer loop has been unrolled inside the loop
+ * being carried over usually look like this. */
+bool is_store_in_lets(Stmt s) {
+    while (const LetStmt *l = s.as<LetStmt>()) {
+        s = l->body;
+    }
+    return s.as<Store>() != nullptr;
+}
+
 /** Given a scope of things that move linearly over time, come up with
  * the next time step's version of some arbitrary Expr (which may be a
  * nasty graph). Variables that move non-linearly through time are
@@ -192,9 +202,18 @@ class LoopCarryOverLoop : public IRMutator {
     const Scope<int> &in_consume;
 
     int max_carried_values;
+    int native_vector_bits;
 
     using IRMutator::visit;
 
+    // The number of registers needed to hold a value of type t.
+    int registers_for(Type t) const {
+        if (native_vector_bits <= 0 || t.is_scalar()) {
+            return 1;
+        }
+        return (t.bits() * t.lanes() + native_vector_bits - 1) / native_vector_bits;
+    }
+
     void visit(const LetStmt *op) {
         // Track containing LetStmts and their linearity w.r.t. the
         // loop variable.
@@ -223,10 +242,13 @@ class LoopCarryOverLoop : public IRMutator {
     void visit(const Block *op) {
         vector<Stmt> v = block_to_vector(op);
 
+        // Consider runs of stores together, so that a value loaded by
+        // several of them (e.g. a row of a stencil shared by unrolled
+        // iterations of an outer loop) is loaded and carried once.
         vector<Stmt> stores;
         vector<Stmt> result;
         for (size_t i = 0; i < v.size(); i++) {
-            if (v[i].as<Store>()) {
+            if (is_store_in_lets(v[i])) {
                 stores.push_back(v[i]);
             } else {
                 if (!stores.empty()) {
@@ -347,24 +369,39 @@ class LoopCarryOverLoop : public IRMutator {
             }
         }
 
-        // Only keep the top N carried values. Otherwise we'll just
-        // spray stack spills everywhere. This is ugly, because we're
-        // relying on a heuristic.
+        // Only keep as many carried values as fit in the register
+        // budget. Otherwise we'll just spray stack spills
+        // everywhere. This is ugly, because we're relying on a
+        // heuristic.
         vector<vector<int>> trimmed;
-        size_t sz = 0;
+        int used = 0;
         for (const vector<int> &c : chains) {
-            if (sz + c.size() > (size_t)max_carried_values) {
-                if (sz < (size_t)max_carried_values - 1) {
+            size_t len = 0;
+            int cost = 0;
+            while (len < c.size()) {
+                int r = registers_for(loads[c[len]][0]->type);
+                if (used + cost + r > max_carried_values) {
+                    break;
+                }
+                cost += r;
+                len++;
+            }
+            if (len < c.size()) {
+                if (len > 1) {
                     // Take a partial chain
-                    trimmed.emplace_back(c.begin(), c.begin() + max_carried_values - sz);
+                    trimmed.emplace_back(c.begin(), c.begin() + len);
                 }
                 break;
             }
             trimmed.push_back(c);
-            sz += c.size();
+            used += cost;
         }
         chains.swap(trimmed);
 
+        if (chains.empty()) {
+            return orig_stmt;
+        }
+
         // We now have chains of the form:
         // f[x] <- f[x+1] <- ... <- f[x+N-1]
 
@@ -480,8 +517,10 @@ class LoopCarryOverLoop : public IRMutator {
     }
 
 public:
-    LoopCarryOverLoop(const string &var, const Scope<int> &s, int max_carried_values)
-        : in_consume(s), max_carried_values(max_carried_values) {
+    LoopCarryOverLoop(const string &var, const Scope<int> &s,
+                      int max_carried_values, int native_vector_bits)
+        : in_consume(s), max_carried_values(max_carried_values),
+          native_vector_bits(native_vector_bits) {
         linear.push(var, 1);
     }
 
@@ -499,6 +538,7 @@ class LoopCarry : public IRMutator {
     using IRMutator::visit;
 
     int max_carried_values;
+    int native_vector_bits;
     Scope<int> in_consume;
 
     void visit(const ProducerConsumer *op) {
@@ -508,19 +548,27 @@ class LoopCarry : public IRMutator {
             in_consume.push(op->name, 0);
             Stmt body = mutate(op->body);
             in_consume.pop(op->name);
-            stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+            }
         }
     }
 
     void visit(const For *op) {
-        if (op->for_type == ForType::Serial && !is_one(op->extent)) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Leave device code to the device backends.
+            stmt = op;
+        } else if (op->for_type == ForType::Serial && !is_one(op->extent)) {
             Stmt body = mutate(op->body);
-            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values);
+            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values, native_vector_bits);
             body = carry.mutate(body);
             if (body.same_as(op->body)) {
                 stmt = op;
             } else {
-                stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+                stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
             }
 
             // Inject the scratch buffer allocations.
@@ -538,14 +586,15 @@ class LoopCarry : public IRMutator {
     }
 
 public:
-    LoopCarry(int max_carried_values) : max_carried_values(max_carried_values) {}
+    LoopCarry(int max_carried_values, int native_vector_bits)
+        : max_carried_values(max_carried_values), native_vector_bits(native_vector_bits) {}
 };
 
 }
 
 
-Stmt loop_carry(Stmt s, int max_carried_values) {
-    s = LoopCarry(max_carried_values).mutate(s);
+Stmt loop_carry(Stmt s, int max_carried_values, int native_vector_bits) {
+    s = LoopCarry(max_carried_values, native_vector_bits).mutate(s);
     return s;
 }
 
@@ -10,9 +10,18 @@ namespace Internal {
  * induction variables instead of redoing the load. If the loads are
  * predicated, the predicates need to match. Can be an optimization or
  * pessimization depending on how good the L1 cache is on the architecture
- * and how many memory issue slots there are. Currently only intended
- * for Hexagon. */
-Stmt loop_carry(Stmt, int max_carried_values = 8);
+ * and how many memory issue slots there are, so each backend chooses
+ * its own budget.
+ *
+ * Runs of stores in the loop body are considered together, so when an
+ * outer loop of a 2-D stencil has been unrolled inside the loop, rows
+ * shared by the unrolled iterations are loaded once and carried once.
+ *
+ * At most max_carried_values registers are used to hold carried
+ * values. If native_vector_bits is non-zero, a vector counts as the
+ * number of native vector registers it occupies; otherwise every value
+ * counts as one. Loops that run on a device API are left untouched. */
+EXPORT Stmt loop_carry(Stmt, int max_carried_values = 8, int native_vector_bits = 0);
 
 }
 }
@@ -18,6 +18,7 @@
 #include "Deinterleave.h"
 #include "EarlyFree.h"
 #include "FindCalls.h"
+#include "FindIntrinsics.h"
 #include "Func.h"
 #include "Function.h"
 #include "FuseGPUThreadLoops.h"
@@ -32,6 +33,7 @@
 #include "IRPrinter.h"
 #include "LoopCarry.h"
 #include "Memoization.h"
+#include "NontemporalStores.h"
 #include "PartitionLoops.h"
 #include "Prefetch.h"
 #include "Profiling.h"
@@ -203,6 +205,10 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = unpack_buffers(s);
     debug(2) << "Lowering after unpacking buffer arguments...\n";
 
+    debug(1) << "Injecting non-temporal store fences...\n";
+    s = inject_nontemporal_store_fences(s, env);
+    debug(2) << "Lowering after injecting non-temporal store fences:\n" << s << "\n\n";
+
     if (any_memoized) {
         debug(1) << "Rewriting memoized allocations...\n";
         s = rewrite_memoized_allocations(s, env);
@@ -253,7 +259,7 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     debug(2) << "Lowering after unrolling:\n" << s << "\n\n";
 
     debug(1) << "Vectorizing...\n";
-    s = vectorize_loops(s, t);
+    s = vectorize_loops(s, env, t);
     s = simplify(s);
     debug(2) << "Lowering after vectorizing:\n" << s << "\n\n";
 
@@ -305,6 +311,12 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = simplify(s);
     debug(1) << "Lowering after final simplification:\n" << s << "\n\n";
 
+    if (t.arch != Target::Hexagon) {
+        debug(1) << "Finding fixed-point intrinsics...\n";
+        s = find_intrinsics(s);
+        debug(2) << "Lowering after finding fixed-point intrinsics:\n" << s << "\n\n";
+    }
+
     debug(1) << "Splitting off Hexagon offload...\n";
     s = inject_hexagon_rpc(s, t, result_module);
     debug(2) << "Lowering after splitting off Hexagon offload:\n" << s << '\n';
@@ -458,7 +458,8 @@ void compile_multitarget(const std::string &fn_name,
             user_error << "All Targets must have matching arch-bits-os for compile_multitarget.\n";
         }
         // Some features must match across all targets.
-        static const std::array<Target::Feature, 6> must_match_features = {{
+        static const std::array<Target::Feature, 7> must_match_features = {{
+            Target::Batch,
             Target::CPlusPlusMangling,
             Target::JIT,
             Target::Matlab,
@@ -484,10 +485,10 @@ void compile_multitarget(const std::string &fn_name,
         std::string sub_fn_name = needs_wrapper ? (fn_name + suffix) : fn_name;
 
         // We always produce the runtime separately, so add NoRuntime explicitly.
-        // Matlab should be added to the wrapper pipeline below, instead of each sub-pipeline.
+        // Matlab and Batch should be added to the wrapper pipeline below, instead of each sub-pipeline.
         Target sub_fn_target = target.with_feature(Target::NoRuntime);
         if (needs_wrapper) {
-            sub_fn_target = sub_fn_target.without_feature(Target::Matlab);
+            sub_fn_target = sub_fn_target.without_feature(Target::Matlab).without_feature(Target::Batch);
         }
 
         Module sub_module = module_producer(sub_fn_name, sub_fn_target);
@@ -0,0 +1,91 @@
+#include "NontemporalStores.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Function.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+class InjectNontemporalStoreFences : public IRMutator {
+    const map<string, Function> &env;
+
+    // The fence for the innermost enclosing producer of a Func with
+    // non-temporal stores, or undefined if there isn't one.
+    Stmt fence;
+
+    using IRMutator::visit;
+
+    void visit(const ProducerConsumer *op) {
+        if (!op->is_producer) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        auto it = env.find(op->name);
+        if (it == env.end() || !it->second.schedule().nontemporal_stores()) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        const Function &f = it->second;
+        vector<Expr> buffers;
+        if (f.outputs() == 1) {
+            buffers.push_back(StringImm::make(f.name()));
+        } else {
+            for (int i = 0; i < f.outputs(); i++) {
+                buffers.push_back(StringImm::make(f.name() + "." + std::to_string(i)));
+            }
+        }
+
+        Stmt old_fence = fence;
+        fence = Evaluate::make(Call::make(Int(32), Call::nontemporal_store_fence,
+                                          buffers, Call::Intrinsic));
+        Stmt body = mutate(op->body);
+        body = Block::make(body, fence);
+        fence = old_fence;
+
+        stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+    }
+
+    void visit(const For *op) {
+        if (!fence.defined()) {
+            IRMutator::visit(op);
+        } else if (op->device_api != DeviceAPI::None &&
+                   op->device_api != DeviceAPI::Host) {
+            // Stores in offloaded loops are left alone.
+            Stmt old_fence = fence;
+            fence = Stmt();
+            IRMutator::visit(op);
+            fence = old_fence;
+        } else if (op->for_type == ForType::Parallel) {
+            // A streaming store is only ordered with respect to
+            // other stores by a fence on the same thread, so each
+            // parallel task must issue its own.
+            Stmt body = mutate(op->body);
+            body = Block::make(body, fence);
+            stmt = For::make(op->name, op->min, op->extent,
+                             op->for_type, op->device_api, body,
+                             op->parallel_schedule);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    InjectNontemporalStoreFences(const map<string, Function> &e) : env(e) {}
+};
+
+}
+
+Stmt inject_nontemporal_store_fences(Stmt s, const map<string, Function> &env) {
+    return InjectNontemporalStoreFences(env).mutate(s);
+}
+
+}
+}
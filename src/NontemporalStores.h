@@ -0,0 +1,27 @@
+#ifndef HALIDE_NONTEMPORAL_STORES_H
+#define HALIDE_NONTEMPORAL_STORES_H
+
+/** \file
+ * Defines the lowering pass that marks the buffers of Funcs scheduled
+ * with Func::store_nontemporal and fences their streaming stores.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** For each Func scheduled with store_nontemporal, append a
+ * nontemporal_store_fence intrinsic naming its (flattened) buffers to
+ * the end of its producer, and to the end of each parallel loop body
+ * within that producer. Codegen uses the presence of the fence to
+ * decide which stores may bypass the cache. Must run after storage
+ * flattening. */
+Stmt inject_nontemporal_store_fences(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
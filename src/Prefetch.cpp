@@ -249,7 +249,7 @@ private:
         }
 
         if (!body.same_as(op->body)) {
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
         } else {
             stmt = op;
         }
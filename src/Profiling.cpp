@@ -254,7 +254,7 @@ private:
             body = op->body;
         }
 
-        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
 
         if (update_active_threads) {
             stmt = Block::make({decr_active_threads, stmt, incr_active_threads});
@@ -126,10 +126,14 @@ struct FuncScheduleContents {
     std::vector<Bound> estimates;
     std::map<std::string, Internal::FunctionPtr> wrappers;
     bool memoized;
+    int sliding_window_strips;
+    bool compute_ahead;
+    bool nontemporal_stores;
 
     FuncScheduleContents() :
         store_level(LoopLevel::inlined()), compute_level(LoopLevel::inlined()),
-        memoized(false) {};
+        memoized(false), sliding_window_strips(0), compute_ahead(false),
+        nontemporal_stores(false) {};
 
     // Pass an IRMutator through to all Exprs referenced in the FuncScheduleContents
     void mutate(IRMutator *mutator) {
@@ -236,6 +240,9 @@ FuncSchedule FuncSchedule::deep_copy(
     copy.contents->bounds = contents->bounds;
     copy.contents->estimates = contents->estimates;
     copy.contents->memoized = contents->memoized;
+    copy.contents->sliding_window_strips = contents->sliding_window_strips;
+    copy.contents->compute_ahead = contents->compute_ahead;
+    copy.contents->nontemporal_stores = contents->nontemporal_stores;
 
     // Deep-copy wrapper functions.
     for (const auto &iter : contents->wrappers) {
@@ -255,6 +262,30 @@ bool FuncSchedule::memoized() const {
     return contents->memoized;
 }
 
+int &FuncSchedule::sliding_window_strips() {
+    return contents->sliding_window_strips;
+}
+
+int FuncSchedule::sliding_window_strips() const {
+    return contents->sliding_window_strips;
+}
+
+bool &FuncSchedule::compute_ahead() {
+    return contents->compute_ahead;
+}
+
+bool FuncSchedule::compute_ahead() const {
+    return contents->compute_ahead;
+}
+
+bool &FuncSchedule::nontemporal_stores() {
+    return contents->nontemporal_stores;
+}
+
+bool FuncSchedule::nontemporal_stores() const {
+    return contents->nontemporal_stores;
+}
+
 std::vector<StorageDim> &FuncSchedule::storage_dims() {
     return contents->storage_dims;
 }
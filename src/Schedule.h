@@ -63,6 +63,19 @@ enum class TailStrategy {
      * instead of a multiple of the split factor as with RoundUp. */
     ShiftInwards,
 
+    /** Guard the inner loop with an if statement, as with
+     * GuardWithIf, and if the inner loop is vectorized, always
+     * handle the tail case with predicated (masked) vector loads and
+     * stores rather than scalarizing it, even on targets where the
+     * vectorizer would not otherwise consider predication
+     * worthwhile. Always legal. Pros: no redundant re-evaluation;
+     * does not constrain input or output sizes; the tail stays
+     * vectorized. Cons: on targets without native masked loads and
+     * stores (e.g. ARM) the masked loads and stores in the tail are
+     * still done one lane at a time; not supported by the C
+     * backend or by GPU kernels. */
+    Predicate,
+
     /** For pure definitions use ShiftInwards. For pure vars in
      * update definitions use RoundUp. For RVars in update
      * definitions use GuardWithIf. */
@@ -171,7 +184,7 @@ struct Split {
     Expr factor;
     bool exact; // Is it required that the factor divides the extent
                 // of the old var. True for splits of RVars. Forces
-                // tail strategy to be GuardWithIf.
+                // tail strategy to be GuardWithIf or Predicate.
     TailStrategy tail;
 
     enum SplitType {SplitVar = 0, RenameVar, FuseVars, PurifyRVar};
@@ -204,6 +217,10 @@ struct Dim {
     enum Type {PureVar = 0, PureRVar, ImpureRVar};
     Type dim_type;
 
+    /** How the iterations are handed out to threads, if the dimension
+     * is parallel. */
+    ParallelSchedule parallel_schedule;
+
     bool is_pure() const {return (dim_type == PureVar) || (dim_type == PureRVar);}
     bool is_rvar() const {return (dim_type == PureRVar) || (dim_type == ImpureRVar);}
     bool is_parallel() const {
@@ -267,6 +284,32 @@ public:
     bool memoized() const;
     // @}
 
+    /** The maximum number of strips a parallel loop between the
+     * store level and the compute level of this function may be
+     * split into so that each strip can do a sliding window
+     * independently. Zero means parallel loops are left alone. See
+     * \ref Func::slide_in_strips */
+    // @{
+    int &sliding_window_strips();
+    int sliding_window_strips() const;
+    // @}
+
+    /** This flag is set to true if each iteration of the loop this
+     * function is computed at should compute the region required by
+     * the next iteration instead. See \ref Func::compute_ahead */
+    // @{
+    bool &compute_ahead();
+    bool compute_ahead() const;
+    // @}
+
+    /** This flag is set to true if vectorized stores to this
+     * function's buffer should bypass the cache hierarchy. See \ref
+     * Func::store_nontemporal */
+    // @{
+    bool &nontemporal_stores();
+    bool nontemporal_stores() const;
+    // @}
+
     /** The list and order of dimensions used to store this
      * function. The first dimension in the vector corresponds to the
      * innermost dimension for storage (i.e. which dimension is
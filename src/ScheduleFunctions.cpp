@@ -211,7 +211,7 @@ Stmt build_provide_loop_nest_helper(string func_name,
             const Dim &dim = stage_s.dims()[nest[i].dim_idx];
             Expr min = Variable::make(Int(32), nest[i].name + ".loop_min");
             Expr extent = Variable::make(Int(32), nest[i].name + ".loop_extent");
-            stmt = For::make(nest[i].name, min, extent, dim.for_type, dim.device_api, stmt);
+            stmt = For::make(nest[i].name, min, extent, dim.for_type, dim.device_api, stmt, dim.parallel_schedule);
         }
     }
 
@@ -817,7 +817,8 @@ private:
                              for_loop->extent,
                              for_loop->for_type,
                              for_loop->device_api,
-                             body);
+                             body,
+                             for_loop->parallel_schedule);
         }
     }
 
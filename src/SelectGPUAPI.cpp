@@ -27,7 +27,7 @@ class SelectGPUAPI : public IRMutator {
         internal_assert(op);
 
         if (op->device_api != selected_api) {
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, selected_api, op->body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, selected_api, op->body, op->parallel_schedule);
         }
     }
 public:
@@ -4591,6 +4591,31 @@ private:
         }
     }
 
+    void visit(const VectorReduce *op) {
+        Expr value = mutate(op->value);
+        int lanes = op->type.lanes();
+        int factor = value.type().lanes() / lanes;
+        const Broadcast *b = value.as<Broadcast>();
+        if (factor == 1) {
+            expr = value;
+        } else if (b && op->op != VectorReduce::Mul) {
+            // Reducing a broadcast. Min, max, and, and or of
+            // identical lanes are all that lane.
+            Expr v = b->value;
+            if (op->op == VectorReduce::Add) {
+                v = mutate(v * factor);
+            }
+            if (lanes > 1) {
+                v = Broadcast::make(v, lanes);
+            }
+            expr = v;
+        } else if (value.same_as(op->value)) {
+            expr = op;
+        } else {
+            expr = VectorReduce::make(op->op, value, lanes);
+        }
+    }
+
     void visit(const Shuffle *op) {
         if (op->is_extract_element() &&
             (op->vectors[0].as<Ramp>() ||
@@ -5100,7 +5125,7 @@ private:
             op->body.same_as(new_body)) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, new_min, new_extent, op->for_type, op->device_api, new_body);
+            stmt = For::make(op->name, new_min, new_extent, op->for_type, op->device_api, new_body, op->parallel_schedule);
         }
     }
 
@@ -78,11 +78,13 @@ Expr expand_expr(Expr e, const Scope<Expr> &scope) {
 }
 
 // Perform sliding window optimization for a function over a
-// particular serial for loop
+// particular serial for loop. If lookahead is set, each iteration
+// instead computes the values the next iteration will need.
 class SlidingWindowOnFunctionAndLoop : public IRMutator {
     Function func;
     string loop_var;
-    Expr loop_min;
+    Expr loop_min, loop_extent;
+    bool lookahead;
     Scope<Expr> scope;
 
     map<string, Expr> replacements;
@@ -221,9 +223,11 @@ class SlidingWindowOnFunctionAndLoop : public IRMutator {
             Expr prev_max_plus_one = substitute(loop_var, loop_var_expr - 1, max_required) + 1;
             Expr prev_min_minus_one = substitute(loop_var, loop_var_expr - 1, min_required) - 1;
 
-            // If there's no overlap between adjacent iterations, we shouldn't slide.
-            if (can_prove(min_required >= prev_max_plus_one) ||
-                can_prove(max_required <= prev_min_minus_one)) {
+            // If there's no overlap between adjacent iterations, we
+            // shouldn't slide. Computing ahead is still worthwhile.
+            if (!lookahead &&
+                (can_prove(min_required >= prev_max_plus_one) ||
+                 can_prove(max_required <= prev_min_minus_one))) {
                 debug(3) << "Not sliding " << func.name()
                          << " over dimension " << dim
                          << " along loop variable " << loop_var
@@ -233,8 +237,33 @@ class SlidingWindowOnFunctionAndLoop : public IRMutator {
                 return;
             }
 
-            Expr new_min, new_max;
+            // Record how much of the function is computed on the
+            // first iteration, and how much on each subsequent
+            // iteration, so that callers can weigh the cost of
+            // restarting the window.
+            footprint = simplify(max_required - min_required + 1);
             if (can_slide_up) {
+                step = simplify(max_required - prev_max_plus_one + 1);
+            } else {
+                step = simplify(prev_min_minus_one - min_required + 1);
+            }
+
+            Expr new_min, new_max;
+            if (lookahead) {
+                // Everything up to the end of the region required by
+                // this iteration was computed by previous iterations
+                // (or below on the first one). Extend it to cover the
+                // next iteration. The last iteration computes nothing.
+                Expr loop_max = loop_min + loop_extent - 1;
+                Expr next_loop_var_expr = min(loop_var_expr + 1, loop_max);
+                if (can_slide_up) {
+                    new_min = select(loop_var_expr <= loop_min, min_required, likely_if_innermost(max_required + 1));
+                    new_max = substitute(loop_var, next_loop_var_expr, max_required);
+                } else {
+                    new_min = substitute(loop_var, next_loop_var_expr, min_required);
+                    new_max = select(loop_var_expr <= loop_min, max_required, likely_if_innermost(min_required - 1));
+                }
+            } else if (can_slide_up) {
                 new_min = select(loop_var_expr <= loop_min, min_required, likely_if_innermost(prev_max_plus_one));
                 new_max = max_required;
             } else {
@@ -250,9 +279,10 @@ class SlidingWindowOnFunctionAndLoop : public IRMutator {
                      << "Shrinking max from " << max_required << " to " << new_max << "\n";
 
             // Now redefine the appropriate regions required
-            if (can_slide_up) {
+            if (can_slide_up || lookahead) {
                 replacements[prefix + dim + ".min"] = new_min;
-            } else {
+            }
+            if (!can_slide_up || lookahead) {
                 replacements[prefix + dim + ".max"] = new_max;
             }
 
@@ -295,7 +325,7 @@ class SlidingWindowOnFunctionAndLoop : public IRMutator {
             // Unpack it back into the for
             const LetStmt *l = s.as<LetStmt>();
             internal_assert(l);
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, l->body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, l->body, op->parallel_schedule);
         } else if (is_monotonic(min, loop_var) != Monotonic::Constant ||
                    is_monotonic(extent, loop_var) != Monotonic::Constant) {
             debug(3) << "Not entering loop over " << op->name
@@ -329,7 +359,13 @@ class SlidingWindowOnFunctionAndLoop : public IRMutator {
     }
 
 public:
-    SlidingWindowOnFunctionAndLoop(Function f, string v, Expr v_min) : func(f), loop_var(v), loop_min(v_min) {}
+    SlidingWindowOnFunctionAndLoop(Function f, string v, Expr v_min, Expr v_extent, bool lookahead)
+        : func(f), loop_var(v), loop_min(v_min), loop_extent(v_extent), lookahead(lookahead) {}
+
+    // If sliding occurred, the extent of the region computed on the
+    // first iteration of the loop along the slid dimension, and the
+    // extent computed on each subsequent iteration.
+    Expr footprint, step;
 };
 
 // Perform sliding window optimization for a particular function
@@ -339,6 +375,56 @@ class SlidingWindowOnFunction : public IRMutator {
 
     using IRMutator::visit;
 
+    // Split a parallel loop into strips that run in parallel, each of
+    // which slides serially over its own part of the loop. Returns an
+    // undefined Stmt if the function can't slide along the loop.
+    Stmt slide_in_strips(const For *op, Stmt body, bool lookahead) {
+        string strip_name = op->name + ".strip";
+        string strip_min_name = op->name + ".strip_min";
+        string strip_size_name = op->name + ".strip_size";
+        Expr strip = Variable::make(Int(32), strip_name);
+        Expr strip_min = Variable::make(Int(32), strip_min_name);
+        Expr strip_size = Variable::make(Int(32), strip_size_name);
+
+        Expr loop_max_plus_one = op->min + op->extent;
+        Expr strip_extent = min(strip_size, loop_max_plus_one - strip_min);
+
+        SlidingWindowOnFunctionAndLoop slider(func, op->name, strip_min, strip_extent, lookahead);
+        Stmt new_body = slider.mutate(body);
+        if (new_body.same_as(body)) {
+            return Stmt();
+        }
+
+        // Keep the strips at least one iteration long, so that an
+        // empty loop doesn't divide by zero when counting the strips.
+        int max_strips = func.schedule().sliding_window_strips();
+        Expr size = max((op->extent + (max_strips - 1)) / max_strips, 1);
+
+        // The first iteration of each strip recomputes (footprint -
+        // step) values that the previous strip already has. If the
+        // footprint is known, make the strips long enough that this
+        // is at most an eighth of the steady-state work of the strip.
+        const int64_t *footprint = as_const_int(slider.footprint);
+        const int64_t *step = as_const_int(slider.step);
+        if (footprint && step && *step > 0 && *footprint > *step) {
+            int64_t min_size = (8 * (*footprint - *step) + *step - 1) / *step;
+            debug(3) << "Strips of " << func.name() << " over " << op->name
+                     << " must be at least " << min_size << " long\n";
+            size = max(size, (int)min_size);
+        }
+
+        Expr num_strips = (op->extent + strip_size - 1) / strip_size;
+
+        Stmt s = For::make(op->name, strip_min, strip_extent,
+                           ForType::Serial, op->device_api, new_body);
+        s = LetStmt::make(strip_min_name, op->min + strip * strip_size, s);
+        s = For::make(strip_name, 0, num_strips, op->for_type, op->device_api, s, op->parallel_schedule);
+        s = LetStmt::make(strip_size_name, size, s);
+
+        debug(3) << "Sliding " << func.name() << " in parallel strips of " << op->name << "\n";
+        return s;
+    }
+
     void visit(const For *op) {
         debug(3) << " Doing sliding window analysis over loop: " << op->name << "\n";
 
@@ -346,20 +432,41 @@ class SlidingWindowOnFunction : public IRMutator {
 
         new_body = mutate(new_body);
 
-        if (op->for_type == ForType::Serial ||
-            op->for_type == ForType::Unrolled) {
-            new_body = SlidingWindowOnFunctionAndLoop(func, op->name, op->min).mutate(new_body);
+        // A function computed ahead only does so over the loop
+        // it is computed at, and doesn't slide over any other loop.
+        const FuncSchedule &sched = func.schedule();
+        bool lookahead = sched.compute_ahead() && sched.compute_level().match(op->name);
+        bool can_slide = lookahead || !sched.compute_ahead();
+
+        if (can_slide &&
+            (op->for_type == ForType::Serial ||
+             op->for_type == ForType::Unrolled)) {
+            Stmt b = SlidingWindowOnFunctionAndLoop(func, op->name, op->min, op->extent, lookahead).mutate(new_body);
+            computed_ahead = computed_ahead || (lookahead && !b.same_as(new_body));
+            new_body = b;
+        } else if (can_slide &&
+                   op->for_type == ForType::Parallel &&
+                   sched.sliding_window_strips() > 0) {
+            Stmt s = slide_in_strips(op, new_body, lookahead);
+            if (s.defined()) {
+                computed_ahead = computed_ahead || lookahead;
+                stmt = s;
+                return;
+            }
         }
 
         if (new_body.same_as(op->body)) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, new_body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, new_body, op->parallel_schedule);
         }
     }
 
 public:
-    SlidingWindowOnFunction(Function f) : func(f) {}
+    SlidingWindowOnFunction(Function f) : func(f), computed_ahead(false) {}
+
+    // Whether the function was computed ahead over the loop it is computed at.
+    bool computed_ahead;
 };
 
 // Perform sliding window optimization for all functions
@@ -383,6 +490,10 @@ class SlidingWindow : public IRMutator {
         // as its store_at level, skip it.
         const FuncSchedule &sched = iter->second.schedule();
         if (sched.compute_level() == sched.store_level()) {
+            if (sched.compute_ahead()) {
+                user_warning << "Could not compute " << op->name
+                             << " ahead, because it is stored at the same loop level it is computed at.\n";
+            }
             IRMutator::visit(op);
             return;
         }
@@ -391,7 +502,14 @@ class SlidingWindow : public IRMutator {
 
         debug(3) << "Doing sliding window analysis on realization of " << op->name << "\n";
 
-        new_body = SlidingWindowOnFunction(iter->second).mutate(new_body);
+        SlidingWindowOnFunction slider(iter->second);
+        new_body = slider.mutate(new_body);
+
+        if (sched.compute_ahead() && !slider.computed_ahead) {
+            user_warning << "Could not compute " << op->name
+                         << " ahead, because its footprint does not move monotonically along"
+                         << " exactly one dimension over the loop it is computed at.\n";
+        }
 
         new_body = mutate(new_body);
 
@@ -589,6 +589,18 @@ private:
         stream << close_span();
     }
 
+    void visit(const VectorReduce *op) {
+        stream << open_span("VectorReduce");
+        stream << open_span("Type") << op->type << close_span();
+        stream << open_span("Matched");
+        stream << symbol("vector_reduce") << "(";
+        stream << close_span();
+        stream << op->op << ", ";
+        print(op->value);
+        stream << matched(")");
+        stream << close_span();
+    }
+
 public:
     void print(Expr ir) {
         ir.accept(this);
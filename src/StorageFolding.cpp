@@ -434,7 +434,7 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                         // for further folding opportinities
                         // recursively.
                     } else if (!body.same_as(op->body)) {
-                        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+                        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
                         if (!dynamic_footprint.empty()) {
                             Expr init_val;
                             if (min_monotonic_increasing) {
@@ -469,7 +469,7 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
         if (body.same_as(op->body)) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
         }
     }
 
@@ -77,7 +77,7 @@ public:
             new_body.same_as(op->body)) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, new_min, new_extent, op->for_type, op->device_api, new_body);
+            stmt = For::make(op->name, new_min, new_extent, op->for_type, op->device_api, new_body, op->parallel_schedule);
         }
     }
 
@@ -134,6 +134,7 @@ Target calculate_host_target() {
         const uint32_t avx512bw = 1U << 30;
         const uint32_t avx512vl = 1U << 31;
         const uint32_t avx512ifma = 1U << 21;
+        const uint32_t avx512vnni = 1U << 11; // In ecx, not ebx
         const uint32_t avx512 = avx512f | avx512cd;
         const uint32_t avx512_knl = avx512 | avx512pf | avx512er;
         const uint32_t avx512_skylake = avx512 | avx512vl | avx512bw | avx512dq;
@@ -152,6 +153,9 @@ Target calculate_host_target() {
             if ((info2[1] & avx512_cannonlake) == avx512_cannonlake) {
                 initial_features.push_back(Target::AVX512_Cannonlake);
             }
+            if ((info2[2] & avx512vnni) == avx512vnni) {
+                initial_features.push_back(Target::AVX512_VNNI);
+            }
         }
     }
 #ifdef _WIN32
@@ -266,6 +270,9 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"trace_loads", Target::TraceLoads},
     {"trace_stores", Target::TraceStores},
     {"trace_realizations", Target::TraceRealizations},
+    {"avx512_vnni", Target::AVX512_VNNI},
+    {"arm_dot_prod", Target::ARMDotProd},
+    {"batch", Target::Batch},
 };
 
 bool lookup_feature(const std::string &tok, Target::Feature &result) {
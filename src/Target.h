@@ -85,6 +85,9 @@ struct Target {
         TraceLoads = halide_target_feature_trace_loads,
         TraceStores = halide_target_feature_trace_stores,
         TraceRealizations = halide_target_feature_trace_realizations,
+        AVX512_VNNI = halide_target_feature_avx512_vnni,
+        ARMDotProd = halide_target_feature_arm_dot_prod,
+        Batch = halide_target_feature_batch,
         FeatureEnd = halide_target_feature_end
     };
     Target() : os(OSUnknown), arch(ArchUnknown), bits(0) {}
@@ -322,7 +322,7 @@ class SimplifyUsingBounds : public IRMutator {
         containing_loops.push_back({op->name, {min, min + extent - 1}});
         Stmt body = mutate(op->body);
         containing_loops.pop_back();
-        stmt = For::make(op->name, min, extent, op->for_type, op->device_api, body);
+        stmt = For::make(op->name, min, extent, op->for_type, op->device_api, body, op->parallel_schedule);
     }
 public:
     SimplifyUsingBounds(const string &v, const Interval &i) {
@@ -360,7 +360,7 @@ class TrimNoOps : public IRMutator {
             return;
         } else if (is_zero(is_no_op.condition)) {
             // This loop is definitely needed
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
             return;
         }
 
@@ -373,7 +373,7 @@ class TrimNoOps : public IRMutator {
 
         if (i.is_everything()) {
             // Nope.
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body, op->parallel_schedule);
             return;
         }
 
@@ -416,7 +416,7 @@ class TrimNoOps : public IRMutator {
 
         Expr new_extent = new_max_var - new_min_var;
 
-        stmt = For::make(op->name, new_min_var, new_extent, op->for_type, op->device_api, body);
+        stmt = For::make(op->name, new_min_var, new_extent, op->for_type, op->device_api, body, op->parallel_schedule);
         stmt = LetStmt::make(new_max_name, new_max, stmt);
         stmt = LetStmt::make(new_min_name, new_min, stmt);
         stmt = LetStmt::make(old_max_name, old_max, stmt);
@@ -86,7 +86,7 @@ class UniquifyVariableNames : public IRMutator {
             extent.same_as(op->extent)) {
             stmt = op;
         } else {
-            stmt = For::make(new_name, min, extent, op->for_type, op->device_api, body);
+            stmt = For::make(new_name, min, extent, op->for_type, op->device_api, body, op->parallel_schedule);
         }
     }
 
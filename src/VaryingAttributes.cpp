@@ -136,7 +136,7 @@ protected:
         if (mutated_body.same_as(op->body)) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, mutated_body);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, mutated_body, op->parallel_schedule);
         }
     }
 
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 
 #include "VectorizeLoops.h"
 #include "IRMutator.h"
@@ -13,10 +14,13 @@
 #include "Simplify.h"
 #include "CSE.h"
 #include "CodeGen_GPU_Dev.h"
+#include "Function.h"
 
 namespace Halide {
 namespace Internal {
 
+using std::map;
+using std::set;
 using std::string;
 using std::vector;
 using std::pair;
@@ -231,11 +235,55 @@ bool uses_gpu_vars(Expr s) {
     return uses.uses_gpu;
 }
 
+class LoadsFromBuffer : public IRVisitor {
+private:
+    using IRVisitor::visit;
+    void visit(const Load *op) {
+        if (op->name == buffer) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+public:
+    const string &buffer;
+    bool result = false;
+
+    LoadsFromBuffer(const string &b) : buffer(b) {}
+};
+
+bool loads_from_buffer(Expr e, const string &buffer) {
+    LoadsFromBuffer loads(buffer);
+    e.accept(&loads);
+    return loads.result;
+}
+
+// The value that doesn't change the result of a reduction.
+Expr reduction_identity(VectorReduce::Operator op, Type t) {
+    switch (op) {
+    case VectorReduce::Add:
+        return make_zero(t);
+    case VectorReduce::Mul:
+        return make_one(t);
+    case VectorReduce::Min:
+        return t.is_float() ? make_const(t, std::numeric_limits<double>::infinity()) : t.max();
+    case VectorReduce::Max:
+        return t.is_float() ? make_const(t, -std::numeric_limits<double>::infinity()) : t.min();
+    case VectorReduce::And:
+        return const_true(t.lanes());
+    case VectorReduce::Or:
+        return const_false(t.lanes());
+    }
+    return Expr();
+}
+
 // Wrap a vectorized predicate around a Load/Store node.
 class PredicateLoadStore : public IRMutator {
     string var;
     Expr vector_predicate;
     bool in_hexagon;
+    // Predicate loads and stores of any type, because the schedule
+    // asked for it with TailStrategy::Predicate.
+    bool force;
     const Target &target;
     int lanes;
     bool valid;
@@ -248,7 +296,22 @@ class PredicateLoadStore : public IRMutator {
             internal_assert(target.features_any_of({Target::HVX_64, Target::HVX_128}))
                 << "We are inside a hexagon loop, but the target doesn't have hexagon's features\n";
             return true;
+        } else if (force) {
+            // Bools are stored as bytes, so can't be masked.
+            return bit_size >= 8;
         } else if (target.arch == Target::X86) {
+            // AVX-512BW has mask registers for every element size, and
+            // the rest of AVX-512 for 32 and 64-bit elements.
+            if (target.has_feature(Target::AVX512_Skylake) ||
+                target.has_feature(Target::AVX512_Cannonlake)) {
+                return bit_size >= 8;
+            } else if (target.has_feature(Target::AVX512) ||
+                       target.has_feature(Target::AVX512_KNL)) {
+                return bit_size >= 32;
+            } else if (target.has_feature(Target::AVX)) {
+                // vmaskmovps/pd and the AVX2 vpmaskmovd/q
+                return bit_size >= 32;
+            }
             // Should only attempt to predicate store/load if the lane size is
             // no less than 4
             return (bit_size == 32) && (lanes >= 4);
@@ -331,6 +394,21 @@ class PredicateLoadStore : public IRMutator {
         vectorized = true;
     }
 
+    void visit(const VectorReduce *op) {
+        Expr value = mutate(op->value);
+        if (!valid || value.type().lanes() != lanes) {
+            valid = false;
+            expr = op;
+            return;
+        }
+        // Lanes for which the predicate is false must not contribute
+        // to the reduction.
+        Expr identity = reduction_identity(op->op, value.type().element_of());
+        value = Select::make(vector_predicate, value, Broadcast::make(identity, lanes));
+        expr = VectorReduce::make(op->op, value, op->type.lanes());
+        vectorized = true;
+    }
+
     void visit(const Call *op) {
         // We should not vectorize calls with side-effects
         valid = valid && op->is_pure();
@@ -338,8 +416,8 @@ class PredicateLoadStore : public IRMutator {
     }
 
 public:
-    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, const Target &t) :
-            var(v), vector_predicate(vpred), in_hexagon(in_hexagon), target(t),
+    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, bool force, const Target &t) :
+            var(v), vector_predicate(vpred), in_hexagon(in_hexagon), force(force), target(t),
             lanes(vpred.type().lanes()), valid(true), vectorized(false) {
         internal_assert(lanes > 1);
     }
@@ -362,6 +440,9 @@ class VectorSubs : public IRMutator {
 
     bool in_hexagon; // Are we inside the hexagon loop?
 
+    // Does this loop come from a stage split with TailStrategy::Predicate?
+    bool predicate_tail;
+
     // A suffix to attach to widened variables.
     string widening_suffix;
 
@@ -651,6 +732,89 @@ class VectorSubs : public IRMutator {
         }
     }
 
+    // Is e a (broadcast) load of the given scalar location?
+    bool is_load_of(Expr e, const string &name, Expr index) {
+        if (const Broadcast *b = e.as<Broadcast>()) {
+            e = b->value;
+        }
+        const Load *load = e.as<Load>();
+        return (load && load->name == name &&
+                is_one(load->predicate) &&
+                equal(load->index, index));
+    }
+
+    // A store of a vector to a scalar location, where the value
+    // combines the old value at that location with something else,
+    // is a reduction over the lanes. E.g. f(x) += g(r) with r
+    // vectorized. Rewrite the value to combine the old value with a
+    // horizontal reduction of the vector.
+    Expr reduce_across_lanes(const string &name, Expr index, Expr value) {
+        VectorReduce::Operator reduce_op;
+        Expr a, b;
+        bool subtract = false;
+        if (const Add *op = value.as<Add>()) {
+            reduce_op = VectorReduce::Add;
+            a = op->a;
+            b = op->b;
+        } else if (const Sub *op = value.as<Sub>()) {
+            // f - g_0 - g_1 - ... is f - (g_0 + g_1 + ...)
+            reduce_op = VectorReduce::Add;
+            a = op->a;
+            b = op->b;
+            subtract = true;
+        } else if (const Mul *op = value.as<Mul>()) {
+            reduce_op = VectorReduce::Mul;
+            a = op->a;
+            b = op->b;
+        } else if (const Min *op = value.as<Min>()) {
+            reduce_op = VectorReduce::Min;
+            a = op->a;
+            b = op->b;
+        } else if (const Max *op = value.as<Max>()) {
+            reduce_op = VectorReduce::Max;
+            a = op->a;
+            b = op->b;
+        } else if (const And *op = value.as<And>()) {
+            reduce_op = VectorReduce::And;
+            a = op->a;
+            b = op->b;
+        } else if (const Or *op = value.as<Or>()) {
+            reduce_op = VectorReduce::Or;
+            a = op->a;
+            b = op->b;
+        } else {
+            return Expr();
+        }
+
+        if (!subtract && !is_load_of(a, name, index)) {
+            std::swap(a, b);
+        }
+        if (!is_load_of(a, name, index) || loads_from_buffer(b, name)) {
+            return Expr();
+        }
+
+        Expr old_value = a;
+        if (const Broadcast *bc = a.as<Broadcast>()) {
+            old_value = bc->value;
+        }
+        Expr reduced = VectorReduce::make(reduce_op, b, 1);
+        switch (reduce_op) {
+        case VectorReduce::Add:
+            return subtract ? old_value - reduced : old_value + reduced;
+        case VectorReduce::Mul:
+            return old_value * reduced;
+        case VectorReduce::Min:
+            return Min::make(old_value, reduced);
+        case VectorReduce::Max:
+            return Max::make(old_value, reduced);
+        case VectorReduce::And:
+            return old_value && reduced;
+        case VectorReduce::Or:
+            return old_value || reduced;
+        }
+        return Expr();
+    }
+
     void visit(const Store *op) {
         Expr predicate = mutate(op->predicate);
         Expr value = mutate(op->value);
@@ -658,6 +822,19 @@ class VectorSubs : public IRMutator {
 
         if (predicate.same_as(op->predicate) && value.same_as(op->value) && index.same_as(op->index)) {
             stmt = op;
+        } else if (value.type().is_vector() &&
+                   index.type().is_scalar() &&
+                   predicate.type().is_scalar() &&
+                   loads_from_buffer(value, op->name)) {
+            Expr reduced = reduce_across_lanes(op->name, index, value);
+            if (reduced.defined()) {
+                stmt = Store::make(op->name, reduced, index, op->param, predicate);
+            } else {
+                // Every lane would read the same old value and write
+                // back to the same place. Do the lanes one at a time
+                // instead.
+                stmt = scalarize(op);
+            }
         } else {
             int lanes = std::max(predicate.type().lanes(), std::max(value.type().lanes(), index.type().lanes()));
             stmt = Store::make(op->name, widen(value, lanes), widen(index, lanes),
@@ -691,12 +868,12 @@ class VectorSubs : public IRMutator {
             bool vectorize_predicate = !uses_gpu_vars(cond);
             Stmt predicated_stmt;
             if (vectorize_predicate) {
-                PredicateLoadStore p(var, cond, in_hexagon, target);
+                PredicateLoadStore p(var, cond, in_hexagon, predicate_tail, target);
                 predicated_stmt = p.mutate(then_case);
                 vectorize_predicate = p.is_vectorized();
             }
             if (vectorize_predicate && else_case.defined()) {
-                PredicateLoadStore p(var, !cond, in_hexagon, target);
+                PredicateLoadStore p(var, !cond, in_hexagon, predicate_tail, target);
                 predicated_stmt = Block::make(predicated_stmt, p.mutate(else_case));
                 vectorize_predicate = p.is_vectorized();
             }
@@ -780,7 +957,7 @@ class VectorSubs : public IRMutator {
             // Rebase the loop to zero and try again
             Expr var = Variable::make(Int(32), op->name);
             Stmt body = substitute(op->name, var + op->min, op->body);
-            Stmt transformed = For::make(op->name, 0, op->extent, for_type, op->device_api, body);
+            Stmt transformed = For::make(op->name, 0, op->extent, for_type, op->device_api, body, op->parallel_schedule);
             stmt = mutate(transformed);
             return;
         }
@@ -803,7 +980,7 @@ class VectorSubs : public IRMutator {
             for_type == op->for_type) {
             stmt = op;
         } else {
-            stmt = For::make(op->name, min, extent, for_type, op->device_api, body);
+            stmt = For::make(op->name, min, extent, for_type, op->device_api, body, op->parallel_schedule);
         }
     }
 
@@ -907,8 +1084,8 @@ class VectorSubs : public IRMutator {
     }
 
 public:
-    VectorSubs(string v, Expr r, bool in_hexagon, const Target &t) :
-            var(v), replacement(r), target(t), in_hexagon(in_hexagon) {
+    VectorSubs(string v, Expr r, bool in_hexagon, bool predicate_tail, const Target &t) :
+            var(v), replacement(r), target(t), in_hexagon(in_hexagon), predicate_tail(predicate_tail) {
         widening_suffix = ".x" + std::to_string(replacement.type().lanes());
     }
 };
@@ -918,6 +1095,19 @@ class VectorizeLoops : public IRMutator {
     const Target &target;
     bool in_hexagon;
 
+    // The loop name prefixes of the stages that have a split with
+    // TailStrategy::Predicate.
+    set<string> predicate_tail_stages;
+
+    bool is_predicate_tail_loop(const string &name) {
+        for (const string &prefix : predicate_tail_stages) {
+            if (starts_with(name, prefix)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     using IRMutator::visit;
 
     void visit(const For *for_loop) {
@@ -938,7 +1128,9 @@ class VectorizeLoops : public IRMutator {
             // Replace the var with a ramp within the body
             Expr for_var = Variable::make(Int(32), for_loop->name);
             Expr replacement = Ramp::make(for_loop->min, 1, extent->value);
-            stmt = VectorSubs(for_loop->name, replacement, in_hexagon, target).mutate(for_loop->body);
+            bool predicate_tail = is_predicate_tail_loop(for_loop->name);
+            stmt = VectorSubs(for_loop->name, replacement, in_hexagon,
+                              predicate_tail, target).mutate(for_loop->body);
         } else {
             IRMutator::visit(for_loop);
         }
@@ -949,13 +1141,30 @@ class VectorizeLoops : public IRMutator {
     }
 
 public:
-    VectorizeLoops(const Target &t) : target(t), in_hexagon(false) {}
+    VectorizeLoops(const map<string, Function> &env, const Target &t) : target(t), in_hexagon(false) {
+        for (const auto &iter : env) {
+            const Function &f = iter.second;
+            if (!f.has_pure_definition()) {
+                continue;
+            }
+            vector<Definition> defs = {f.definition()};
+            defs.insert(defs.end(), f.updates().begin(), f.updates().end());
+            for (size_t i = 0; i < defs.size(); i++) {
+                for (const Split &s : defs[i].schedule().splits()) {
+                    if (s.is_split() && s.tail == TailStrategy::Predicate) {
+                        predicate_tail_stages.insert(f.name() + ".s" + std::to_string(i) + ".");
+                        break;
+                    }
+                }
+            }
+        }
+    }
 };
 
 } // Anonymous namespace
 
-Stmt vectorize_loops(Stmt s, const Target &t) {
-    return VectorizeLoops(t).mutate(s);
+Stmt vectorize_loops(Stmt s, const map<string, Function> &env, const Target &t) {
+    return VectorizeLoops(env, t).mutate(s);
 }
 
 }
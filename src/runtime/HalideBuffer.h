@@ -698,6 +698,19 @@ public:
         decref();
     }
 
+    /** Take ownership of host memory that was allocated by some other
+     * means, such as a memory-mapped file. Drops the reference to any
+     * owned memory. As for memory allocated with allocate(), the
+     * header's deallocate_fn is called on the header when the last
+     * Buffer referring to the memory is destroyed, but the host
+     * pointer need not follow the header. */
+    void adopt_allocation(AllocationHeader *header, void *host) {
+        deallocate();
+        alloc = header;
+        alloc->ref_count = 1;
+        buf.host = (uint8_t *)host;
+    }
+
     /** Drop reference to any owned device memory, possibly freeing it
      * if this buffer held the last reference to it. Asserts that
      * device_dirty is false. */
@@ -991,6 +1004,9 @@ public:
      * sprite onto a framebuffer, you'll want to translate the sprite
      * to the correct location first like so: \code
      * framebuffer.copy_from(sprite.translated({x, y})); \endcode
+     *
+     * Where the innermost dimensions are dense in both Buffers, they
+     * are copied in contiguous runs with memcpy.
     */
     template<typename T2, int D2>
     void copy_from(const Buffer<T2, D2> &other) {
@@ -999,19 +1015,13 @@ public:
 
         Buffer<const T, D> src(other);
         Buffer<T, D> dst(*this);
+        if (!crop_to_intersection(src, dst)) {
+            return;
+        }
 
-        assert(src.dimensions() == dst.dimensions());
-
-        // Trim the copy to the region in common
-        for (int i = 0; i < dimensions(); i++) {
-            int min_coord = std::max(dst.dim(i).min(), src.dim(i).min());
-            int max_coord = std::min(dst.dim(i).max(), src.dim(i).max());
-            if (max_coord < min_coord) {
-                // The buffers do not overlap.
-                return;
-            }
-            dst.crop(i, min_coord, max_coord - min_coord + 1);
-            src.crop(i, min_coord, max_coord - min_coord + 1);
+        if (copy_contiguous_runs(*src.raw_buffer(), *dst.raw_buffer())) {
+            set_host_dirty();
+            return;
         }
 
         // If T is void, we need to do runtime dispatch to an
@@ -1043,6 +1053,176 @@ public:
         set_host_dirty();
     }
 
+    /** A parallel version of copy_from for multi-megabyte
+     * copies. The contiguous runs are split into up to num_tasks
+     * tasks of at least a megabyte each, which are run using
+     * halide_do_par_for on the thread pool used by Halide
+     * pipelines. Copies that don't have a dense innermost dimension
+     * fall back to copy_from. Requires the Halide runtime to be
+     * linked in. */
+    template<typename T2, int D2>
+    void parallel_copy_from(const Buffer<T2, D2> &other, int num_tasks) {
+        assert(!device_dirty() && "Cannot call Halide::Runtime::Buffer::parallel_copy_from on a device dirty destination.");
+        assert(!other.device_dirty() && "Cannot call Halide::Runtime::Buffer::parallel_copy_from on a device dirty source.");
+
+        Buffer<const T, D> src(other);
+        Buffer<T, D> dst(*this);
+        if (!crop_to_intersection(src, dst)) {
+            return;
+        }
+
+        if (parallel_copy_contiguous_runs(*src.raw_buffer(), *dst.raw_buffer(), num_tasks)) {
+            set_host_dirty();
+        } else {
+            copy_from(src);
+        }
+    }
+
+private:
+    /** Helper functions for copy_from and parallel_copy_from. */
+    // @{
+    struct copy_task_dim {
+        int extent;
+        ptrdiff_t src_stride_bytes, dst_stride_bytes;
+    };
+
+    // Trim a copy to the region the two buffers have in
+    // common. Returns false if they do not overlap.
+    static bool crop_to_intersection(Buffer<const T, D> &src, Buffer<T, D> &dst) {
+        assert(src.dimensions() == dst.dimensions());
+        for (int i = 0; i < dst.dimensions(); i++) {
+            int min_coord = std::max(dst.dim(i).min(), src.dim(i).min());
+            int max_coord = std::min(dst.dim(i).max(), src.dim(i).max());
+            if (max_coord < min_coord) {
+                return false;
+            }
+            dst.crop(i, min_coord, max_coord - min_coord + 1);
+            src.crop(i, min_coord, max_coord - min_coord + 1);
+        }
+        return true;
+    }
+
+    static void copy_chunks(const copy_task_dim *t, int d,
+                            const uint8_t *src, uint8_t *dst, size_t chunk_size) {
+        if (d < 0) {
+            memcpy(dst, src, chunk_size);
+            return;
+        }
+        for (int i = 0; i < t[d].extent; i++) {
+            copy_chunks(t, d - 1, src, dst, chunk_size);
+            src += t[d].src_stride_bytes;
+            dst += t[d].dst_stride_bytes;
+        }
+    }
+
+    // Describe a copy between two buffers of the same shape as a
+    // loop nest over contiguous chunks, by merging the dimensions
+    // that are dense in both, as device_copy does in
+    // device_buffer_utils.h. t must have room for one entry per
+    // dimension. Returns the number of loops left in t, or -1 if the
+    // innermost dimension isn't dense, in which case the chunks
+    // would be single elements.
+    static int make_copy_task_dims(const halide_buffer_t &src, const halide_buffer_t &dst,
+                                   copy_task_dim *t, size_t *chunk_size) {
+        const ptrdiff_t elem_size = dst.type.bytes();
+
+        // Order the dimensions by destination stride, skipping the
+        // ones that don't need a loop.
+        int d = 0;
+        for (int i = 0; i < dst.dimensions; i++) {
+            if (dst.dim[i].extent == 1) {
+                continue;
+            }
+            copy_task_dim td = {dst.dim[i].extent,
+                                src.dim[i].stride * elem_size,
+                                dst.dim[i].stride * elem_size};
+            int j = d++;
+            for (; j > 0 && t[j-1].dst_stride_bytes > td.dst_stride_bytes; j--) {
+                t[j] = t[j-1];
+            }
+            t[j] = td;
+        }
+
+        // Fold the dimensions that are contiguous in both buffers into
+        // the chunk size.
+        *chunk_size = elem_size;
+        int dense = 0;
+        while (dense < d &&
+               t[dense].src_stride_bytes == (ptrdiff_t)*chunk_size &&
+               t[dense].dst_stride_bytes == (ptrdiff_t)*chunk_size) {
+            *chunk_size *= t[dense].extent;
+            dense++;
+        }
+        if (dense == 0 && d > 0) {
+            return -1;
+        }
+        std::copy(t + dense, t + d, t);
+        return d - dense;
+    }
+
+    static bool copy_contiguous_runs(const halide_buffer_t &src, const halide_buffer_t &dst) {
+        copy_task_dim *t = (copy_task_dim *)HALIDE_ALLOCA((dst.dimensions + 1) * sizeof(copy_task_dim));
+        size_t chunk_size;
+        int d = make_copy_task_dims(src, dst, t, &chunk_size);
+        if (d < 0) {
+            return false;
+        }
+        copy_chunks(t, d - 1, src.host, dst.host, chunk_size);
+        return true;
+    }
+
+    static bool parallel_copy_contiguous_runs(const halide_buffer_t &src, const halide_buffer_t &dst,
+                                              int num_tasks) {
+        copy_task_dim *t = (copy_task_dim *)HALIDE_ALLOCA((dst.dimensions + 1) * sizeof(copy_task_dim));
+        size_t chunk_size;
+        int d = make_copy_task_dims(src, dst, t, &chunk_size);
+        if (d < 0) {
+            return false;
+        }
+
+        const uint8_t *src_host = src.host;
+        uint8_t *dst_host = dst.host;
+
+        size_t total_size = chunk_size;
+        for (int i = 0; i < d; i++) {
+            total_size *= t[i].extent;
+        }
+        const size_t min_bytes_per_task = 1 << 20;
+        num_tasks = (int)std::min((size_t)std::max(num_tasks, 1), total_size / min_bytes_per_task);
+
+        if (num_tasks <= 1) {
+            copy_chunks(t, d - 1, src_host, dst_host, chunk_size);
+        } else if (d == 0) {
+            // One big chunk. Split it into pieces.
+            auto body = [&](int i) {
+                size_t begin = chunk_size * i / num_tasks;
+                size_t end = chunk_size * (i + 1) / num_tasks;
+                memcpy(dst_host + begin, src_host + begin, end - begin);
+            };
+            parallel_for(num_tasks, body);
+        } else {
+            // Split the outermost dimension.
+            const copy_task_dim outer = t[d-1];
+            num_tasks = std::min(num_tasks, outer.extent);
+            auto body = [&](int i) {
+                int begin = (int)((int64_t)outer.extent * i / num_tasks);
+                int end = (int)((int64_t)outer.extent * (i + 1) / num_tasks);
+                const uint8_t *s = src_host + begin * outer.src_stride_bytes;
+                uint8_t *ds = dst_host + begin * outer.dst_stride_bytes;
+                for (int j = begin; j < end; j++) {
+                    copy_chunks(t, d - 2, s, ds, chunk_size);
+                    s += outer.src_stride_bytes;
+                    ds += outer.dst_stride_bytes;
+                }
+            };
+            parallel_for(num_tasks, body);
+        }
+        return true;
+    }
+    // @}
+
+public:
+
     /** Make an image that refers to a sub-range of this image along
      * the given dimension. Does not assert the crop region is within
      * the existing bounds. The cropped image drops any device
@@ -1633,6 +1813,16 @@ private:
 
     static void advance_ptrs(const int *) {}
 
+    // Same as the above, but advances the pointers by n times the
+    // strides.
+    template<typename Ptr, typename ...Ptrs>
+    static void advance_ptrs(int n, const int *stride, Ptr *ptr, Ptrs... ptrs) {
+        (*ptr) += (ptrdiff_t)n * *stride;
+        advance_ptrs(n, stride + 1, ptrs...);
+    }
+
+    static void advance_ptrs(int, const int *) {}
+
     // Same as the above, but just increments the pointers.
     template<typename Ptr, typename ...Ptrs>
     static void increment_ptrs(Ptr *ptr, Ptrs... ptrs) {
@@ -1709,6 +1899,36 @@ public:
     void for_each_value(Fn &&f, Args... other_buffers) {
         for_each_value_task_dim<N> *t =
             (for_each_value_task_dim<N> *)HALIDE_ALLOCA((dimensions()+1) * sizeof(for_each_value_task_dim<N>));
+        if (make_for_each_value_task_dims(t, &other_buffers...)) {
+            for_each_value_helper<true>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+        } else {
+            for_each_value_helper<false>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+        }
+    }
+
+    /** A parallel version of for_each_value. The outermost dimension
+     * with more than one value is split into tasks, which are run
+     * using halide_do_par_for, so they share the thread pool used by
+     * Halide pipelines. The function may be called concurrently on
+     * different values. Requires the Halide runtime to be linked
+     * in. */
+    template<typename Fn, typename ...Args, int N = sizeof...(Args) + 1>
+    void parallel_for_each_value(Fn &&f, Args... other_buffers) {
+        for_each_value_task_dim<N> *t =
+            (for_each_value_task_dim<N> *)HALIDE_ALLOCA((dimensions()+1) * sizeof(for_each_value_task_dim<N>));
+        if (make_for_each_value_task_dims(t, &other_buffers...)) {
+            for_each_value_parallel_helper<true>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+        } else {
+            for_each_value_parallel_helper<false>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+        }
+    }
+
+private:
+    // Fill in the loop nest for for_each_value, ordered by stride
+    // and with dimensions flattened where possible. Returns whether
+    // the innermost strides are all one.
+    template<int N, typename ...Args>
+    bool make_for_each_value_task_dims(for_each_value_task_dim<N> *t, Args... other_buffers) {
         for (int i = 0; i <= dimensions(); i++) {
             for (int j = 0; j < N; j++) {
                 t[i].stride[j] = 0;
@@ -1717,7 +1937,7 @@ public:
         }
 
         for (int i = 0; i < dimensions(); i++) {
-            extract_strides(i, t[i].stride, this, &other_buffers...);
+            extract_strides(i, t[i].stride, this, other_buffers...);
             t[i].extent = dim(i).extent();
             // Order the dimensions by stride, so that the traversal is cache-coherent.
             for (int j = i; j > 0 && t[j].stride[0] < t[j-1].stride[0]; j--) {
@@ -1750,14 +1970,79 @@ public:
                 innermost_strides_are_one &= t[0].stride[j] == 1;
             }
         }
+        return innermost_strides_are_one;
+    }
 
-        if (innermost_strides_are_one) {
-            for_each_value_helper<true>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+    /** Helper functions for the parallel versions of for_each_value
+     * and for_each_element. */
+    // @{
+    template<typename Body>
+    static int parallel_task(void *user_context, int idx, uint8_t *closure) {
+        (*(Body *)closure)(idx);
+        return 0;
+    }
+
+    // Call body on each task index, using halide_do_par_for if
+    // there's more than one.
+    template<typename Body>
+    static void parallel_for(int num_tasks, Body &body) {
+        if (num_tasks <= 1) {
+            body(0);
         } else {
-            for_each_value_helper<false>(f, dimensions() - 1, t, begin(), (other_buffers.begin())...);
+            int result = halide_do_par_for(nullptr, parallel_task<Body>, 0, num_tasks, (uint8_t *)&body);
+            assert(result == 0);
+            (void)result;
         }
     }
 
+    // How many tasks to split an outer dimension of the given extent
+    // into, so that each task visits at least a few thousand sites.
+    static int num_parallel_tasks(int extent, int64_t sites) {
+        const int64_t min_sites_per_task = 4096;
+        return (int)std::max((int64_t)1, std::min((int64_t)extent, sites / min_sites_per_task));
+    }
+
+    // Run the loop nest for the rows [begin, begin + t[d].extent) of
+    // dimension d.
+    template<bool innermost_strides_are_one, typename Fn, typename... Ptrs>
+    static void for_each_value_slice(Fn &&f, int d, const for_each_value_task_dim<sizeof...(Ptrs)> *t,
+                                     int begin, Ptrs... ptrs) {
+        advance_ptrs(begin, t[d].stride, (&ptrs)...);
+        for_each_value_helper<innermost_strides_are_one>(f, d, t, ptrs...);
+    }
+
+    template<bool innermost_strides_are_one, typename Fn, typename... Ptrs>
+    static void for_each_value_parallel_helper(Fn &&f, int d, const for_each_value_task_dim<sizeof...(Ptrs)> *t,
+                                               Ptrs... ptrs) {
+        typedef for_each_value_task_dim<sizeof...(Ptrs)> task_dim;
+
+        // Split the outermost dimension that has more than one value.
+        while (d >= 0 && t[d].extent == 1) {
+            d--;
+        }
+        int64_t sites = 1;
+        for (int i = 0; i <= d; i++) {
+            sites *= t[i].extent;
+        }
+        if (d < 0 || num_parallel_tasks(t[d].extent, sites) == 1) {
+            for_each_value_helper<innermost_strides_are_one>(f, d, t, ptrs...);
+            return;
+        }
+
+        const int extent = t[d].extent;
+        const int num_tasks = num_parallel_tasks(extent, sites);
+        auto body = [&](int i) {
+            int begin = (int)((int64_t)extent * i / num_tasks);
+            int end = (int)((int64_t)extent * (i + 1) / num_tasks);
+            task_dim *t_task = (task_dim *)HALIDE_ALLOCA((d + 1) * sizeof(task_dim));
+            std::copy(t, t + d + 1, t_task);
+            t_task[d].extent = end - begin;
+            for_each_value_slice<innermost_strides_are_one>(f, d, t_task, begin, ptrs...);
+        };
+        parallel_for(num_tasks, body);
+    }
+    // @}
+
 private:
 
     // Helper functions for for_each_element
@@ -1949,7 +2234,66 @@ public:
         for_each_element(0, dimensions(), t, std::forward<Fn>(f));
     }
 
+    /** A parallel version of for_each_element. The outermost
+     * dimension iterated over that has more than one site is split
+     * into tasks, which are run using halide_do_par_for, so they
+     * share the thread pool used by Halide pipelines. The callable
+     * may be called concurrently at different sites. Requires the
+     * Halide runtime to be linked in. */
+    template<typename Fn>
+    void parallel_for_each_element(Fn &&f) const {
+        for_each_element_task_dim *t =
+            (for_each_element_task_dim *)HALIDE_ALLOCA(dimensions() * sizeof(for_each_element_task_dim));
+        for (int i = 0; i < dimensions(); i++) {
+            t[i].min = dim(i).min();
+            t[i].max = dim(i).max();
+        }
+
+        int d = std::min(num_iterated_dims(0, f), dimensions()) - 1;
+        while (d >= 0 && t[d].min == t[d].max) {
+            d--;
+        }
+        int64_t sites = 1;
+        for (int i = 0; i <= d; i++) {
+            sites *= t[i].max - t[i].min + 1;
+        }
+        if (d < 0 || num_parallel_tasks(t[d].max - t[d].min + 1, sites) == 1) {
+            for_each_element(0, dimensions(), t, std::forward<Fn>(f));
+            return;
+        }
+
+        const int extent = t[d].max - t[d].min + 1;
+        const int num_tasks = num_parallel_tasks(extent, sites);
+        const int dims = dimensions();
+        auto body = [&](int i) {
+            int begin = (int)((int64_t)extent * i / num_tasks);
+            int end = (int)((int64_t)extent * (i + 1) / num_tasks);
+            for_each_element_task_dim *t_task =
+                (for_each_element_task_dim *)HALIDE_ALLOCA(dims * sizeof(for_each_element_task_dim));
+            std::copy(t, t + dims, t_task);
+            t_task[d].min = t[d].min + begin;
+            t_task[d].max = t[d].min + end - 1;
+            for_each_element(0, dims, t_task, f);
+        };
+        parallel_for(num_tasks, body);
+    }
+
 private:
+    /** The number of dimensions for_each_element iterates over for
+     * the given callable. */
+    // @{
+    template<typename Fn,
+             typename = decltype(std::declval<Fn>()((const int *)nullptr))>
+    int num_iterated_dims(int, Fn &&) const {
+        return dimensions();
+    }
+
+    template<typename Fn>
+    int num_iterated_dims(double, Fn &&f) const {
+        return num_args(0, std::forward<Fn>(f));
+    }
+    // @}
+
     template<typename Fn>
     struct FillHelper {
         Fn f;
@@ -128,6 +128,30 @@ extern int halide_do_par_for(void *user_context,
 extern void halide_shutdown_thread_pool();
 //@}
 
+/** The ways the default thread pool can hand out the iterations of a
+ * parallel loop to threads. See Halide::ParallelSchedule. */
+typedef enum halide_parallel_schedule_t {
+    halide_parallel_schedule_dynamic = 0,  ///< One iteration at a time.
+    halide_parallel_schedule_static = 1,   ///< One contiguous block per thread.
+    halide_parallel_schedule_guided = 2,   ///< Chunks that shrink as the loop runs.
+} halide_parallel_schedule_t;
+
+/** A version of halide_do_par_for with a hint for how to hand out the
+ * iterations. Pipelines call this instead of halide_do_par_for for
+ * loops scheduled with a ParallelSchedule other than Dynamic. If a
+ * custom do_par_for has been set, it is called instead, without the
+ * hint. */
+//@{
+extern int halide_do_par_for_with_schedule(void *user_context,
+                                           halide_task_t task,
+                                           int min, int size, uint8_t *closure,
+                                           halide_parallel_schedule_t schedule);
+extern int halide_default_do_par_for_with_schedule(void *user_context,
+                                                   halide_task_t task,
+                                                   int min, int size, uint8_t *closure,
+                                                   halide_parallel_schedule_t schedule);
+//@}
+
 /** Set a custom method for performing a parallel for loop. Returns
  * the old do_par_for handler. */
 typedef int (*halide_do_par_for_t)(void *, halide_task_t, int, int, uint8_t*);
@@ -180,6 +204,78 @@ extern void halide_join_thread(struct halide_thread *);
  */
 extern int halide_set_num_threads(int n);
 
+/** Set the number of times an idle worker thread of a Halide thread
+ * pool yields while checking for new work before it goes to sleep.
+ * Waking a sleeping thread takes tens of microseconds, which adds up
+ * for pipelines with many short parallel loops. A larger spin count
+ * keeps workers ready through bursts of such loops, at the cost of
+ * using more cpu while idle; zero puts idle workers straight to sleep.
+ * Applies to all thread pools. The default is 40, or the value of the
+ * environment variable HL_SPIN_COUNT. Returns the old value. Has no
+ * effect on platforms that don't use Halide's own thread pool (e.g.
+ * OS X and iOS).
+ */
+extern int halide_set_thread_pool_spin_count(int n);
+
+/** Thread pools other than the default one, so that pipelines with
+ * different latency requirements running in the same process don't
+ * compete for the same threads. halide_create_thread_pool makes a
+ * pool of num_threads threads (zero means the same default as
+ * halide_set_num_threads) running at the given priority. Zero is the
+ * priority of the default thread pool; larger values are more urgent.
+ * On Linux and Android the priority is the negated nice value of the
+ * worker threads, and on Windows it is clamped to the range of thread
+ * priority levels -2 to 2. Raising the priority above zero may require
+ * privileges, and fails silently without them. The threads are started
+ * when the pool is first used.
+ *
+ * halide_set_thread_pool binds a user_context to a pool: parallel
+ * loops of pipeline invocations passed that user_context (see the
+ * user_context target feature) run on that pool's threads instead of
+ * the default pool. Binding a NULL pool removes the binding. Returns
+ * zero on success.
+ *
+ * halide_destroy_thread_pool removes any bindings to a pool, and
+ * joins and frees its threads. No pipeline may be using the pool when
+ * it is destroyed.
+ *
+ * halide_create_thread_pool returns NULL on failure, and on platforms
+ * where the default implementations of halide_do_par_for don't use a
+ * pool of threads owned by %Halide (e.g. OS X and iOS, which use Grand
+ * Central Dispatch). Pipelines bound to a NULL pool use the default.
+ */
+//@{
+struct halide_thread_pool;
+extern struct halide_thread_pool *halide_create_thread_pool(int num_threads, int priority);
+extern void halide_destroy_thread_pool(struct halide_thread_pool *pool);
+extern int halide_set_thread_pool(void *user_context, struct halide_thread_pool *pool);
+//@}
+
+/** On Linux hosts with more than one NUMA node, make the default
+ * thread pool and allocator NUMA-aware: worker threads are pinned to
+ * the cpus of one node each, each node's threads take a contiguous
+ * share of the iterations of every parallel loop before helping with
+ * the others', and allocations by halide_default_malloc of 16MB or
+ * more are first touched in parallel with the same split, so their
+ * pages land on the nodes that will use them. Off by default; setting
+ * the environment variable HL_NUMA_AWARE=1 also enables it. Takes
+ * effect when the thread pool next starts, so call this before running
+ * any pipelines, or after halide_shutdown_thread_pool(). Returns the
+ * previous setting. Has no effect on other platforms.
+ */
+extern bool halide_set_numa_aware(bool numa_aware);
+
+/** On Linux, back allocations by halide_default_malloc of at least
+ * this many bytes with anonymous mappings aligned to 2MB and advised
+ * with MADV_HUGEPAGE, so that large intermediates accessed in columns
+ * or tiles take fewer TLB misses. Zero, the default, disables this;
+ * the environment variable HL_HUGE_PAGE_THRESHOLD can also set it.
+ * Whether huge pages are actually used depends on the kernel's
+ * transparent huge page settings. Returns the previous threshold. Has
+ * no effect on other platforms.
+ */
+extern size_t halide_set_huge_page_threshold(size_t bytes);
+
 /** Halide calls these functions to allocate and free memory. To
  * replace in AOT code, use the halide_set_custom_malloc and
  * halide_set_custom_free, or (on platforms that support weak
@@ -999,7 +1095,10 @@ typedef enum halide_target_feature_t {
     halide_target_feature_cuda_capability61 = 46,  ///< Enable CUDA compute capability 6.1 (Pascal)
     halide_target_feature_hvx_v65 = 47, ///< Enable Hexagon v65 architecture.
     halide_target_feature_hvx_v66 = 48, ///< Enable Hexagon v66 architecture.
-    halide_target_feature_end = 49, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
+    halide_target_feature_avx512_vnni = 49, ///< Enable the AVX512-VNNI int8 dot-product instructions (vpdpbusd). Only used in addition to one of the other AVX512 features.
+    halide_target_feature_arm_dot_prod = 50, ///< Enable the ARMv8.2 int8 dot-product instructions (sdot/udot).
+    halide_target_feature_batch = 51, ///< Also generate a _batch entry point, which runs the pipeline on many sets of buffers in one parallel loop.
+    halide_target_feature_end = 52, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
 } halide_target_feature_t;
 
 /** This function is called internally by Halide in some situations to determine
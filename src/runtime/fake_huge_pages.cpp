@@ -0,0 +1,19 @@
+#include "HalideRuntime.h"
+#include "runtime_internal.h"
+
+// Huge-page backed allocations are only implemented on Linux.
+
+extern "C" {
+
+WEAK size_t halide_set_huge_page_threshold(size_t bytes) {
+    return 0;
+}
+
+WEAK void *halide_huge_page_map(void *user_context, size_t size) {
+    return NULL;
+}
+
+WEAK void halide_huge_page_unmap(void *user_context, void *ptr, size_t size) {
+}
+
+}
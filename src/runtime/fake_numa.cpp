@@ -0,0 +1,31 @@
+#include "HalideRuntime.h"
+#include "runtime_internal.h"
+
+// NUMA-awareness is only implemented on Linux. Elsewhere the host is
+// treated as a single node.
+
+extern "C" {
+
+WEAK int halide_host_numa_node_count() {
+    return 1;
+}
+
+WEAK bool halide_set_numa_aware(bool numa_aware) {
+    return false;
+}
+
+WEAK int halide_numa_nodes_in_use() {
+    return 1;
+}
+
+WEAK int halide_numa_current_node() {
+    return 0;
+}
+
+WEAK void halide_numa_bind_thread(int node) {
+}
+
+WEAK void halide_numa_first_touch(void *user_context, void *ptr, size_t size) {
+}
+
+}
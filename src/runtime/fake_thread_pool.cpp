@@ -47,6 +47,25 @@ WEAK void halide_mutex_unlock(halide_mutex *mutex) {
 WEAK void halide_shutdown_thread_pool() {
 }
 
+WEAK int halide_set_thread_pool_spin_count(int n) {
+    if (n < 0) {
+        halide_error(NULL, "halide_set_thread_pool_spin_count: must be >= 0.");
+    }
+    return 0;
+}
+
+// There are no threads, so there are no other pools to make.
+WEAK halide_thread_pool *halide_create_thread_pool(int num_threads, int priority) {
+    return NULL;
+}
+
+WEAK void halide_destroy_thread_pool(halide_thread_pool *pool) {
+}
+
+WEAK int halide_set_thread_pool(void *user_context, halide_thread_pool *pool) {
+    return 0;
+}
+
 WEAK int halide_set_num_threads(int n) {
     if (n < 0) {
         halide_error(NULL, "halide_set_num_threads: must be >= 0.");
@@ -76,4 +95,17 @@ WEAK int halide_do_par_for(void *user_context, halide_task_t f,
   return (*custom_do_par_for)(user_context, f, min, size, closure);
 }
 
+// The iterations are always handed out the same way.
+WEAK int halide_default_do_par_for_with_schedule(void *user_context, halide_task_t f,
+                                                 int min, int size, uint8_t *closure,
+                                                 halide_parallel_schedule_t schedule) {
+    return halide_default_do_par_for(user_context, f, min, size, closure);
+}
+
+WEAK int halide_do_par_for_with_schedule(void *user_context, halide_task_t f,
+                                         int min, int size, uint8_t *closure,
+                                         halide_parallel_schedule_t schedule) {
+    return halide_do_par_for(user_context, f, min, size, closure);
+}
+
 }  // extern "C"
@@ -103,6 +103,7 @@ void *get_known_symbol(const char *name) {
         {"write", (char *)(&write)},
 
         {"halide_do_par_for", (char *)(&halide_do_par_for)},
+        {"halide_do_par_for_with_schedule", (char *)(&halide_do_par_for_with_schedule)},
         {"halide_do_task", (char *)(&halide_do_task)},
         {"halide_error", (char *)(&halide_error)},
         {"halide_free", (char *)(&halide_free)},
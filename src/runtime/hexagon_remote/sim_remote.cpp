@@ -125,6 +125,12 @@ int halide_do_par_for(void *user_context, halide_task_t f,
     return 0;
 }
 
+int halide_do_par_for_with_schedule(void *user_context, halide_task_t f,
+                                    int min, int size, uint8_t *closure,
+                                    halide_parallel_schedule_t schedule) {
+    return halide_do_par_for(user_context, f, min, size, closure);
+}
+
 void halide_mutex_lock(halide_mutex *) {}
 void halide_mutex_unlock(halide_mutex *) {}
 void halide_mutex_destroy(halide_mutex *) {}
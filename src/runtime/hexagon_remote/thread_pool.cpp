@@ -11,6 +11,25 @@ int halide_host_cpu_count() {
     return 4;
 }
 
+int halide_numa_nodes_in_use() {
+    return 1;
+}
+
+int halide_numa_current_node() {
+    return 0;
+}
+
+void halide_numa_bind_thread(int node) {
+}
+
+void halide_set_current_thread_priority(int priority) {
+    // Worker threads are spawned at a fixed priority.
+}
+
+void halide_thread_yield() {
+    // Idle workers just check for new work again.
+}
+
 namespace {
 struct spawned_thread {
     void (*f)(void *);
@@ -105,6 +124,14 @@ extern "C" {
 int halide_do_par_for(void *user_context,
                       halide_task_t task,
                       int min, int size, uint8_t *closure) {
+    return halide_do_par_for_with_schedule(user_context, task, min, size, closure,
+                                           halide_parallel_schedule_dynamic);
+}
+
+int halide_do_par_for_with_schedule(void *user_context,
+                                    halide_task_t task,
+                                    int min, int size, uint8_t *closure,
+                                    halide_parallel_schedule_t schedule) {
     // Get the work queue mutex. We need to do a handful of hexagon-specific things.
     qurt_mutex_t *mutex = (qurt_mutex_t *)(&work_queue.mutex);
 
@@ -143,7 +170,8 @@ int halide_do_par_for(void *user_context,
             c.hvx_mode = -1;
         }
     }
-    int ret = halide_default_do_par_for(user_context, task, min, size, (uint8_t *)&c);
+    int ret = halide_default_do_par_for_with_schedule(user_context, task, min, size,
+                                                      (uint8_t *)&c, schedule);
     if (c.hvx_mode != -1) {
         qurt_hvx_lock((qurt_hvx_mode_t)c.hvx_mode);
     }
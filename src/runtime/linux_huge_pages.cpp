@@ -0,0 +1,89 @@
+#include "HalideRuntime.h"
+#include "runtime_internal.h"
+
+extern "C" {
+
+extern void *mmap(void *addr, size_t length, int prot, int flags, int fd, long offset);
+extern int munmap(void *addr, size_t length);
+extern int madvise(void *addr, size_t length, int advice);
+extern unsigned long long strtoull(const char *str, char **str_end, int base);
+
+}
+
+namespace Halide { namespace Runtime { namespace Internal {
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#define PROT_READ 1
+#define PROT_WRITE 2
+#define MAP_PRIVATE 2
+#define MAP_ANONYMOUS 0x20
+#define MAP_FAILED ((void *)-1)
+#define MADV_HUGEPAGE 14
+
+WEAK size_t huge_page_threshold = 0;
+WEAK bool huge_page_threshold_initialized = false;
+
+WEAK size_t round_up_to_huge_page(size_t size) {
+    return (size + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+}
+
+}}}  // namespace Halide::Runtime::Internal
+
+using namespace Halide::Runtime::Internal;
+
+extern "C" {
+
+WEAK size_t halide_set_huge_page_threshold(size_t bytes) {
+    size_t old = huge_page_threshold;
+    huge_page_threshold = bytes;
+    huge_page_threshold_initialized = true;
+    return old;
+}
+
+WEAK void *halide_huge_page_map(void *user_context, size_t size) {
+    if (!huge_page_threshold_initialized) {
+        char *threshold_str = getenv("HL_HUGE_PAGE_THRESHOLD");
+        // Keep the default if the value isn't a plain non-negative
+        // number that fits in a size_t.
+        if (threshold_str && *threshold_str >= '0' && *threshold_str <= '9') {
+            char *end = NULL;
+            unsigned long long bytes = strtoull(threshold_str, &end, 10);
+            if (*end == 0 && bytes == (size_t)bytes && bytes != ~0ULL) {
+                huge_page_threshold = (size_t)bytes;
+            }
+        }
+        huge_page_threshold_initialized = true;
+    }
+    if (huge_page_threshold == 0 || size < huge_page_threshold) {
+        return NULL;
+    }
+
+    // Map an extra huge page so that the start can be aligned to a
+    // huge page, then unmap the unaligned ends.
+    size_t length = round_up_to_huge_page(size);
+    uint8_t *mapping = (uint8_t *)mmap(NULL, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    uint8_t *aligned = (uint8_t *)(((uintptr_t)mapping + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+    if (aligned > mapping) {
+        munmap(mapping, aligned - mapping);
+    }
+    uint8_t *end = mapping + length + HUGE_PAGE_SIZE;
+    if (end > aligned + length) {
+        munmap(aligned + length, end - (aligned + length));
+    }
+
+    // This is only advice: without transparent huge pages, the
+    // mapping is still usable with ordinary pages.
+    (void)madvise(aligned, length, MADV_HUGEPAGE);
+    return aligned;
+}
+
+WEAK void halide_huge_page_unmap(void *user_context, void *ptr, size_t size) {
+    munmap(ptr, round_up_to_huge_page(size));
+}
+
+}
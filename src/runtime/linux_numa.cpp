@@ -0,0 +1,183 @@
+#include "HalideRuntime.h"
+#include "runtime_internal.h"
+
+extern "C" {
+
+extern size_t fread(void *, size_t, size_t, void *);
+extern int sched_getcpu();
+extern int sched_setaffinity(int pid, size_t cpusetsize, const void *mask);
+
+}
+
+namespace Halide { namespace Runtime { namespace Internal {
+
+#define MAX_NUMA_NODES 16
+#define MAX_NUMA_CPUS 1024
+
+// Allocations at least this large are first touched by a parallel
+// loop when the runtime is NUMA-aware.
+#define NUMA_FIRST_TOUCH_THRESHOLD (16 * 1024 * 1024)
+#define NUMA_PAGE_SIZE 4096
+
+struct numa_topology_t {
+    // All fields are protected by this mutex.
+    halide_mutex mutex;
+
+    // -1 until set by halide_set_numa_aware or read from the
+    // environment.
+    int aware;
+
+    bool initialized;
+    int num_nodes;
+
+    // The cpus of each node, one bit per cpu, in the layout that
+    // sched_setaffinity expects.
+    uint64_t cpus[MAX_NUMA_NODES][MAX_NUMA_CPUS / 64];
+};
+WEAK numa_topology_t numa_topology = {{{0}}, -1, false, 1, {{0}}};
+
+// Parse a cpu list like "0-7,16-23" from sysfs into a mask.
+WEAK bool read_numa_node_cpus(int node, uint64_t *mask) {
+    char path[64];
+    char *end = path + sizeof(path);
+    char *dst = halide_string_to_string(path, end, "/sys/devices/system/node/node");
+    dst = halide_int64_to_string(dst, end, node, 1);
+    halide_string_to_string(dst, end, "/cpulist");
+
+    void *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char buf[4096];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = 0;
+
+    const char *p = buf;
+    while (*p >= '0' && *p <= '9') {
+        int first = 0;
+        while (*p >= '0' && *p <= '9') {
+            first = first * 10 + (*p++ - '0');
+        }
+        int last = first;
+        if (*p == '-') {
+            p++;
+            last = 0;
+            while (*p >= '0' && *p <= '9') {
+                last = last * 10 + (*p++ - '0');
+            }
+        }
+        for (int cpu = first; cpu <= last && cpu < MAX_NUMA_CPUS; cpu++) {
+            mask[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return true;
+}
+
+// Must be called with the topology mutex held.
+WEAK void init_numa_topology_already_locked() {
+    if (numa_topology.initialized) {
+        return;
+    }
+    int n = 0;
+    while (n < MAX_NUMA_NODES && read_numa_node_cpus(n, numa_topology.cpus[n])) {
+        n++;
+    }
+    numa_topology.num_nodes = n > 0 ? n : 1;
+    numa_topology.initialized = true;
+}
+
+struct first_touch_closure {
+    uint8_t *base;
+    size_t size;
+    size_t chunk;
+};
+
+WEAK int first_touch_task(void *user_context, int idx, uint8_t *closure) {
+    first_touch_closure *c = (first_touch_closure *)closure;
+    size_t begin = idx * c->chunk;
+    size_t end = begin + c->chunk < c->size ? begin + c->chunk : c->size;
+    for (size_t i = begin; i < end; i += NUMA_PAGE_SIZE) {
+        c->base[i] = 0;
+    }
+    return 0;
+}
+
+}}}  // namespace Halide::Runtime::Internal
+
+using namespace Halide::Runtime::Internal;
+
+extern "C" {
+
+WEAK int halide_host_numa_node_count() {
+    halide_mutex_lock(&numa_topology.mutex);
+    init_numa_topology_already_locked();
+    int n = numa_topology.num_nodes;
+    halide_mutex_unlock(&numa_topology.mutex);
+    return n;
+}
+
+WEAK bool halide_set_numa_aware(bool numa_aware) {
+    halide_mutex_lock(&numa_topology.mutex);
+    bool old = numa_topology.aware > 0;
+    numa_topology.aware = numa_aware ? 1 : 0;
+    halide_mutex_unlock(&numa_topology.mutex);
+    return old;
+}
+
+WEAK int halide_numa_nodes_in_use() {
+    halide_mutex_lock(&numa_topology.mutex);
+    if (numa_topology.aware < 0) {
+        char *aware_str = getenv("HL_NUMA_AWARE");
+        numa_topology.aware = (aware_str && atoi(aware_str)) ? 1 : 0;
+    }
+    int n = 1;
+    if (numa_topology.aware) {
+        init_numa_topology_already_locked();
+        n = numa_topology.num_nodes;
+    }
+    halide_mutex_unlock(&numa_topology.mutex);
+    return n;
+}
+
+WEAK int halide_numa_current_node() {
+    int cpu = sched_getcpu();
+    if (cpu < 0 || cpu >= MAX_NUMA_CPUS || !numa_topology.initialized) {
+        return 0;
+    }
+    for (int n = 0; n < numa_topology.num_nodes; n++) {
+        if (numa_topology.cpus[n][cpu / 64] & ((uint64_t)1 << (cpu % 64))) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+WEAK void halide_numa_bind_thread(int node) {
+    if (!numa_topology.initialized || node < 0 || node >= numa_topology.num_nodes) {
+        return;
+    }
+    // Failure just leaves the thread free to run anywhere.
+    (void)sched_setaffinity(0, sizeof(numa_topology.cpus[node]), numa_topology.cpus[node]);
+}
+
+WEAK void halide_numa_first_touch(void *user_context, void *ptr, size_t size) {
+    if (size < NUMA_FIRST_TOUCH_THRESHOLD || halide_numa_nodes_in_use() <= 1) {
+        return;
+    }
+    // The thread pool gives each node a contiguous share of a
+    // parallel loop's iterations, so the pages of the allocation are
+    // spread over the nodes in order, as a parallel loop over its
+    // rows would use them.
+    first_touch_closure c;
+    c.base = (uint8_t *)ptr;
+    c.size = size;
+    c.chunk = 256 * NUMA_PAGE_SIZE;
+    int tasks = (int)((size + c.chunk - 1) / c.chunk);
+    (void)halide_do_par_for(user_context, first_touch_task, 0, tasks, (uint8_t *)&c);
+}
+
+}
@@ -1,4 +1,5 @@
 #include "HalideRuntime.h"
+#include "runtime_internal.h"
 
 extern "C" {
 
@@ -8,19 +9,43 @@ extern void free(void *);
 WEAK void *halide_default_malloc(void *user_context, size_t x) {
     // Allocate enough space for aligning the pointer we return.
     const size_t alignment = 128;
-    void *orig = malloc(x + alignment);
-    if (orig == NULL) {
-        // Will result in a failed assertion and a call to halide_error
-        return NULL;
+    void *ptr;
+    void *orig = halide_huge_page_map(user_context, x + alignment);
+    const bool huge_pages = orig != NULL;
+    if (!huge_pages) {
+        orig = malloc(x + alignment);
+        if (orig == NULL) {
+            // Will result in a failed assertion and a call to halide_error
+            return NULL;
+        }
+    }
+    // On a NUMA-aware host, place the pages of large allocations near
+    // the threads that will use them. This writes to the start of
+    // each chunk of the allocation, so it must happen before we store
+    // the header below.
+    halide_numa_first_touch(user_context, orig, x + alignment);
+    if (huge_pages) {
+        // Large allocations may be backed by huge pages. Mark the
+        // original pointer, which is aligned to a huge page, by setting
+        // its low bit, and store the size before it to unmap later.
+        ptr = (void *)((size_t)orig + alignment);
+        ((void **)ptr)[-1] = (void *)((size_t)orig | 1);
+        ((size_t *)ptr)[-2] = x + alignment;
+    } else {
+        // We want to store the original pointer prior to the pointer we return.
+        ptr = (void *)(((size_t)orig + alignment + sizeof(void*) - 1) & ~(alignment - 1));
+        ((void **)ptr)[-1] = orig;
     }
-    // We want to store the original pointer prior to the pointer we return.
-    void *ptr = (void *)(((size_t)orig + alignment + sizeof(void*) - 1) & ~(alignment - 1));
-    ((void **)ptr)[-1] = orig;
     return ptr;
 }
 
 WEAK void halide_default_free(void *user_context, void *ptr) {
-    free(((void**)ptr)[-1]);
+    void *orig = ((void**)ptr)[-1];
+    if ((size_t)orig & 1) {
+        halide_huge_page_unmap(user_context, (void *)((size_t)orig & ~(size_t)1), ((size_t *)ptr)[-2]);
+    } else {
+        free(orig);
+    }
 }
 
 }
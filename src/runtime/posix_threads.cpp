@@ -28,6 +28,8 @@ extern int pthread_mutex_init(halide_mutex *mutex, const void *attr);
 extern int pthread_mutex_lock(halide_mutex *mutex);
 extern int pthread_mutex_unlock(halide_mutex *mutex);
 extern int pthread_mutex_destroy(halide_mutex *mutex);
+extern int setpriority(int which, int who, int prio);
+extern int sched_yield();
 
 } // extern "C"
 
@@ -91,4 +93,16 @@ WEAK void halide_cond_wait(struct halide_cond *cond, struct halide_mutex *mutex)
     pthread_cond_wait(cond, mutex);
 }
 
+WEAK void halide_set_current_thread_priority(int priority) {
+    // On Linux the nice value is per-thread, so this only affects the
+    // calling thread. Failure (e.g. raising the priority without
+    // privileges) leaves the priority unchanged.
+    const int PRIO_PROCESS = 0;
+    (void)setpriority(PRIO_PROCESS, 0, -priority);
+}
+
+WEAK void halide_thread_yield() {
+    sched_yield();
+}
+
 } // extern "C"
@@ -26,6 +26,7 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_copy_to_host,
     (void *)&halide_copy_to_host_legacy,
     (void *)&halide_create_temp_file,
+    (void *)&halide_create_thread_pool,
     (void *)&halide_cuda_detach_device_ptr,
     (void *)&halide_cuda_device_interface,
     (void *)&halide_cuda_get_device_ptr,
@@ -35,6 +36,8 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_current_time_ns,
     (void *)&halide_debug_to_file,
     (void *)&halide_default_can_use_target_features,
+    (void *)&halide_default_do_par_for_with_schedule,
+    (void *)&halide_destroy_thread_pool,
     (void *)&halide_device_and_host_free,
     (void *)&halide_device_and_host_free_as_destructor,
     (void *)&halide_device_and_host_malloc,
@@ -48,6 +51,7 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_device_sync,
     (void *)&halide_device_sync_legacy,
     (void *)&halide_do_par_for,
+    (void *)&halide_do_par_for_with_schedule,
     (void *)&halide_do_task,
     (void *)&halide_double_to_string,
     (void *)&halide_downgrade_buffer_t,
@@ -173,7 +177,11 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_set_custom_trace,
     (void *)&halide_set_error_handler,
     (void *)&halide_set_gpu_device,
+    (void *)&halide_set_huge_page_threshold,
     (void *)&halide_set_num_threads,
+    (void *)&halide_set_numa_aware,
+    (void *)&halide_set_thread_pool,
+    (void *)&halide_set_thread_pool_spin_count,
     (void *)&halide_set_trace_file,
     (void *)&halide_shutdown_thread_pool,
     (void *)&halide_shutdown_trace,
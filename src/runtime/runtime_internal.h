@@ -135,6 +135,26 @@ WEAK int halide_profiler_pipeline_start(void *user_context,
                                         int num_funcs,
                                         const uint64_t *func_names);
 WEAK int halide_host_cpu_count();
+WEAK int halide_host_numa_node_count();
+
+// The number of NUMA nodes the default thread pool and allocator
+// spread work and memory over: one unless NUMA-awareness is enabled
+// on a host with more than one node.
+WEAK int halide_numa_nodes_in_use();
+// The NUMA node of the cpu the calling thread is running on.
+WEAK int halide_numa_current_node();
+// Restrict the calling thread to the cpus of a NUMA node.
+WEAK void halide_numa_bind_thread(int node);
+// Place the pages of a large new allocation on the nodes whose threads
+// will use them, by touching them with a parallel loop.
+WEAK void halide_numa_first_touch(void *user_context, void *ptr, size_t size);
+// Map at least size bytes of memory aligned to a huge page and advise
+// the kernel to back it with huge pages, if size is at least the
+// threshold set by halide_set_huge_page_threshold. Returns NULL
+// otherwise, or on failure.
+WEAK void *halide_huge_page_map(void *user_context, size_t size);
+// Unmap memory returned by halide_huge_page_map for the same size.
+WEAK void halide_huge_page_unmap(void *user_context, void *ptr, size_t size);
 
 WEAK int halide_device_and_host_malloc(void *user_context, struct halide_buffer_t *buf,
                                        const struct halide_device_interface_t *device_interface);
@@ -158,6 +178,13 @@ WEAK void halide_cond_destroy(struct halide_cond *cond);
 WEAK void halide_cond_broadcast(struct halide_cond *cond);
 WEAK void halide_cond_wait(struct halide_cond *cond, struct halide_mutex *mutex);
 
+// Set the priority of the calling thread, as for
+// halide_create_thread_pool. Only available on some platforms (those
+// that use the common thread pool).
+WEAK void halide_set_current_thread_priority(int priority);
+// Give up the rest of the calling thread's time slice.
+WEAK void halide_thread_yield();
+
 WEAK int halide_trace_helper(void *user_context,
                              const char *func,
                              void *value, int *coords,
@@ -37,4 +37,15 @@ WEAK int halide_do_par_for(void *user_context, halide_task_t f,
   return (*custom_do_par_for)(user_context, f, min, size, closure);
 }
 
+WEAK int halide_do_par_for_with_schedule(void *user_context, halide_task_t f,
+                                         int min, int size, uint8_t *closure,
+                                         halide_parallel_schedule_t schedule) {
+    // A custom do_par_for doesn't know about schedules, so it gets
+    // the loop as usual.
+    if (custom_do_par_for != halide_default_do_par_for) {
+        return (*custom_do_par_for)(user_context, f, min, size, closure);
+    }
+    return halide_default_do_par_for_with_schedule(user_context, f, min, size, closure, schedule);
+}
+
 } // extern "C"
@@ -1,6 +1,8 @@
 
 namespace Halide { namespace Runtime { namespace Internal {
 
+#define MAX_NUMA_RANGES 16
+
 struct work {
     work *next_job;
     int (*f)(void *, int, uint8_t *);
@@ -9,11 +11,28 @@ struct work {
     uint8_t *closure;
     int active_workers;
     int exit_status;
+
+    // When the thread pool is NUMA-aware, the iterations are divided
+    // into one contiguous range per node. Threads take iterations
+    // from the front of their own node's range, and once it is empty,
+    // from the back of whichever range has the most left. next still
+    // counts the iterations claimed.
+    int num_ranges;
+    int range_next[MAX_NUMA_RANGES], range_max[MAX_NUMA_RANGES];
+
+    // How the iterations are handed out (a
+    // halide_parallel_schedule_t). Threads claim chunk iterations at
+    // a time, or for guided schedules, the number remaining divided by
+    // num_threads if that is more.
+    int schedule;
+    int chunk, num_threads;
+
     bool running() { return next < max || active_workers > 0; }
 };
 
-// The work queue and thread pool is weak, so one big work queue is shared by all halide functions
-#define MAX_THREADS 64
+// The default work queue and thread pool is weak, so one big work
+// queue is shared by all halide functions, unless a pipeline is bound
+// to a thread pool of its own with halide_set_thread_pool.
 struct work_queue_t {
     // all fields are protected by this mutex.
     halide_mutex mutex;
@@ -39,8 +58,10 @@ struct work_queue_t {
     // more threads are required than are currently in the A team.
     halide_cond wakeup_b_team;
 
-    // Keep track of threads so they can be joined at shutdown
-    halide_thread *threads[MAX_THREADS];
+    // Keep track of threads so they can be joined at shutdown. Grown
+    // as more threads are created.
+    halide_thread **threads;
+    int threads_capacity;
 
     // The number threads created
     int threads_created;
@@ -48,6 +69,16 @@ struct work_queue_t {
     // The desired number threads doing work.
     int desired_num_threads;
 
+    // The number of NUMA nodes to spread threads and iterations
+    // over. One unless the thread pool is NUMA-aware.
+    int num_nodes;
+
+    // The NUMA node to give the next worker thread to start.
+    int next_node;
+
+    // The priority of the worker threads. See halide_create_thread_pool.
+    int priority;
+
     // Global flags indicating the threadpool should shut down, and
     // whether the thread pool has been initialized.
     bool shutdown, initialized;
@@ -59,10 +90,31 @@ struct work_queue_t {
 };
 WEAK work_queue_t work_queue;
 
+// Pipeline invocations are bound to other thread pools by their
+// user_context.
+struct thread_pool_binding_t {
+    void *user_context;
+    work_queue_t *queue;
+};
+
+struct thread_pool_bindings_t {
+    // All fields are protected by this mutex.
+    halide_mutex mutex;
+
+    thread_pool_binding_t *bindings;
+    int count, capacity;
+};
+WEAK thread_pool_bindings_t thread_pool_bindings;
+
+// The number of times an idle worker thread yields while checking for
+// new work before it goes to sleep, shared by all thread pools. -1
+// until set by halide_set_thread_pool_spin_count or read from the
+// environment.
+#define DEFAULT_SPIN_COUNT 40
+WEAK int worker_spin_count = -1;
+
 WEAK int clamp_num_threads(int desired_num_threads) {
-    if (desired_num_threads > MAX_THREADS) {
-        desired_num_threads = MAX_THREADS;
-    } else if (desired_num_threads < 1) {
+    if (desired_num_threads < 1) {
         desired_num_threads = 1;
     }
     return desired_num_threads;
@@ -83,42 +135,111 @@ WEAK int default_desired_num_threads() {
     return desired_num_threads;
 }
 
-WEAK void worker_thread_already_locked(work *owned_job) {
+WEAK int default_spin_count() {
+    char *spin_count_str = getenv("HL_SPIN_COUNT");
+    int spin_count = spin_count_str ? atoi(spin_count_str) : DEFAULT_SPIN_COUNT;
+    return spin_count < 0 ? 0 : spin_count;
+}
+
+// Claim the next iterations of a job for a thread on the given
+// node. Returns the first, and sets count to the number claimed.
+WEAK int claim_tasks(work *job, int node, int *count) {
+    int n = job->chunk;
+    if (job->schedule == halide_parallel_schedule_guided) {
+        int guided = (job->max - job->next) / job->num_threads;
+        if (guided > n) {
+            n = guided;
+        }
+    }
+
+    int first;
+    if (job->num_ranges <= 1) {
+        if (n > job->max - job->next) {
+            n = job->max - job->next;
+        }
+        first = job->next;
+    } else {
+        int r = node % job->num_ranges;
+        if (job->range_next[r] < job->range_max[r]) {
+            if (n > job->range_max[r] - job->range_next[r]) {
+                n = job->range_max[r] - job->range_next[r];
+            }
+            first = job->range_next[r];
+            job->range_next[r] += n;
+        } else {
+            for (int i = 0; i < job->num_ranges; i++) {
+                if (job->range_max[i] - job->range_next[i] > job->range_max[r] - job->range_next[r]) {
+                    r = i;
+                }
+            }
+            if (n > job->range_max[r] - job->range_next[r]) {
+                n = job->range_max[r] - job->range_next[r];
+            }
+            job->range_max[r] -= n;
+            first = job->range_max[r];
+        }
+    }
+    job->next += n;
+    *count = n;
+    return first;
+}
+
+WEAK void worker_thread_already_locked(work_queue_t *queue, work *owned_job, int node) {
+    // The number of times this thread has checked for new work since
+    // it last had some.
+    int spins = 0;
+
     // If I'm a job owner, then I was the thread that called
     // do_par_for, and I should only stay in this function until my
     // job is complete. If I'm a lowly worker thread, I should stay in
     // this function as long as the work queue is running.
     while (owned_job != NULL ? owned_job->running()
-           : work_queue.running()) {
+           : queue->running()) {
 
-        if (work_queue.jobs == NULL) {
+        if (queue->jobs == NULL) {
             if (owned_job) {
                 // There are no jobs pending. Wait for the last worker
                 // to signal that the job is finished.
-                halide_cond_wait(&work_queue.wakeup_owners, &work_queue.mutex);
-            } else if (work_queue.a_team_size <= work_queue.target_a_team_size) {
+                halide_cond_wait(&queue->wakeup_owners, &queue->mutex);
+            } else if (queue->a_team_size <= queue->target_a_team_size &&
+                       spins < __atomic_load_n(&worker_spin_count, __ATOMIC_RELAXED)) {
+                // There are no jobs pending. Stay awake for a while
+                // in case more jobs are enqueued soon, which is much
+                // cheaper than being woken up. Don't hold the lock
+                // while doing so.
+                int max_spins = __atomic_load_n(&worker_spin_count, __ATOMIC_RELAXED);
+                halide_mutex_unlock(&queue->mutex);
+                while (spins < max_spins &&
+                       __atomic_load_n(&queue->jobs, __ATOMIC_RELAXED) == NULL) {
+                    halide_thread_yield();
+                    spins++;
+                }
+                halide_mutex_lock(&queue->mutex);
+            } else if (queue->a_team_size <= queue->target_a_team_size) {
                 // There are no jobs pending. Wait until more jobs are enqueued.
-                halide_cond_wait(&work_queue.wakeup_a_team, &work_queue.mutex);
+                halide_cond_wait(&queue->wakeup_a_team, &queue->mutex);
+                spins = 0;
             } else {
                 // There are no jobs pending, and there are too many
                 // threads in the A team. Transition to the B team
                 // until the wakeup_b_team condition is fired.
-                work_queue.a_team_size--;
-                halide_cond_wait(&work_queue.wakeup_b_team, &work_queue.mutex);
-                work_queue.a_team_size++;
+                queue->a_team_size--;
+                halide_cond_wait(&queue->wakeup_b_team, &queue->mutex);
+                queue->a_team_size++;
             }
         } else {
             // Grab the next job.
-            work *job = work_queue.jobs;
+            work *job = queue->jobs;
 
-            // Claim a task from it.
+            // Claim some tasks from it.
             work myjob = *job;
-            job->next++;
+            int count;
+            int task = claim_tasks(job, node, &count);
 
             // If there were no more tasks pending for this job,
             // remove it from the stack.
             if (job->next == job->max) {
-                work_queue.jobs = job->next_job;
+                __atomic_store_n(&queue->jobs, job->next_job, __ATOMIC_RELAXED);
             }
 
             // Increment the active_worker count so that other threads
@@ -126,11 +247,15 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             // though there are no outstanding tasks for it.
             job->active_workers++;
 
-            // Release the lock and do the task.
-            halide_mutex_unlock(&work_queue.mutex);
-            int result = halide_do_task(myjob.user_context, myjob.f, myjob.next,
+            // Release the lock and do the tasks, stopping at the
+            // first failure.
+            halide_mutex_unlock(&queue->mutex);
+            int result = 0;
+            for (int i = 0; i < count && result == 0; i++) {
+                result = halide_do_task(myjob.user_context, myjob.f, task + i,
                                         myjob.closure);
-            halide_mutex_lock(&work_queue.mutex);
+            }
+            halide_mutex_lock(&queue->mutex);
 
             // If this task failed, set the exit status on the job.
             if (result) {
@@ -143,16 +268,151 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             // If the job is done and I'm not the owner of it, wake up
             // the owner.
             if (!job->running() && job != owned_job) {
-                halide_cond_broadcast(&work_queue.wakeup_owners);
+                halide_cond_broadcast(&queue->wakeup_owners);
             }
+
+            // Having done some work, spin again before sleeping.
+            spins = 0;
         }
     }
 }
 
-WEAK void worker_thread(void *) {
-    halide_mutex_lock(&work_queue.mutex);
-    worker_thread_already_locked(NULL);
-    halide_mutex_unlock(&work_queue.mutex);
+WEAK void worker_thread(void *arg) {
+    work_queue_t *queue = (work_queue_t *)arg;
+
+    // Threads are dealt out to the NUMA nodes in turn.
+    halide_mutex_lock(&queue->mutex);
+    int num_nodes = queue->num_nodes;
+    int node = queue->next_node++ % num_nodes;
+    int priority = queue->priority;
+    halide_mutex_unlock(&queue->mutex);
+
+    if (num_nodes > 1) {
+        halide_numa_bind_thread(node);
+    }
+    if (priority != 0) {
+        halide_set_current_thread_priority(priority);
+    }
+
+    halide_mutex_lock(&queue->mutex);
+    worker_thread_already_locked(queue, NULL, node);
+    halide_mutex_unlock(&queue->mutex);
+}
+
+WEAK void init_work_queue_already_locked(work_queue_t *queue) {
+    queue->shutdown = false;
+    halide_cond_init(&queue->wakeup_owners);
+    halide_cond_init(&queue->wakeup_a_team);
+    halide_cond_init(&queue->wakeup_b_team);
+    __atomic_store_n(&queue->jobs, (work *)NULL, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&worker_spin_count, __ATOMIC_RELAXED) < 0) {
+        __atomic_store_n(&worker_spin_count, default_spin_count(), __ATOMIC_RELAXED);
+    }
+
+    // Compute the desired number of threads to use. Other code
+    // can also mess with this value, but only when the work queue
+    // is locked.
+    if (!queue->desired_num_threads) {
+        queue->desired_num_threads = default_desired_num_threads();
+    }
+    queue->desired_num_threads = clamp_num_threads(queue->desired_num_threads);
+    queue->threads_created = 0;
+
+    queue->num_nodes = halide_numa_nodes_in_use();
+    if (queue->num_nodes > MAX_NUMA_RANGES) {
+        queue->num_nodes = MAX_NUMA_RANGES;
+    }
+    queue->next_node = 0;
+
+    // Everyone starts on the a team.
+    queue->a_team_size = queue->desired_num_threads;
+
+    queue->initialized = true;
+}
+
+WEAK void spawn_threads_already_locked(work_queue_t *queue) {
+    // We might need to make some new threads, if
+    // desired_num_threads has increased.
+    while (queue->threads_created < queue->desired_num_threads - 1) {
+        if (queue->threads_created == queue->threads_capacity) {
+            int capacity = queue->threads_capacity ? queue->threads_capacity * 2 : 16;
+            halide_thread **threads = (halide_thread **)malloc(capacity * sizeof(halide_thread *));
+            if (!threads) {
+                // Carry on with the threads we have.
+                return;
+            }
+            if (queue->threads) {
+                memcpy(threads, queue->threads, queue->threads_created * sizeof(halide_thread *));
+                free(queue->threads);
+            }
+            queue->threads = threads;
+            queue->threads_capacity = capacity;
+        }
+        queue->threads[queue->threads_created++] = halide_spawn_thread(worker_thread, queue);
+    }
+}
+
+WEAK void shutdown_work_queue(work_queue_t *queue) {
+    if (!queue->initialized) return;
+
+    // Wake everyone up and tell them the party's over and it's time
+    // to go home
+    halide_mutex_lock(&queue->mutex);
+    queue->shutdown = true;
+    halide_cond_broadcast(&queue->wakeup_owners);
+    halide_cond_broadcast(&queue->wakeup_a_team);
+    halide_cond_broadcast(&queue->wakeup_b_team);
+    halide_mutex_unlock(&queue->mutex);
+
+    // Wait until they leave
+    for (int i = 0; i < queue->threads_created; i++) {
+        halide_join_thread(queue->threads[i]);
+    }
+
+    // Tidy up
+    free(queue->threads);
+    queue->threads = NULL;
+    queue->threads_capacity = 0;
+    queue->threads_created = 0;
+    halide_mutex_destroy(&queue->mutex);
+    halide_cond_destroy(&queue->wakeup_owners);
+    halide_cond_destroy(&queue->wakeup_a_team);
+    halide_cond_destroy(&queue->wakeup_b_team);
+    queue->initialized = false;
+}
+
+// Find the work queue a pipeline invocation with the given
+// user_context should use.
+WEAK work_queue_t *work_queue_for(void *user_context) {
+    // Usually nothing is bound, so don't contend for the lock.
+    if (__atomic_load_n(&thread_pool_bindings.count, __ATOMIC_ACQUIRE) == 0) {
+        return &work_queue;
+    }
+    work_queue_t *queue = &work_queue;
+    halide_mutex_lock(&thread_pool_bindings.mutex);
+    for (int i = 0; i < thread_pool_bindings.count; i++) {
+        if (thread_pool_bindings.bindings[i].user_context == user_context) {
+            queue = thread_pool_bindings.bindings[i].queue;
+            break;
+        }
+    }
+    halide_mutex_unlock(&thread_pool_bindings.mutex);
+    return queue;
+}
+
+// Remove the bindings of some user_context, or if it's NULL and queue
+// isn't, all bindings to that queue.
+WEAK void unbind_work_queue_already_locked(void *user_context, work_queue_t *queue) {
+    int j = 0;
+    for (int i = 0; i < thread_pool_bindings.count; i++) {
+        const thread_pool_binding_t &b = thread_pool_bindings.bindings[i];
+        bool matches = queue ? b.queue == queue : b.user_context == user_context;
+        if (!matches) {
+            thread_pool_bindings.bindings[j++] = b;
+        }
+    }
+    __atomic_store_n(&thread_pool_bindings.count, j, __ATOMIC_RELEASE);
 }
 
 }}}  // namespace Halide::Runtime::Internal
@@ -168,43 +428,31 @@ WEAK int halide_default_do_task(void *user_context, halide_task_t f, int idx,
 
 WEAK int halide_default_do_par_for(void *user_context, halide_task_t f,
                                    int min, int size, uint8_t *closure) {
+    return halide_default_do_par_for_with_schedule(user_context, f, min, size, closure,
+                                                   halide_parallel_schedule_dynamic);
+}
+
+WEAK int halide_default_do_par_for_with_schedule(void *user_context, halide_task_t f,
+                                                 int min, int size, uint8_t *closure,
+                                                 halide_parallel_schedule_t schedule) {
     // Our for loops are expected to gracefully handle sizes <= 0
     if (size <= 0) {
         return 0;
     }
 
-    // Grab the lock. If it hasn't been initialized yet, then the
-    // field will be zero-initialized because it's a static global.
-    halide_mutex_lock(&work_queue.mutex);
-
-    if (!work_queue.initialized) {
-        work_queue.shutdown = false;
-        halide_cond_init(&work_queue.wakeup_owners);
-        halide_cond_init(&work_queue.wakeup_a_team);
-        halide_cond_init(&work_queue.wakeup_b_team);
-        work_queue.jobs = NULL;
-
-        // Compute the desired number of threads to use. Other code
-        // can also mess with this value, but only when the work queue
-        // is locked.
-        if (!work_queue.desired_num_threads) {
-            work_queue.desired_num_threads = default_desired_num_threads();
-        }
-        work_queue.desired_num_threads = clamp_num_threads(work_queue.desired_num_threads);
-        work_queue.threads_created = 0;
+    work_queue_t *queue = work_queue_for(user_context);
 
-        // Everyone starts on the a team.
-        work_queue.a_team_size = work_queue.desired_num_threads;
+    // Grab the lock. If the default work queue hasn't been
+    // initialized yet, then the field will be zero-initialized because
+    // it's a static global. Other work queues are initialized when
+    // they are created.
+    halide_mutex_lock(&queue->mutex);
 
-        work_queue.initialized = true;
+    if (!queue->initialized) {
+        init_work_queue_already_locked(queue);
     }
 
-    while (work_queue.threads_created < work_queue.desired_num_threads - 1) {
-        // We might need to make some new threads, if work_queue.desired_num_threads has
-        // increased.
-        work_queue.threads[work_queue.threads_created++] =
-            halide_spawn_thread(worker_thread, NULL);
-    }
+    spawn_threads_already_locked(queue);
 
     // Make the job.
     work job;
@@ -216,37 +464,54 @@ WEAK int halide_default_do_par_for(void *user_context, halide_task_t f,
     job.exit_status = 0;     // The job hasn't failed yet
     job.active_workers = 0;  // Nobody is working on this yet
 
-    if (!work_queue.jobs && size < work_queue.desired_num_threads) {
+    // Work out how many iterations threads claim at once.
+    job.schedule = schedule;
+    job.num_threads = queue->desired_num_threads;
+    if (schedule == halide_parallel_schedule_static) {
+        job.chunk = (size + job.num_threads - 1) / job.num_threads;
+    } else {
+        job.chunk = 1;
+    }
+
+    // Give each NUMA node a contiguous share of the iterations.
+    job.num_ranges = size >= queue->num_nodes ? queue->num_nodes : 1;
+    for (int r = 0; r < job.num_ranges; r++) {
+        job.range_next[r] = min + (int)(((int64_t)size * r) / job.num_ranges);
+        job.range_max[r] = min + (int)(((int64_t)size * (r + 1)) / job.num_ranges);
+    }
+
+    if (!queue->jobs && size < queue->desired_num_threads) {
         // If there's no nested parallelism happening and there are
         // fewer tasks to do than threads, then set the target A team
         // size so that some threads will put themselves to sleep
         // until a larger job arrives.
-        work_queue.target_a_team_size = size;
+        queue->target_a_team_size = size;
     } else {
         // Otherwise the target A team size is
         // desired_num_threads. This may still be less than
         // threads_created if desired_num_threads has been reduced by
         // other code.
-        work_queue.target_a_team_size = work_queue.desired_num_threads;
+        queue->target_a_team_size = queue->desired_num_threads;
     }
 
     // Push the job onto the stack.
-    job.next_job = work_queue.jobs;
-    work_queue.jobs = &job;
+    job.next_job = queue->jobs;
+    __atomic_store_n(&queue->jobs, &job, __ATOMIC_RELAXED);
 
     // Wake up our A team.
-    halide_cond_broadcast(&work_queue.wakeup_a_team);
+    halide_cond_broadcast(&queue->wakeup_a_team);
 
     // If there are fewer threads than we would like on the a team,
     // wake up the b team too.
-    if (work_queue.target_a_team_size > work_queue.a_team_size) {
-        halide_cond_broadcast(&work_queue.wakeup_b_team);
+    if (queue->target_a_team_size > queue->a_team_size) {
+        halide_cond_broadcast(&queue->wakeup_b_team);
     }
 
     // Do some work myself.
-    worker_thread_already_locked(&job);
+    int node = queue->num_nodes > 1 ? halide_numa_current_node() : 0;
+    worker_thread_already_locked(queue, &job, node);
 
-    halide_mutex_unlock(&work_queue.mutex);
+    halide_mutex_unlock(&queue->mutex);
 
     // Return zero if the job succeeded, otherwise return the exit
     // status of one of the failing jobs (whichever one failed last).
@@ -271,28 +536,76 @@ WEAK int halide_set_num_threads(int n) {
 }
 
 WEAK void halide_shutdown_thread_pool() {
-    if (!work_queue.initialized) return;
+    shutdown_work_queue(&work_queue);
+}
 
-    // Wake everyone up and tell them the party's over and it's time
-    // to go home
-    halide_mutex_lock(&work_queue.mutex);
-    work_queue.shutdown = true;
-    halide_cond_broadcast(&work_queue.wakeup_owners);
-    halide_cond_broadcast(&work_queue.wakeup_a_team);
-    halide_cond_broadcast(&work_queue.wakeup_b_team);
-    halide_mutex_unlock(&work_queue.mutex);
+WEAK int halide_set_thread_pool_spin_count(int n) {
+    if (n < 0) {
+        halide_error(NULL, "halide_set_thread_pool_spin_count: must be >= 0.");
+        n = 0;
+    }
+    int old = __atomic_exchange_n(&worker_spin_count, n, __ATOMIC_RELAXED);
+    return old < 0 ? default_spin_count() : old;
+}
 
-    // Wait until they leave
-    for (int i = 0; i < work_queue.threads_created; i++) {
-        halide_join_thread(work_queue.threads[i]);
+WEAK halide_thread_pool *halide_create_thread_pool(int num_threads, int priority) {
+    if (num_threads < 0) {
+        halide_error(NULL, "halide_create_thread_pool: num_threads must be >= 0.");
+        return NULL;
+    }
+    work_queue_t *queue = (work_queue_t *)malloc(sizeof(work_queue_t));
+    if (!queue) {
+        return NULL;
     }
+    memset(queue, 0, sizeof(work_queue_t));
+    queue->desired_num_threads = num_threads;
+    queue->priority = priority;
+    halide_mutex_lock(&queue->mutex);
+    init_work_queue_already_locked(queue);
+    halide_mutex_unlock(&queue->mutex);
+    return (halide_thread_pool *)queue;
+}
 
-    // Tidy up
-    halide_mutex_destroy(&work_queue.mutex);
-    halide_cond_destroy(&work_queue.wakeup_owners);
-    halide_cond_destroy(&work_queue.wakeup_a_team);
-    halide_cond_destroy(&work_queue.wakeup_b_team);
-    work_queue.initialized = false;
+WEAK void halide_destroy_thread_pool(halide_thread_pool *pool) {
+    if (!pool) return;
+    work_queue_t *queue = (work_queue_t *)pool;
+    halide_mutex_lock(&thread_pool_bindings.mutex);
+    unbind_work_queue_already_locked(NULL, queue);
+    halide_mutex_unlock(&thread_pool_bindings.mutex);
+    shutdown_work_queue(queue);
+    free(queue);
+}
+
+WEAK int halide_set_thread_pool(void *user_context, halide_thread_pool *pool) {
+    work_queue_t *queue = (work_queue_t *)pool;
+    int result = 0;
+    halide_mutex_lock(&thread_pool_bindings.mutex);
+    unbind_work_queue_already_locked(user_context, NULL);
+    if (queue) {
+        if (thread_pool_bindings.count == thread_pool_bindings.capacity) {
+            int capacity = thread_pool_bindings.capacity ? thread_pool_bindings.capacity * 2 : 8;
+            thread_pool_binding_t *bindings =
+                (thread_pool_binding_t *)malloc(capacity * sizeof(thread_pool_binding_t));
+            if (bindings) {
+                if (thread_pool_bindings.bindings) {
+                    memcpy(bindings, thread_pool_bindings.bindings,
+                           thread_pool_bindings.count * sizeof(thread_pool_binding_t));
+                    free(thread_pool_bindings.bindings);
+                }
+                thread_pool_bindings.bindings = bindings;
+                thread_pool_bindings.capacity = capacity;
+            }
+        }
+        if (thread_pool_bindings.count < thread_pool_bindings.capacity) {
+            thread_pool_binding_t b = {user_context, queue};
+            thread_pool_bindings.bindings[thread_pool_bindings.count] = b;
+            __atomic_store_n(&thread_pool_bindings.count, thread_pool_bindings.count + 1, __ATOMIC_RELEASE);
+        } else {
+            result = halide_error_code_out_of_memory;
+        }
+    }
+    halide_mutex_unlock(&thread_pool_bindings.mutex);
+    return result;
 }
 
 }
@@ -26,6 +26,9 @@ extern WIN32API void DeleteCriticalSection(CriticalSection *);
 extern WIN32API void EnterCriticalSection(CriticalSection *);
 extern WIN32API void LeaveCriticalSection(CriticalSection *);
 extern WIN32API int32_t WaitForSingleObject(Thread, int32_t timeout);
+extern WIN32API Thread GetCurrentThread();
+extern WIN32API bool SetThreadPriority(Thread, int);
+extern WIN32API bool SwitchToThread();
 extern WIN32API bool InitOnceExecuteOnce(InitOnce *, bool WIN32API (*f)(InitOnce *, void *, void **), void *, void **);
 
 } // extern "C"
@@ -112,6 +115,20 @@ WEAK void halide_cond_wait(struct halide_cond *cond_arg, struct halide_mutex *mu
     SleepConditionVariableCS(cond, &mutex->critical_section, -1);
 }
 
+WEAK void halide_set_current_thread_priority(int priority) {
+    // Clamp to THREAD_PRIORITY_LOWEST..THREAD_PRIORITY_HIGHEST
+    if (priority < -2) {
+        priority = -2;
+    } else if (priority > 2) {
+        priority = 2;
+    }
+    SetThreadPriority(GetCurrentThread(), priority);
+}
+
+WEAK void halide_thread_yield() {
+    SwitchToThread();
+}
+
 WEAK int halide_host_cpu_count() {
     // Apparently a standard windows environment variable
     char *num_cores = getenv("NUMBER_OF_PROCESSORS");
@@ -0,0 +1,9 @@
+; These only require AVX-512F, so they are linked for any AVX-512
+; target. See x86_avx512_skylake.ll for the ones that need AVX-512BW.
+
+declare <16 x i16> @llvm.x86.avx512.mask.pmovs.dw.512(<16 x i32>, <16 x i16>, i16)
+
+define weak_odr <16 x i16> @packssdwx16(<16 x i32> %arg) nounwind alwaysinline {
+  %1 = tail call <16 x i16> @llvm.x86.avx512.mask.pmovs.dw.512(<16 x i32> %arg, <16 x i16> zeroinitializer, i16 -1)
+  ret <16 x i16> %1
+}
@@ -19,7 +19,8 @@ WEAK CpuFeatures halide_get_cpu_features() {
                             (1ULL << halide_target_feature_avx512) |
                             (1ULL << halide_target_feature_avx512_knl) |
                             (1ULL << halide_target_feature_avx512_skylake) |
-                            (1ULL << halide_target_feature_avx512_cannonlake));                            
+                            (1ULL << halide_target_feature_avx512_cannonlake) |
+                            (1ULL << halide_target_feature_avx512_vnni));                            
 
     uint64_t available = 0;
 
@@ -57,6 +58,7 @@ WEAK CpuFeatures halide_get_cpu_features() {
         const uint32_t avx512bw = 1U << 30;
         const uint32_t avx512vl = 1U << 31;
         const uint32_t avx512ifma = 1U << 21;
+        const uint32_t avx512vnni = 1U << 11; // In ecx, not ebx
         const uint32_t avx512 = avx512f | avx512cd;
         const uint32_t avx512_knl = avx512 | avx512pf | avx512er;
         const uint32_t avx512_skylake = avx512 | avx512vl | avx512bw | avx512dq;
@@ -75,6 +77,9 @@ WEAK CpuFeatures halide_get_cpu_features() {
             if ((info2[1] & avx512_cannonlake) == avx512_cannonlake) {
                 available |= 1ULL << halide_target_feature_avx512_cannonlake;
             }
+            if ((info2[2] & avx512vnni) == avx512vnni) {
+                available |= 1ULL << halide_target_feature_avx512_vnni;
+            }
         }
     }
     CpuFeatures features = {known, available};
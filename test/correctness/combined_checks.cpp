@@ -0,0 +1,80 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <string>
+
+using namespace Halide;
+
+// The runtime checks on inputs are combined into a single test, which
+// only on failure goes back through the individual checks. Check that
+// the error reported is still the specific one that failed.
+
+std::string last_error;
+void my_error(void *, const char *msg) {
+    last_error = msg;
+}
+
+int main(int argc, char **argv) {
+    const int num_inputs = 8, size = 64;
+
+    std::vector<ImageParam> inputs;
+    for (int i = 0; i < num_inputs; i++) {
+        inputs.push_back(ImageParam(Int(32), 1, "input_" + std::to_string(i)));
+    }
+    Param<int> offset("offset", 0, 0, 8);
+
+    Var x;
+    Func f;
+    Expr e = 0;
+    for (const ImageParam &in : inputs) {
+        e += in(x + offset);
+    }
+    f(x) = e;
+    f.set_error_handler(&my_error);
+
+    std::vector<Buffer<int>> buffers;
+    for (int i = 0; i < num_inputs; i++) {
+        buffers.push_back(Buffer<int>(size + 8));
+        buffers.back().fill(i);
+        inputs[i].set(buffers.back());
+    }
+
+    // Everything in bounds.
+    offset.set(8);
+    Buffer<int> out = f.realize(size);
+    if (!last_error.empty()) {
+        printf("Unexpected error: %s\n", last_error.c_str());
+        return -1;
+    }
+    for (int i = 0; i < size; i++) {
+        int correct = num_inputs * (num_inputs - 1) / 2;
+        if (out(i) != correct) {
+            printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+            return -1;
+        }
+    }
+
+    // Make each input in turn too small.
+    Buffer<int> small(size);
+    for (int i = 0; i < num_inputs; i++) {
+        inputs[i].set(small);
+        last_error.clear();
+        f.realize(size);
+        if (last_error.find("input_" + std::to_string(i)) == std::string::npos) {
+            printf("Expected an error about input_%d, but got: %s\n", i, last_error.c_str());
+            return -1;
+        }
+        inputs[i].set(buffers[i]);
+    }
+
+    // A scalar parameter out of range.
+    offset.set(9);
+    last_error.clear();
+    f.realize(size);
+    if (last_error.find("offset") == std::string::npos) {
+        printf("Expected an error about offset, but got: %s\n", last_error.c_str());
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
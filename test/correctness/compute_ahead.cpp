@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <algorithm>
+#include "Halide.h"
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+const int W = 96, H = 8, tile = 16;
+
+int count = 0;
+int last_f_x[H];
+bool ahead = true;
+
+// Records which values of f have been computed.
+extern "C" DLLEXPORT int record_f(int x, int y) {
+    count++;
+    last_f_x[y] = std::max(last_f_x[y], x);
+    return x + y;
+}
+HalideExtern_2(int, record_f, int, int);
+
+// Checks that f has already been computed for the tile after the one
+// g is working on.
+extern "C" DLLEXPORT int check_g(int x, int y) {
+    int next_tile_end = std::min(tile * (x / tile + 2) - 1, W - 1);
+    if (last_f_x[y] < next_tile_end) {
+        ahead = false;
+    }
+    return 0;
+}
+HalideExtern_2(int, check_g, int, int);
+
+int main(int argc, char **argv) {
+    Var x, y, xo, xi;
+
+    {
+        Func f, g;
+        f(x, y) = record_f(x, y);
+        g(x, y) = f(x, y) * 2 + check_g(x, y);
+
+        g.split(x, xo, xi, tile);
+        f.store_root().compute_at(g, xo).compute_ahead();
+
+        for (int i = 0; i < H; i++) {
+            last_f_x[i] = -1;
+        }
+        Buffer<int> im = g.realize(W, H);
+
+        // Each value of f should be computed exactly once...
+        if (count != W * H) {
+            printf("f was called %d times instead of %d times\n", count, W * H);
+            return -1;
+        }
+
+        // ...one tile ahead of g.
+        if (!ahead) {
+            printf("f was not computed ahead of g\n");
+            return -1;
+        }
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = (x + y) * 2;
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // Stage overlapping tiles of an input one tile ahead.
+        ImageParam input(Int(32), 2);
+        Func staged = input.in(), g;
+        g(x, y) = staged(x, y) + staged(x + 1, y);
+
+        g.split(x, xo, xi, tile);
+        staged.store_at(g, y).compute_at(g, xo).compute_ahead();
+
+        Buffer<int> in(W + 1, H);
+        in.for_each_element([&](int x, int y) { in(x, y) = x * 3 + y; });
+        input.set(in);
+
+        Buffer<int> im = g.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = in(x, y) + in(x + 1, y);
+                if (im(x, y) != correct) {
+                    printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace Halide;
+using namespace Halide::ConciseCasts;
+using namespace Halide::Internal;
+
+// Different ways of writing the same fixed-point operation should all
+// be rewritten to the same intrinsic, and compute the same thing.
+
+class CountIntrinsic : public IRVisitor {
+    const std::string name;
+public:
+    int count;
+
+    CountIntrinsic(const std::string &name) : name(name), count(0) {}
+
+protected:
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        if (op->is_intrinsic(name.c_str())) {
+            count++;
+        }
+        IRVisitor::visit(op);
+    }
+};
+
+class CheckIntrinsic : public IRMutator {
+    const std::string name;
+public:
+    CheckIntrinsic(const std::string &name) : name(name) {}
+    using IRMutator::mutate;
+
+    Stmt mutate(Stmt s) {
+        CountIntrinsic c(name);
+        s.accept(&c);
+        if (c.count == 0) {
+            printf("Expected a call to %s in:\n", name.c_str());
+            std::cout << s << "\n";
+            exit(-1);
+        }
+        return s;
+    }
+};
+
+template<typename T>
+int check(Expr e, const std::string &intrinsic, std::function<T(int, int)> correct) {
+    Var x, y;
+    Func f;
+    f(x, y) = e;
+    f.vectorize(x, 16);
+    f.add_custom_lowering_pass(new CheckIntrinsic(intrinsic));
+
+    Buffer<T> out = f.realize(256, 256);
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            T c = correct(x, y);
+            if (out(x, y) != c) {
+                printf("%s: out(%d, %d) = %d instead of %d\n",
+                       intrinsic.c_str(), x, y, (int)out(x, y), (int)c);
+                exit(-1);
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+    Expr u8_x = cast<uint8_t>(x), u8_y = cast<uint8_t>(y);
+    Expr i8_x = cast<int8_t>(x), i8_y = cast<int8_t>(y);
+    Expr i16_x = cast<int16_t>(x * 257), i16_y = cast<int16_t>(y * 131);
+
+    auto u8_add_sat = [](int x, int y) { return (uint8_t)std::min((uint8_t)x + (uint8_t)y, 255); };
+    check<uint8_t>(u8_sat(cast<uint16_t>(u8_x) + u8_y), Call::saturating_add, u8_add_sat);
+    check<uint8_t>(cast<uint8_t>(min(cast<int32_t>(u8_x) + u8_y, 255)), Call::saturating_add, u8_add_sat);
+
+    auto i8_sub_sat = [](int x, int y) {
+        return (int8_t)std::max(std::min((int8_t)x - (int8_t)y, 127), -128);
+    };
+    check<int8_t>(i8_sat(cast<int16_t>(i8_x) - i8_y), Call::saturating_sub, i8_sub_sat);
+    check<int8_t>(cast<int8_t>(clamp(cast<int32_t>(i8_x) - i8_y, -128, 127)), Call::saturating_sub, i8_sub_sat);
+
+    auto u8_rounding_avg = [](int x, int y) { return (uint8_t)(((uint8_t)x + (uint8_t)y + 1) / 2); };
+    check<uint8_t>(cast<uint8_t>((cast<uint16_t>(u8_x) + u8_y + 1) / 2), Call::rounding_halving_add, u8_rounding_avg);
+    check<uint8_t>(cast<uint8_t>((cast<uint16_t>(u8_x) + u8_y + 1) >> 1), Call::rounding_halving_add, u8_rounding_avg);
+
+    auto i8_avg = [](int x, int y) { return (int8_t)(((int8_t)x + (int8_t)y) >> 1); };
+    check<int8_t>(cast<int8_t>((cast<int16_t>(i8_x) + i8_y) / 2), Call::halving_add, i8_avg);
+    check<int8_t>(cast<int8_t>((cast<int32_t>(i8_x) + i8_y) >> 1), Call::halving_add, i8_avg);
+
+    auto i16_mul_hi = [](int x, int y) {
+        return (int16_t)(((int32_t)(int16_t)(x * 257) * (int16_t)(y * 131)) >> 16);
+    };
+    check<int16_t>(cast<int16_t>((cast<int32_t>(i16_x) * i16_y) / 65536), Call::mul_hi, i16_mul_hi);
+    check<int16_t>(cast<int16_t>((cast<int32_t>(i16_x) * i16_y) >> 16), Call::mul_hi, i16_mul_hi);
+
+    auto u8_narrow = [](int x, int y) { return (uint8_t)std::min(x * y, 255); };
+    check<uint8_t>(u8_sat(cast<uint32_t>(x * y)), Call::saturating_narrow, u8_narrow);
+
+    auto i32_widening_mul = [](int x, int y) { return (int32_t)(int16_t)(x * 257) * (int16_t)(y * 131); };
+    check<int32_t>(cast<int32_t>(i16_x) * i16_y, Call::widening_mul, i32_widening_mul);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -42,6 +42,103 @@ void test_round_trip(Buffer<T> buf, std::string format) {
     }
 }
 
+// Save a buffer, map it back in with load_mapped, and check that it
+// matches without going through a conversion.
+template<typename T>
+void test_mapped(Buffer<T> buf, std::string format) {
+    std::ostringstream o;
+    o << Internal::get_test_tmp_dir() << "test_mapped_" << halide_type_of<T>() << "x" << buf.channels() << "." << format;
+    std::string filename = o.str();
+    Tools::save_image(buf, filename);
+
+    Buffer<T> mapped = Tools::load_mapped_image(filename);
+    for (int d = 0; d < buf.dimensions(); ++d) {
+        mapped.translate(d, buf.dim(d).min() - mapped.dim(d).min());
+    }
+    buf.for_each_element([&](const int *pos) {
+        if (buf(pos) != mapped(pos)) {
+            printf("test_mapped: Mismatch when saved and mapped as %s\n", format.c_str());
+            abort();
+        }
+    });
+
+    // Writes to the mapping are private to it.
+    mapped.fill(0);
+    Buffer<T> remapped = Tools::load_mapped_image(filename);
+    if (remapped.data()[0] != buf(buf.dim(0).min(), buf.dim(1).min(), buf.dim(2).min(), 0)) {
+        printf("test_mapped: Writes to a mapped %s file reached the file\n", format.c_str());
+        abort();
+    }
+
+    // Raw data, such as the payload of a .tmp file.
+    if (format == "tmp") {
+        Buffer<T> raw;
+        std::vector<int> sizes;
+        for (int d = 0; d < buf.dimensions(); ++d) {
+            sizes.push_back(buf.dim(d).extent());
+        }
+        if (!Tools::load_mapped_raw(filename, halide_type_of<T>(), sizes, 5 * sizeof(int32_t), &raw)) {
+            printf("test_mapped: load_mapped_raw failed\n");
+            abort();
+        }
+        if (raw.data()[raw.number_of_elements() - 1] != buf(buf.dim(0).max(), buf.dim(1).max(), buf.dim(2).max(), buf.dim(3).max())) {
+            printf("test_mapped: Mismatch when mapped as raw data\n");
+            abort();
+        }
+    }
+}
+
+// Save a buffer, then read it back and write it out again in bands of
+// rows with ImageStreamReader and ImageStreamWriter.
+template<typename T>
+void test_streaming(Buffer<T> buf, std::string format) {
+    std::ostringstream o;
+    o << Internal::get_test_tmp_dir() << "test_streaming_" << halide_type_of<T>() << "x" << buf.channels() << "." << format;
+    std::string filename = o.str();
+    Tools::save_image(buf, filename);
+
+    std::ostringstream o2;
+    o2 << Internal::get_test_tmp_dir() << "test_streaming_copy_" << halide_type_of<T>() << "x" << buf.channels() << "." << format;
+    std::string copy_filename = o2.str();
+
+    Tools::ImageStreamReader<Buffer<T>, Tools::Internal::CheckFail> reader;
+    reader.open(filename);
+    Tools::ImageStreamWriter<Buffer<T>, Tools::Internal::CheckFail> writer;
+    writer.open(copy_filename, reader.type(), reader.extents());
+
+    // Overlapping bands, as a stencil would read them.
+    const int height = reader.extents()[1], band_rows = 100, overlap = 3;
+    for (int y = 0; y < height; y += band_rows) {
+        int y0 = std::max(0, y - overlap);
+        int y1 = std::min(height, y + band_rows + overlap);
+        Buffer<T> band;
+        reader.read_rows(y0, y1 - y0, &band);
+        band.for_each_element([&](const int *pos) {
+            std::vector<int> p(pos, pos + buf.dimensions());
+            for (int d = 0; d < buf.dimensions(); ++d) {
+                p[d] += buf.dim(d).min();
+            }
+            if (band(pos) != buf(p.data())) {
+                printf("test_streaming: Mismatch when reading %s in bands\n", format.c_str());
+                abort();
+            }
+        });
+        band.crop(1, y, std::min(band_rows, height - y));
+        writer.write_rows(band);
+    }
+
+    Buffer<T> reloaded = Tools::load_image(copy_filename);
+    for (int d = 0; d < buf.dimensions(); ++d) {
+        reloaded.translate(d, buf.dim(d).min() - reloaded.dim(d).min());
+    }
+    buf.for_each_element([&](const int *pos) {
+        if (buf(pos) != reloaded(pos)) {
+            printf("test_streaming: Mismatch when writing %s in bands\n", format.c_str());
+            abort();
+        }
+    });
+}
+
 // static -> static conversion test
 template<typename T>
 void test_convert_image_s2s(Buffer<T> buf) {
@@ -181,7 +278,7 @@ void do_test() {
     luma_buf.copy_from(color_buf);
     luma_buf.slice(2, 0);
 
-    std::vector<std::string> formats = {"ppm","pgm","tmp"};
+    std::vector<std::string> formats = {"ppm","pgm","tmp","npy"};
 #ifndef HALIDE_NO_JPEG
     formats.push_back("jpg");
 #endif
@@ -198,17 +295,33 @@ void do_test() {
             Buffer<T> cb4 = color_buf.embedded(color_buf.dimensions(), 0);
             std::cout << "Testing format: " << format << " for " << halide_type_of<T>() << "x4\n";
             test_round_trip(cb4, format);
+            test_mapped(cb4, format);
+            test_streaming(cb4, format);
+            continue;
+        }
+        if (format == "npy") {
+            std::cout << "Testing format: " << format << " for " << halide_type_of<T>() << "x3\n";
+            test_round_trip(color_buf, format);
+            Buffer<T> cb4 = color_buf.embedded(color_buf.dimensions(), 0);
+            test_mapped(cb4, format);
+            test_streaming(color_buf, format);
             continue;
         }
         if (format != "pgm") {
             std::cout << "Testing format: " << format << " for " << halide_type_of<T>() << "x3\n";
             // pgm really only supports gray images.
             test_round_trip(color_buf, format);
+            if (format != "jpg") {
+                test_streaming(color_buf, format);
+            }
         }
         if (format != "ppm") {
             std::cout << "Testing format: " << format << " for " << halide_type_of<T>() << "x1\n";
             // ppm really only supports RGB images.
             test_round_trip(luma_buf, format);
+            if (format == "pgm") {
+                test_streaming(luma_buf, format);
+            }
         }
     }
 }
@@ -0,0 +1,152 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+
+#include "test/common/halide_test_dirs.h"
+
+using namespace Halide;
+
+// Four-way unrolled 8-bit dot products accumulated into 32-bit
+// integers are lowered to dedicated instructions on some targets
+// (vpdpbusd with AVX512_VNNI, sdot/udot with ARMDotProd), as are sums
+// over an RDom vectorized by a multiple of four. Check that the results
+// are right for all mixes of signedness.
+
+// A dot product of each column of m with v, over an RDom vectorized
+// by vec.
+template<typename A, typename B>
+Func rdom_dot_product(Buffer<A> m, Buffer<B> v, int vec) {
+    Func h;
+    Var x;
+    RDom r(0, v.width());
+    h(x) = 0;
+    h(x) += cast<int>(m(r, x)) * cast<int>(v(r));
+    h.update().vectorize(r, vec);
+    return h;
+}
+
+template<typename A, typename B>
+bool test(int vec) {
+    const int W = 64, K = 32;
+
+    // Weights stored in the blocked layout used by int8 matrix
+    // multiplies: a(4*x + j, k) is the j'th of four consecutive
+    // reduction taps for output x.
+    Buffer<A> a(4*W, K);
+    Buffer<B> b(4*K), c(4*W);
+    a.for_each_value([](A &v) {v = (A)rand();});
+    b.for_each_value([](B &v) {v = (B)rand();});
+    c.for_each_value([](B &v) {v = (B)rand();});
+
+    Var x;
+    RDom r(0, K);
+
+    // A matrix-vector product. The vector is broadcast across the lanes.
+    Func f;
+    f(x) = 0;
+    Expr acc = f(x);
+    for (int j = 0; j < 4; j++) {
+        acc += cast<int>(a(4*x + j, r)) * cast<int>(b(4*r + j));
+    }
+    f(x) = acc;
+    f.vectorize(x, vec).update().vectorize(x, vec);
+
+    // Products of two vectors in the same layout, reduced in groups of four.
+    Func g;
+    Expr dot = 7;
+    for (int j = 0; j < 4; j++) {
+        dot += cast<int>(a(4*x + j, 0)) * cast<int>(c(4*x + j));
+    }
+    g(x) = dot;
+    g.vectorize(x, vec);
+
+    // The same matrix-vector product, with the reduction innermost.
+    Buffer<A> m(4*K, W);
+    m.for_each_element([&](int k, int x) {m(k, x) = a(4*x + k % 4, k / 4);});
+    Func h = rdom_dot_product(m, b, 4*vec);
+
+    Buffer<int> f_out = f.realize(W);
+    Buffer<int> g_out = g.realize(W);
+    Buffer<int> h_out = h.realize(W);
+
+    for (int x = 0; x < W; x++) {
+        int f_correct = 0;
+        for (int k = 0; k < K; k++) {
+            for (int j = 0; j < 4; j++) {
+                f_correct += (int)a(4*x + j, k) * (int)b(4*k + j);
+            }
+        }
+        int g_correct = 7;
+        for (int j = 0; j < 4; j++) {
+            g_correct += (int)a(4*x + j, 0) * (int)c(4*x + j);
+        }
+        if (f_out(x) != f_correct) {
+            printf("f(%d) = %d instead of %d (vector width %d)\n",
+                   x, f_out(x), f_correct, vec);
+            return false;
+        }
+        if (h_out(x) != f_correct) {
+            printf("h(%d) = %d instead of %d (vector width %d)\n",
+                   x, h_out(x), f_correct, 4*vec);
+            return false;
+        }
+        if (g_out(x) != g_correct) {
+            printf("g(%d) = %d instead of %d (vector width %d)\n",
+                   x, g_out(x), g_correct, vec);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check that the vectorized RDom reduction uses the given instruction
+// when compiled for the given target.
+template<typename A, typename B>
+bool check_assembly(const char *target, const char *instruction) {
+    Buffer<A> m(256, 16);
+    Buffer<B> v(256);
+    Func h = rdom_dot_product(m, v, 64);
+
+    std::string filename = Internal::get_test_tmp_dir() + "int8_dot_product.s";
+    h.compile_to_assembly(filename, {}, "h", Target(target));
+    std::ifstream asm_file(filename);
+    std::stringstream contents;
+    contents << asm_file.rdbuf();
+    if (contents.str().find(instruction) == std::string::npos) {
+        printf("A vectorized RDom dot product didn't use %s on %s\n", instruction, target);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    #if LLVM_VERSION >= 60
+    // Only check the assembly for architectures LLVM was surely built
+    // for.
+    Target host = get_host_target();
+    if (host.arch == Target::X86 && host.bits == 64) {
+        if (!check_assembly<uint8_t, int8_t>("x86-64-linux-avx512_skylake-avx512_vnni", "vpdpbusd") ||
+            !check_assembly<int8_t, uint8_t>("x86-64-linux-avx512_skylake-avx512_vnni", "vpdpbusd")) {
+            return -1;
+        }
+    } else if (host.arch == Target::ARM && host.bits == 64) {
+        if (!check_assembly<int8_t, int8_t>("arm-64-linux-arm_dot_prod", "sdot") ||
+            !check_assembly<uint8_t, uint8_t>("arm-64-linux-arm_dot_prod", "udot")) {
+            return -1;
+        }
+    }
+    #endif
+
+    for (int vec : {4, 8, 16, 32}) {
+        if (!test<uint8_t, int8_t>(vec) ||
+            !test<int8_t, uint8_t>(vec) ||
+            !test<int8_t, int8_t>(vec) ||
+            !test<uint8_t, uint8_t>(vec)) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
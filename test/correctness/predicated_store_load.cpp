@@ -113,6 +113,41 @@ int vectorized_predicated_store_scalarized_predicated_load_test() {
     return 0;
 }
 
+int vectorized_predicated_narrow_type_test() {
+    Var x("x"), y("y");
+    Func f ("f"), g("g"), ref("ref");
+
+    g(x, y) = cast<uint8_t>(x + y);
+    g.compute_root();
+
+    RDom r(0, 100, 0, 100);
+    r.where(r.x + r.y < r.x*r.y);
+
+    ref(x, y) = cast<uint8_t>(10);
+    ref(r.x, r.y) += g(r.x, r.y) * 3;
+    Buffer<uint8_t> im_ref = ref.realize(170, 170);
+
+    f(x, y) = cast<uint8_t>(10);
+    f(r.x, r.y) += g(r.x, r.y) * 3;
+
+    Target target = get_jit_target_from_environment();
+    if (target.features_any_of({Target::HVX_64, Target::HVX_128})) {
+        f.update(0).hexagon().vectorize(r.x, 128);
+    } else if (target.arch == Target::X86) {
+        // Only AVX-512BW has masked loads and stores of 8-bit elements.
+        bool masked = target.features_any_of({Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+        f.update(0).vectorize(r.x, 64);
+        f.add_custom_lowering_pass(new CheckPredicatedStoreLoad(masked, masked));
+    }
+
+    Buffer<uint8_t> im = f.realize(170, 170);
+    auto func = [im_ref](int x, int y, int z) { return im_ref(x, y, z); };
+    if (check_image(im, func)) {
+        return -1;
+    }
+    return 0;
+}
+
 int vectorized_dense_load_with_stride_minus_one_test() {
     int size = 73;
     Var x("x"), y("y");
@@ -404,6 +439,11 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    printf("Running vectorized predicated narrow type test\n");
+    if (vectorized_predicated_narrow_type_test() != 0) {
+        return -1;
+    }
+
     printf("Running scalar load test\n");
     if (scalar_load_test() != 0) {
         return -1;
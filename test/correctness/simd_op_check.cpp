@@ -39,6 +39,8 @@ struct Task {
     string name;
     int vector_width;
     Expr expr;
+    // If set, the op must not appear in the assembly.
+    bool absent;
 };
 
 size_t num_threads = Halide::Internal::ThreadPool<void>::num_processors_online();
@@ -49,6 +51,7 @@ struct Test {
     bool use_avx512_cannonlake{false};
     bool use_avx512_knl{false};
     bool use_avx512_skylake{false};
+    bool use_avx512_vnni{false};
     bool use_avx{false};
     bool use_power_arch_2_07{false};
     bool use_sse41{false};
@@ -85,6 +88,7 @@ struct Test {
         use_avx512_cannonlake = target.has_feature(Target::AVX512_Cannonlake);
         use_avx512_skylake = use_avx512_cannonlake || target.has_feature(Target::AVX512_Skylake);
         use_avx512 = use_avx512_knl || use_avx512_skylake || use_avx512_cannonlake || target.has_feature(Target::AVX512);
+        use_avx512_vnni = use_avx512 && target.has_feature(Target::AVX512_VNNI);
         use_avx2 = use_avx512 || target.has_feature(Target::AVX2);
         use_avx = use_avx2 || target.has_feature(Target::AVX);
         use_sse41 = use_avx || target.has_feature(Target::SSE41);
@@ -137,10 +141,10 @@ struct Test {
         // A bunch of feature flags also need to match between the
         // compiled code and the host in order to run the code.
         for (Target::Feature f : {Target::SSE41, Target::AVX,
-                    Target::AVX2, Target::AVX512,
+                    Target::AVX2, Target::AVX512, Target::AVX512_VNNI,
                     Target::FMA, Target::FMA4, Target::F16C,
                     Target::VSX, Target::POWER_ARCH_2_07,
-                    Target::ARMv7s, Target::NoNEON, Target::MinGW}) {
+                    Target::ARMv7s, Target::ARMDotProd, Target::NoNEON, Target::MinGW}) {
             if (target.has_feature(f) != host_target.has_feature(f)) {
                 can_run_the_code = false;
             }
@@ -188,7 +192,7 @@ struct Test {
         return wildcard_match("*" + p + "*", str);
     }
 
-    TestResult check_one(const string &op, const string &name, int vector_width, Expr e) const {
+    TestResult check_one(const string &op, const string &name, int vector_width, Expr e, bool absent) const {
         std::ostringstream error_msg;
 
         // Define a vectorized Func that uses the pattern.
@@ -219,7 +223,11 @@ struct Test {
             bool found_it = false;
 
             std::ostringstream msg;
-            msg << op << " did not generate. Instead we got:\n";
+            if (absent) {
+                msg << op << " was generated, but should not have been:\n";
+            } else {
+                msg << op << " did not generate. Instead we got:\n";
+            }
 
             string line;
             while (getline(asm_file, line)) {
@@ -229,7 +237,7 @@ struct Test {
                 found_it |= wildcard_search(op, line) && !wildcard_search("_" + op, line);
             }
 
-            if (!found_it) {
+            if (found_it == absent) {
                 error_msg << "Failed: " << msg.str() << "\n";
             }
 
@@ -256,7 +264,7 @@ struct Test {
         return { op, error_msg.str() };
     }
 
-    void check(string op, int vector_width, Expr e) {
+    void check(string op, int vector_width, Expr e, bool absent = false) {
         // Make a name for the test by uniquing then sanitizing the op name
         string name = "op_" + op;
         for (size_t i = 0; i < name.size(); i++) {
@@ -270,7 +278,13 @@ struct Test {
         // settings.
         if (!wildcard_match(filter, op)) return;
 
-        tasks.emplace_back(Task {op, name, vector_width, e});
+        tasks.emplace_back(Task {op, name, vector_width, e, absent});
+    }
+
+    // Check that op is not generated for e, e.g. because the target
+    // lacks the instruction.
+    void check_not(string op, int vector_width, Expr e) {
+        check(op, vector_width, e, true);
     }
 
     void check_sse_all() {
@@ -602,8 +616,8 @@ struct Test {
             check("vpsubq" YMM, 8, i64_1 - i64_2);
             check(use_avx512_skylake ? "vpmullq" : "vpmuludq", 8, u64_1 * u64_2);
 
-            check("vpackssdw", 16, i16_sat(i32_1));
-            check("vpacksswb", 32, i8_sat(i16_1));
+            check(use_avx512 ? "vpmovsdw" : "vpackssdw", 16, i16_sat(i32_1));
+            check(use_avx512_skylake ? "vpmovswb" : "vpacksswb", 32, i8_sat(i16_1));
             check("vpackuswb", 32, u8_sat(i16_1));
 
             check("vpabsb", 32, abs(i8_1));
@@ -651,12 +665,43 @@ struct Test {
 #endif
         }
         if (use_avx512_skylake) {
+            check("vpaddsb*zmm", 64, i8_sat(i16(i8_1) + i16(i8_2)));
+            check("vpsubsb*zmm", 64, i8_sat(i16(i8_1) - i16(i8_2)));
+            check("vpaddusb*zmm", 64, u8(min(u16(u8_1) + u16(u8_2), max_u8)));
+            check("vpsubusb*zmm", 64, u8(max(i16(u8_1) - i16(u8_2), 0)));
+            check("vpaddsw*zmm", 32, i16_sat(i32(i16_1) + i32(i16_2)));
+            check("vpsubsw*zmm", 32, i16_sat(i32(i16_1) - i32(i16_2)));
+            check("vpaddusw*zmm", 32, u16(min(u32(u16_1) + u32(u16_2), max_u16)));
+            check("vpsubusw*zmm", 32, u16(max(i32(u16_1) - i32(u16_2), 0)));
+            check("vpmulhw*zmm", 32, i16((i32(i16_1) * i32(i16_2)) / (256*256)));
+            check("vpmulhuw*zmm", 32, u16((u32(u16_1) * u32(u16_2)) / (256*256)));
+            check("vpavgb*zmm", 64, u8((u16(u8_1) + u16(u8_2) + 1)/2));
+            check("vpavgw*zmm", 32, u16((u32(u16_1) + u32(u16_2) + 1)/2));
+            check("vpmovswb", 64, i8_sat(i16_1));
+            check("vpmaddwd*zmm", 16, i32(i16_1) * 3 + i32(i16_2) * 4);
+
             check("vpabsq", 8, abs(i64_1));
             check("vpmaxuq", 8, max(u64_1, u64_2));
             check("vpminuq", 8, min(u64_1, u64_2));
             check("vpmaxsq", 8, max(i64_1, i64_2));
             check("vpminsq", 8, min(i64_1, i64_2));
+        } else if (use_avx512) {
+            // The 512-bit vpmaddwd needs AVX-512BW.
+            check_not("vpmaddwd*zmm", 16, i32(i16_1) * 3 + i32(i16_2) * 4);
+        }
+        #if LLVM_VERSION >= 60
+        if (use_avx512_vnni) {
+            // A four-way unrolled u8 x i8 dot product
+            Expr dot = i32_1;
+            for (int k = 0; k < 4; k++) {
+                dot += i32(in_u8(4*x + k)) * i32(in_i8(4*x + k));
+            }
+            check("vpdpbusd*zmm", 16, dot);
+            if (use_avx512_skylake) {
+                check("vpdpbusd*ymm", 8, dot);
+            }
         }
+        #endif
     }
 
     void check_neon_all() {
@@ -1427,6 +1472,21 @@ struct Test {
         // Interleave or deinterleave two vectors. Given that we use
         // interleaving loads and stores, it's hard to hit this op with
         // halide.
+
+        #if LLVM_VERSION >= 60
+        if (!arm32 && target.has_feature(Target::ARMDotProd)) {
+            // Four-way unrolled int8 dot products
+            Expr sdot = i32_1, udot = i32_1;
+            for (int k = 0; k < 4; k++) {
+                sdot += i32(in_i8(4*x + k)) * i32(in_i8(4*x + k + 32));
+                udot += i32(in_u8(4*x + k)) * i32(in_u8(4*x + k + 32));
+            }
+            for (int w = 1; w <= 4; w++) {
+                check("sdot", 2*w, sdot);
+                check("udot", 2*w, udot);
+            }
+        }
+        #endif
     }
 
     void check_hvx_all() {
@@ -2074,7 +2134,7 @@ check("v*.w += vrmpy(v*.b,v*.b)", hvx_width, i32_1 + i32(i8_1)*i8_1 + i32(i8_2)*
         std::vector<std::future<TestResult>> futures;
         for (const Task &task : tasks) {
             futures.push_back(pool.async([this, task]() {
-                return check_one(task.op, task.name, task.vector_width, task.expr);
+                return check_one(task.op, task.name, task.vector_width, task.expr, task.absent);
             }));
         }
 
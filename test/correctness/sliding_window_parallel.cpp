@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <atomic>
+#include "Halide.h"
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+std::atomic<int> count;
+extern "C" DLLEXPORT int call_counter(int x, int y) {
+    count++;
+    return 0;
+}
+HalideExtern_2(int, call_counter, int, int);
+
+int check(Func g, int w, int h, int expected_count) {
+    count = 0;
+    Buffer<int> im = g.realize(w, h);
+
+    if (count != expected_count) {
+        printf("f was called %d times instead of %d times\n", (int)count, expected_count);
+        return -1;
+    }
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int correct = 3 * x + 3 * y;
+            if (im(x, y) != correct) {
+                printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x, y;
+
+    {
+        // Without slide_in_strips, a parallel loop prevents sliding
+        // and each row of g computes three rows of f.
+        Func f, g;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        f.store_root().compute_at(g, y);
+        g.parallel(y);
+
+        if (check(g, 100, 1000, 100 * 1000 * 3) != 0) {
+            return -1;
+        }
+    }
+
+    {
+        // With slide_in_strips, each of the 8 strips only recomputes
+        // the two extra rows of f it needs to warm up.
+        Func f, g;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        f.store_root().compute_at(g, y).slide_in_strips(8);
+        g.parallel(y);
+
+        if (check(g, 100, 1000, 100 * (1000 + 2 * 8)) != 0) {
+            return -1;
+        }
+    }
+
+    {
+        // For a short loop, the warm-up cost limits the number of
+        // strips. Each strip must be at least 16 rows long, so only
+        // two strips are used.
+        Func f, g;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        f.store_root().compute_at(g, y).slide_in_strips(8);
+        g.parallel(y);
+
+        if (check(g, 100, 32, 100 * (32 + 2 * 2)) != 0) {
+            return -1;
+        }
+    }
+
+    {
+        // The strips should also work when the parallel loop is
+        // inside the store level.
+        Func f, g;
+        Var yo, yi;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        g.split(y, yo, yi, 500).parallel(yi);
+        f.store_at(g, yo).compute_at(g, yi).slide_in_strips(4);
+
+        // Two tiles of 500 rows, each split into 4 strips of 125.
+        if (check(g, 10, 1000, 10 * (1000 + 2 * 8)) != 0) {
+            return -1;
+        }
+    }
+
+    {
+        // A ragged extent. The strips are 38 rows long, except for
+        // the last one, which is 36 rows long.
+        Func f, g;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        f.store_root().compute_at(g, y).slide_in_strips(4);
+        g.parallel(y);
+
+        if (check(g, 10, 150, 10 * (150 + 2 * 4)) != 0) {
+            return -1;
+        }
+    }
+
+    {
+        // An empty parallel loop has no strips.
+        Func f, g;
+        f(x, y) = call_counter(x, y) + x + y;
+        g(x, y) = f(x, y - 1) + f(x, y) + f(x, y + 1);
+
+        f.store_root().compute_at(g, y).slide_in_strips(8);
+        g.parallel(y);
+
+        // A zero-sized Buffer has no allocation, so give it some
+        // memory to point to.
+        int data = 0;
+        Buffer<int> im(&data, 10, 0);
+        count = 0;
+        g.realize(im);
+        if (count != 0) {
+            printf("f was called %d times for an empty output\n", (int)count);
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Loads shared between iterations of a stencil are carried across loop
+// iterations in registers by some backends. Check that the results are
+// right for schedules that give them something to carry, and that the
+// transformation actually fires on them.
+
+// Counts the loads from a given Func that happen inside innermost loops.
+class CountInnerLoads : public IRVisitor {
+    using IRVisitor::visit;
+
+    std::string func;
+    bool in_innermost_loop = false;
+
+    class HasLoop : public IRVisitor {
+        using IRVisitor::visit;
+        void visit(const For *op) {
+            result = true;
+        }
+    public:
+        bool result = false;
+    };
+
+    void visit(const For *op) {
+        HasLoop inner;
+        op->body.accept(&inner);
+        bool old = in_innermost_loop;
+        in_innermost_loop = !inner.result;
+        IRVisitor::visit(op);
+        in_innermost_loop = old;
+    }
+
+    void visit(const Load *op) {
+        if (in_innermost_loop && op->name == func) {
+            count++;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    int count = 0;
+    CountInnerLoads(const std::string &f) : func(f) {}
+};
+
+// Runs loop carry on the final lowered Stmt, the way codegen does, and
+// records how many inner loop loads it removed. A budget of 4 carried
+// values of 128-bit vectors is the smallest any CPU backend uses, so
+// the real backends carry at least as much.
+class CheckLoopCarry : public IRMutator {
+    std::string func;
+    int *before, *after;
+public:
+    CheckLoopCarry(const std::string &f, int *b, int *a) : func(f), before(b), after(a) {}
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) {
+        CountInnerLoads b(func), a(func);
+        s.accept(&b);
+        loop_carry(s, 4, 128).accept(&a);
+        *before = b.count;
+        *after = a.count;
+        return s;
+    }
+};
+
+enum Schedule {
+    Rows,
+    ColumnsVectorized,
+    UnrolledRows,
+    UnrolledRowsVectorized,
+};
+
+bool test(Schedule schedule) {
+    const int W = 67, H = 45;
+    Buffer<uint16_t> in(W + 4, H + 4);
+    in.for_each_value([](uint16_t &v) {v = (uint16_t)(rand() & 0xfff);});
+
+    Var x("x"), y("y"), xi("xi"), yi("yi");
+
+    // A consumed producer, so that loads from it can be carried too.
+    Func bounded("bounded");
+    bounded(x, y) = in(x, y) + 1;
+
+    Func blur("blur");
+    Expr sum = cast<uint32_t>(0);
+    for (int dy = 0; dy < 5; dy++) {
+        for (int dx = 0; dx < 5; dx++) {
+            sum += cast<uint32_t>(bounded(x + dx, y + dy)) * (1 + dx + dy);
+        }
+    }
+    blur(x, y) = sum;
+
+    bounded.compute_root();
+    switch (schedule) {
+    case Rows:
+        break;
+    case ColumnsVectorized:
+        blur.reorder(y, x).vectorize(x, 8);
+        break;
+    case UnrolledRows:
+        blur.split(y, y, yi, 4, TailStrategy::GuardWithIf).reorder(yi, x, y).unroll(yi);
+        break;
+    case UnrolledRowsVectorized:
+        blur.split(y, y, yi, 2, TailStrategy::GuardWithIf).reorder(yi, x, y).unroll(yi).vectorize(x, 16);
+        break;
+    }
+
+    int loads_before = 0, loads_after = 0;
+    blur.add_custom_lowering_pass(new CheckLoopCarry(bounded.name(), &loads_before, &loads_after));
+
+    Buffer<uint32_t> out = blur.realize(W, H);
+
+    if (loads_before == 0) {
+        printf("Found no loads of %s in inner loops (schedule %d)\n",
+               bounded.name().c_str(), (int)schedule);
+        return false;
+    }
+    // In the last schedule consecutive iterations of the inner loop load
+    // different vectors, so there is nothing to carry. All the others
+    // must lose loads.
+    bool expect_carry = schedule != UnrolledRowsVectorized;
+    if (expect_carry && loads_after >= loads_before) {
+        printf("Loop carry did not reduce the inner loop loads: %d before, %d after (schedule %d)\n",
+               loads_before, loads_after, (int)schedule);
+        return false;
+    }
+    if (loads_after > loads_before) {
+        printf("Loop carry increased the inner loop loads: %d before, %d after (schedule %d)\n",
+               loads_before, loads_after, (int)schedule);
+        return false;
+    }
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint32_t correct = 0;
+            for (int dy = 0; dy < 5; dy++) {
+                for (int dx = 0; dx < 5; dx++) {
+                    correct += (uint32_t)(in(x + dx, y + dy) + 1) * (1 + dx + dy);
+                }
+            }
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %u instead of %u (schedule %d)\n",
+                       x, y, out(x, y), correct, (int)schedule);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    for (Schedule s : {Rows, ColumnsVectorized, UnrolledRows, UnrolledRowsVectorized}) {
+        if (!test(s)) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <algorithm>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Vectorizing the reduction domain of a simple reduction should
+// reduce across the lanes, and compute the right answer.
+
+class CountVectorReduces : public IRVisitor {
+public:
+    int count;
+
+    CountVectorReduces() : count(0) {}
+
+protected:
+    using IRVisitor::visit;
+
+    void visit(const VectorReduce *op) {
+        count++;
+        IRVisitor::visit(op);
+    }
+};
+
+class CheckVectorReduces : public IRMutator {
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(Stmt s) {
+        CountVectorReduces c;
+        s.accept(&c);
+        if (c.count == 0) {
+            printf("There should be a vector reduction in:\n");
+            std::cout << s << "\n";
+            exit(-1);
+        }
+        return s;
+    }
+};
+
+template<typename T>
+void check(Func f, T correct, bool expect_vector_reduce = true) {
+    if (expect_vector_reduce) {
+        f.add_custom_lowering_pass(new CheckVectorReduces);
+    }
+    Buffer<T> result = f.realize();
+    if (result() != correct) {
+        printf("%s computed %f instead of %f\n",
+               f.name().c_str(), (double)result(), (double)correct);
+        exit(-1);
+    }
+}
+
+int main(int argc, char **argv) {
+    const int N = 1024;
+    Buffer<uint8_t> in_u8(N);
+    Buffer<int> in_i32(N);
+    Buffer<float> in_f32(N);
+    for (int i = 0; i < N; i++) {
+        in_u8(i) = (uint8_t)rand();
+        in_i32(i) = rand() % 2001 - 1000;
+        in_f32(i) = (rand() % 1000) / 8.0f;
+    }
+
+    RDom r(0, N);
+
+    {
+        // An integer sum.
+        Func f("sum_i32");
+        f() = 0;
+        f() += in_i32(r);
+        f.update().vectorize(r, 8);
+        int correct = 0;
+        for (int i = 0; i < N; i++) correct += in_i32(i);
+        check(f, correct);
+    }
+
+    {
+        // A widening sum of bytes.
+        Func f("sum_u8");
+        f() = cast<uint32_t>(0);
+        f() += cast<uint32_t>(in_u8(r));
+        f.update().vectorize(r, 32);
+        uint32_t correct = 0;
+        for (int i = 0; i < N; i++) correct += in_u8(i);
+        check(f, correct);
+    }
+
+    {
+        // A difference.
+        Func f("sub_i32");
+        f() = 17;
+        f() -= in_i32(r);
+        f.update().vectorize(r, 4);
+        int correct = 17;
+        for (int i = 0; i < N; i++) correct -= in_i32(i);
+        check(f, correct);
+    }
+
+    {
+        // A float minimum.
+        Func f("min_f32");
+        f() = in_f32(0);
+        f() = min(f(), in_f32(r));
+        f.update().vectorize(r, 8);
+        float correct = in_f32(0);
+        for (int i = 0; i < N; i++) correct = std::min(correct, in_f32(i));
+        check(f, correct);
+    }
+
+    {
+        // A maximum over a domain that isn't a multiple of the vector width.
+        RDom r2(0, N - 7);
+        Func f("max_u8");
+        f() = cast<uint8_t>(0);
+        f() = max(f(), in_u8(r2));
+        f.update().vectorize(r2, 16);
+        uint8_t correct = 0;
+        for (int i = 0; i < N - 7; i++) correct = std::max(correct, in_u8(i));
+        check(f, correct, false);
+    }
+
+    {
+        // A logical and.
+        Func f("all");
+        f() = cast<bool>(true);
+        f() = f() && (in_u8(r) < 250);
+        f.update().vectorize(r, 16);
+        bool correct = true;
+        for (int i = 0; i < N; i++) correct = correct && (in_u8(i) < 250);
+        check(f, correct);
+    }
+
+    {
+        // A logical or.
+        Func f("any");
+        f() = cast<bool>(false);
+        f() = f() || (in_i32(r) == 999);
+        f.update().vectorize(r, 8);
+        bool correct = false;
+        for (int i = 0; i < N; i++) correct = correct || (in_i32(i) == 999);
+        check(f, correct);
+    }
+
+    {
+        // A sum over a subset of the domain.
+        RDom r2(0, N);
+        r2.where(r2 % 3 == 0);
+        Func f("sum_where");
+        f() = 0;
+        f() += in_i32(r2);
+        f.update().vectorize(r2, 8);
+        int correct = 0;
+        for (int i = 0; i < N; i += 3) correct += in_i32(i);
+        check(f, correct, false);
+    }
+
+    {
+        // A matrix-vector product, with the dot products vectorized.
+        const int M = 64, K = 256;
+        Buffer<int16_t> a(K, M), b(K);
+        a.for_each_value([](int16_t &v) {v = (int16_t)(rand() % 256 - 128);});
+        b.for_each_value([](int16_t &v) {v = (int16_t)(rand() % 256 - 128);});
+
+        Var x;
+        RDom k(0, K);
+        Func f("matvec");
+        f(x) = 0;
+        f(x) += cast<int>(a(k, x)) * b(k);
+        f.update().vectorize(k, 16);
+        f.add_custom_lowering_pass(new CheckVectorReduces);
+
+        Buffer<int> result = f.realize(M);
+        for (int y = 0; y < M; y++) {
+            int correct = 0;
+            for (int i = 0; i < K; i++) correct += a(i, y) * b(i);
+            if (result(y) != correct) {
+                printf("matvec(%d) = %d instead of %d\n", y, result(y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+int num_predicated_stores = 0;
+
+class CountPredicatedStores : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Store *op) {
+        if (!is_one(op->predicate) && op->value.type().is_vector()) {
+            num_predicated_stores++;
+        }
+        IRVisitor::visit(op);
+    }
+};
+
+class CheckPredicatedStores : public IRMutator {
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(Stmt s) {
+        num_predicated_stores = 0;
+        CountPredicatedStores c;
+        s.accept(&c);
+        return s;
+    }
+};
+
+template<typename T>
+int test(int w) {
+    const int v = 16;
+
+    ImageParam input(type_of<T>(), 1);
+    Func f;
+    Var x;
+
+    f(x) = input(x) * 3 + 1;
+    f.vectorize(x, v, TailStrategy::Predicate);
+
+    f.add_custom_lowering_pass(new CheckPredicatedStores);
+
+    Buffer<T> in(w);
+    for (int i = 0; i < w; i++) {
+        in(i) = (T)(i * 7);
+    }
+    input.set(in);
+
+    // Reading the input beyond its extent would be caught by the
+    // bounds checks, so this also checks that the tail doesn't touch
+    // the input past the end.
+    Buffer<T> result = f.realize(w);
+
+    if (num_predicated_stores == 0) {
+        printf("Expected a predicated vector store for the tail\n");
+        return -1;
+    }
+
+    for (int i = 0; i < w; i++) {
+        T correct = (T)(in(i) * 3 + 1);
+        if (result(i) != correct) {
+            printf("result(%d) == %f instead of %f\n",
+                   i, (double)result(i), (double)correct);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.has_gpu_feature() || t.arch == Target::Hexagon) {
+        printf("Not running on this target\n");
+        return 0;
+    }
+
+    // Widths that are not a multiple of the vector size.
+    for (int w : {5, 100, 333}) {
+        if (test<uint8_t>(w) ||
+            test<int16_t>(w) ||
+            test<int32_t>(w) ||
+            test<float>(w) ||
+            test<double>(w)) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <vector>
+
+#include "batch.h"
+
+using namespace Halide::Runtime;
+
+// The batch target feature adds batch_batch, which takes an array of
+// buffers for each buffer argument and runs the pipeline on every item
+// of the batch as one parallel loop.
+
+const int W = 64, H = 64, N = 37;
+
+std::atomic<int> tasks_run(0);
+
+int count_do_task(void *user_context, halide_task_t f, int idx, uint8_t *closure) {
+    tasks_run++;
+    return f(user_context, idx, closure);
+}
+
+int main(int argc, char **argv) {
+    halide_set_custom_do_task(count_do_task);
+
+    std::vector<Buffer<uint8_t>> inputs, outputs;
+    std::vector<halide_buffer_t *> input_ptrs, output_ptrs;
+    for (int i = 0; i < N; i++) {
+        inputs.emplace_back(W, H);
+        inputs.back().for_each_element([&](int x, int y) {
+            inputs.back()(x, y) = (uint8_t)(x * 3 + y * 5 + i * 7);
+        });
+        outputs.emplace_back(W, H);
+        outputs.back().fill(0);
+    }
+    for (int i = 0; i < N; i++) {
+        input_ptrs.push_back(inputs[i].raw_buffer());
+        output_ptrs.push_back(outputs[i].raw_buffer());
+    }
+
+    const int offset = 3;
+    int ret = batch_batch(input_ptrs.data(), offset, output_ptrs.data(), N);
+    if (ret) {
+        printf("Non zero exit code: %d\n", ret);
+        return -1;
+    }
+
+    if (tasks_run != N) {
+        printf("%d tasks were run instead of %d\n", (int)tasks_run, N);
+        return -1;
+    }
+
+    for (int i = 0; i < N; i++) {
+        const Buffer<uint8_t> &in = inputs[i];
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int l = in(std::max(x - 1, 0), y), c = in(x, y), r = in(std::min(x + 1, W - 1), y);
+                uint8_t correct = (uint8_t)((l + 2 * c + r + 2) / 4 + offset);
+                if (outputs[i](x, y) != correct) {
+                    printf("outputs[%d](%d, %d) = %d instead of %d\n",
+                           i, x, y, outputs[i](x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // An empty batch does nothing.
+    if (batch_batch(input_ptrs.data(), offset, output_ptrs.data(), 0)) {
+        printf("An empty batch failed\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include "Halide.h"
+
+namespace {
+
+// A small per-patch filter with a scalar parameter, for exercising
+// the batched entry point emitted for the batch target feature.
+class Batch : public Halide::Generator<Batch> {
+public:
+    Input<Buffer<uint8_t>> input{ "input", 2 };
+    Input<int> offset{ "offset" };
+    Output<Buffer<uint8_t>> output{ "output", 2 };
+
+    void generate() {
+        Func clamped = Halide::BoundaryConditions::repeat_edge(input);
+        output(x, y) = cast<uint8_t>((clamped(x - 1, y) + 2 * clamped(x, y) + clamped(x + 1, y) + 2) / 4 + offset);
+    }
+
+    void schedule() {
+        output.vectorize(x, natural_vector_size<uint8_t>());
+    }
+
+private:
+    Var x, y;
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(Batch, batch)
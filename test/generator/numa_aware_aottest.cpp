@@ -0,0 +1,77 @@
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "numa_aware.h"
+
+using namespace Halide::Runtime;
+
+// The NUMA-aware thread pool gives each node its own share of the
+// iterations of a parallel loop, and lets nodes take from each other's
+// shares once their own runs out. Whatever the topology of the machine
+// running the test, each iteration must still run exactly once.
+
+const int W = 2048, H = 2048;
+
+std::atomic<int> tasks_run(0);
+
+int count_do_task(void *user_context, halide_task_t f, int idx, uint8_t *closure) {
+    tasks_run++;
+    return f(user_context, idx, closure);
+}
+
+int main(int argc, char **argv) {
+    if (halide_set_numa_aware(true)) {
+        printf("NUMA-awareness should be off by default\n");
+        return -1;
+    }
+    halide_set_custom_do_task(count_do_task);
+
+    Buffer<float> input(W, H);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = (float)((x * 17 + y * 31) % 256);
+    });
+    Buffer<float> output(W, H);
+
+    for (int i = 0; i < 4; i++) {
+        output.fill(0.0f);
+        int ret = numa_aware(input, output);
+        if (ret) {
+            printf("Non zero exit code: %d\n", ret);
+            return -1;
+        }
+    }
+
+    // The large intermediate may also be first touched by a parallel
+    // loop, so there are at least this many tasks.
+    if (tasks_run < 4 * 2 * H) {
+        printf("Only %d tasks were run instead of at least %d\n", (int)tasks_run, 4 * 2 * H);
+        return -1;
+    }
+
+    auto in = [&](int x, int y) {
+        return input(std::min(std::max(x, 0), W - 1), std::min(std::max(y, 0), H - 1));
+    };
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            float blur_x[3];
+            for (int dy = -1; dy <= 1; dy++) {
+                blur_x[dy + 1] = (in(x - 1, y + dy) + in(x, y + dy) + in(x + 1, y + dy)) / 3;
+            }
+            float correct = (blur_x[0] + blur_x[1] + blur_x[2]) / 3;
+            if (fabs(output(x, y) - correct) > 1e-3f) {
+                printf("output(%d, %d) = %f instead of %f\n", x, y, output(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    halide_set_numa_aware(false);
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include "Halide.h"
+
+namespace {
+
+// A bandwidth-bound pipeline with a large intermediate, for
+// exercising the NUMA-aware thread pool and allocator.
+class NumaAware : public Halide::Generator<NumaAware> {
+public:
+    Input<Buffer<float>> input{ "input", 2 };
+    Output<Buffer<float>> output{ "output", 2 };
+
+    void generate() {
+        Func clamped = Halide::BoundaryConditions::repeat_edge(input);
+        blur_x(x, y) = (clamped(x - 1, y) + clamped(x, y) + clamped(x + 1, y)) / 3;
+        output(x, y) = (blur_x(x, y - 1) + blur_x(x, y) + blur_x(x, y + 1)) / 3;
+    }
+
+    void schedule() {
+        blur_x.compute_root().parallel(y).vectorize(x, natural_vector_size<float>());
+        output.parallel(y).vectorize(x, natural_vector_size<float>());
+    }
+
+private:
+    Var x, y;
+    Func blur_x;
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(NumaAware, numa_aware)
@@ -0,0 +1,107 @@
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include <atomic>
+#include <stdio.h>
+
+#include "parallel_for_each.h"
+
+using namespace Halide::Runtime;
+
+// The parallel versions of for_each_value, for_each_element and
+// copy_from should go through halide_do_par_for, and so share the
+// thread pool used by the pipeline.
+
+std::atomic<int> par_for_calls(0);
+
+int my_do_par_for(void *user_context, halide_task_t f, int min, int size, uint8_t *closure) {
+    par_for_calls++;
+    return halide_default_do_par_for(user_context, f, min, size, closure);
+}
+
+int main(int argc, char **argv) {
+    halide_set_custom_do_par_for(&my_do_par_for);
+
+    Buffer<float> input(1024, 768, 3);
+    Buffer<float> output(1024, 768, 3);
+    input.fill([](int x, int y, int c) {return (float)(x + y + c);});
+
+    // Normalize the input.
+    par_for_calls = 0;
+    input.parallel_for_each_value([](float &v) {v /= 2048.0f;});
+    if (par_for_calls != 1) {
+        printf("parallel_for_each_value made %d calls to halide_do_par_for\n", (int)par_for_calls);
+        return -1;
+    }
+
+    int ret = parallel_for_each(input, output);
+    if (ret) {
+        printf("Non zero exit code: %d\n", ret);
+        return -1;
+    }
+
+    // Validate the output, counting the sites visited.
+    par_for_calls = 0;
+    std::atomic<int> errors(0), sites(0);
+    output.parallel_for_each_element([&](int x, int y, int c) {
+        float correct = (x + y + c) / 1024.0f;
+        if (output(x, y, c) != correct) {
+            errors++;
+        }
+        sites++;
+    });
+    if (par_for_calls != 1) {
+        printf("parallel_for_each_element made %d calls to halide_do_par_for\n", (int)par_for_calls);
+        return -1;
+    }
+    if (errors != 0) {
+        printf("%d incorrect values in the output\n", (int)errors);
+        return -1;
+    }
+    if ((size_t)sites != output.number_of_elements()) {
+        printf("Visited %d sites instead of %d\n", (int)sites, (int)output.number_of_elements());
+        return -1;
+    }
+
+    // Iterating over only some of the dimensions visits each of those
+    // sites once.
+    sites = 0;
+    output.parallel_for_each_element([&](int x, int y) {sites++;});
+    if (sites != output.width() * output.height()) {
+        printf("Visited %d sites instead of %d\n", (int)sites, output.width() * output.height());
+        return -1;
+    }
+
+    // A value-wise operation over several buffers of different types.
+    Buffer<uint8_t> quantized(1024, 768, 3);
+    quantized.parallel_for_each_value([](uint8_t &q, float v) {q = (uint8_t)(v * 64);}, output);
+    bool ok = true;
+    quantized.for_each_element([&](int x, int y, int c) {
+        ok = ok && quantized(x, y, c) == (uint8_t)(output(x, y, c) * 64);
+    });
+    if (!ok) {
+        printf("Incorrect result from parallel_for_each_value over two buffers\n");
+        return -1;
+    }
+
+    // parallel_copy_from splits a multi-megabyte copy of a crop into
+    // tasks on the same thread pool.
+    Buffer<float> staging(512, 768, 3);
+    staging.set_min(256, 0, 0);
+    par_for_calls = 0;
+    staging.parallel_copy_from(output, 4);
+    if (par_for_calls != 1) {
+        printf("parallel_copy_from made %d calls to halide_do_par_for\n", (int)par_for_calls);
+        return -1;
+    }
+    staging.for_each_element([&](int x, int y, int c) {
+        ok = ok && staging(x, y, c) == output(x, y, c);
+    });
+    if (!ok) {
+        printf("Incorrect result from parallel_copy_from\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
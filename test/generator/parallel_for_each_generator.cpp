@@ -0,0 +1,25 @@
+#include "Halide.h"
+
+namespace {
+
+// Scale an image that the test harness has normalized.
+class ParallelForEach : public Halide::Generator<ParallelForEach> {
+public:
+    Input<Buffer<float>> input{ "input", 3 };
+    Output<Buffer<float>> output{ "output", 3 };
+
+    void generate() {
+        output(x, y, c) = input(x, y, c) * 2.0f;
+    }
+
+    void schedule() {
+        output.parallel(y).vectorize(x, natural_vector_size<float>());
+    }
+
+private:
+    Var x, y, c;
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(ParallelForEach, parallel_for_each)
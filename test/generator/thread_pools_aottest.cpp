@@ -0,0 +1,119 @@
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdio.h>
+#include <thread>
+
+#include "thread_pools.h"
+
+using namespace Halide::Runtime;
+
+// Pipeline invocations are bound to thread pools of their own through
+// their user_context. A pool of one thread runs everything on the
+// calling thread, and a pool larger than the old limit of 64 threads
+// can really run that many tasks at once.
+
+const int W = 16, big_pool_size = 100;
+
+int small_context, big_context;
+
+std::mutex ids_mutex;
+std::set<std::thread::id> small_pool_thread_ids;
+
+std::atomic<int> arrived(0);
+std::atomic<bool> barrier_timed_out(false);
+
+int my_do_task(void *user_context, halide_task_t f, int idx, uint8_t *closure) {
+    if (user_context == &small_context) {
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        small_pool_thread_ids.insert(std::this_thread::get_id());
+    } else if (user_context == &big_context) {
+        // Wait for every row to have started, which can only happen
+        // if every thread of the pool is running one.
+        arrived++;
+        auto start = std::chrono::steady_clock::now();
+        while (arrived < big_pool_size) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(30)) {
+                barrier_timed_out = true;
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    return f(user_context, idx, closure);
+}
+
+bool check(const Buffer<int> &input, const Buffer<int> &output) {
+    bool ok = true;
+    output.for_each_element([&](int x, int y) {
+        if (ok && output(x, y) != input(x, y) + 1) {
+            printf("output(%d, %d) = %d instead of %d\n", x, y, output(x, y), input(x, y) + 1);
+            ok = false;
+        }
+    });
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    halide_thread_pool *small_pool = halide_create_thread_pool(1, 0);
+    halide_thread_pool *big_pool = halide_create_thread_pool(big_pool_size, 0);
+    if (!small_pool || !big_pool) {
+        printf("Thread pools are not supported on this platform\n");
+        printf("Success!\n");
+        return 0;
+    }
+    if (halide_set_thread_pool(&small_context, small_pool) ||
+        halide_set_thread_pool(&big_context, big_pool)) {
+        printf("halide_set_thread_pool failed\n");
+        return -1;
+    }
+    halide_set_custom_do_task(my_do_task);
+
+    Buffer<int> input(W, big_pool_size);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = x + y * W;
+    });
+    Buffer<int> output(W, big_pool_size);
+
+    int ret = thread_pools(&small_context, input, output);
+    if (ret || !check(input, output)) {
+        printf("Failed on the small pool: %d\n", ret);
+        return -1;
+    }
+    if (small_pool_thread_ids.size() != 1 ||
+        *small_pool_thread_ids.begin() != std::this_thread::get_id()) {
+        printf("A pool of one thread ran tasks on %d threads\n", (int)small_pool_thread_ids.size());
+        return -1;
+    }
+
+    output.fill(0);
+    ret = thread_pools(&big_context, input, output);
+    if (ret || !check(input, output)) {
+        printf("Failed on the big pool: %d\n", ret);
+        return -1;
+    }
+    if (barrier_timed_out) {
+        printf("Only %d of %d tasks ran at once on a pool of %d threads\n",
+               (int)arrived, big_pool_size, big_pool_size);
+        return -1;
+    }
+
+    // Destroying a pool unbinds it, and the context falls back to the
+    // default pool.
+    halide_destroy_thread_pool(small_pool);
+    halide_destroy_thread_pool(big_pool);
+    halide_set_custom_do_task(halide_default_do_task);
+    output.fill(0);
+    ret = thread_pools(&small_context, input, output);
+    if (ret || !check(input, output)) {
+        printf("Failed on the default pool: %d\n", ret);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
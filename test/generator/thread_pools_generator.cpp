@@ -0,0 +1,26 @@
+#include "Halide.h"
+
+namespace {
+
+// One parallel loop iteration per row, for binding invocations to
+// different thread pools through the user_context.
+class ThreadPools : public Halide::Generator<ThreadPools> {
+public:
+    Input<Buffer<int>> input{ "input", 2 };
+    Output<Buffer<int>> output{ "output", 2 };
+
+    void generate() {
+        output(x, y) = input(x, y) + 1;
+    }
+
+    void schedule() {
+        output.parallel(y);
+    }
+
+private:
+    Var x, y;
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(ThreadPools, thread_pools)
@@ -0,0 +1,59 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// Buffer::copy_from copies contiguous runs with memcpy. Compare it to
+// copying one element at a time, for a crop of a planar image into a
+// staging buffer, and for a whole image.
+
+bool test(const char *name, Buffer<uint8_t> src, Buffer<uint8_t> dst) {
+    double t_elementwise = benchmark(3, 3, [&]() {
+            dst.for_each_element([&](int x, int y, int c) {
+                    dst(x, y, c) = src(x, y, c);
+                });
+        });
+    dst.fill(0);
+    double t_copy = benchmark(3, 10, [&]() { dst.copy_from(src); });
+
+    bool ok = true;
+    dst.for_each_element([&](int x, int y, int c) {
+            ok = ok && dst(x, y, c) == src(x, y, c);
+        });
+    if (!ok) {
+        printf("%s: copy_from produced the wrong result\n", name);
+        return false;
+    }
+
+    printf("%-12s elementwise: %f ms  copy_from: %f ms\n",
+           name, t_elementwise * 1e3, t_copy * 1e3);
+
+    if (t_copy > t_elementwise) {
+        printf("%s: copy_from is slower than an elementwise copy\n", name);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Buffer<uint8_t> image(4096, 4096, 3);
+    image.for_each_value([](uint8_t &v) {v = (uint8_t)rand();});
+
+    // A crop copied into a staging buffer of exactly its size, so
+    // only the rows are contiguous.
+    Buffer<uint8_t> crop(*image.raw_buffer());
+    crop.crop(0, 100, 2048);
+    crop.crop(1, 100, 2048);
+    Buffer<uint8_t> staging(2048, 2048, 3);
+    staging.set_min(100, 100);
+
+    if (!test("crop", crop, staging) ||
+        !test("whole image", image, Buffer<uint8_t>(4096, 4096, 3))) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
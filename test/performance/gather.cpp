@@ -0,0 +1,114 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// Vector loads with data-dependent indices. Lookups in tables small
+// enough to hold in a register should become permutes, and larger
+// lookups should become gathers where the target has them. Compare
+// against the same pipelines compiled without those instructions.
+
+const int W = 1 << 12, H = 1 << 10;
+
+Target without_gathers(Target t) {
+    for (Target::Feature f : {Target::SSE41, Target::AVX, Target::AVX2,
+                              Target::AVX512, Target::AVX512_KNL,
+                              Target::AVX512_Skylake, Target::AVX512_Cannonlake}) {
+        t = t.without_feature(f);
+    }
+    return t;
+}
+
+template<typename T>
+bool test(const char *name, Buffer<T> table, Buffer<uint16_t> in, int vec) {
+    Var x, y;
+    Func f;
+    Expr i = cast<int>(in(x, y));
+    f(x, y) = table(clamp(i, 0, table.width() - 1)) + table(i % table.width());
+    f.vectorize(x, vec).parallel(y, 16);
+
+    Target t = get_jit_target_from_environment();
+    Buffer<T> fast(W, H), slow(W, H);
+    f.compile_jit(t);
+    double t_fast = benchmark(5, 10, [&]() { f.realize(fast); });
+    f.compile_jit(without_gathers(t));
+    double t_slow = benchmark(5, 10, [&]() { f.realize(slow); });
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int i = in(x, y);
+            T correct = table(std::min(i, table.width() - 1)) + table(i % table.width());
+            if (fast(x, y) != correct || slow(x, y) != correct) {
+                printf("%s: out(%d, %d) = %f, %f instead of %f\n", name, x, y,
+                       (double)fast(x, y), (double)slow(x, y), (double)correct);
+                return false;
+            }
+        }
+    }
+
+    printf("%-16s with gathers: %f ms  without: %f ms\n", name, t_fast * 1e3, t_slow * 1e3);
+
+    // Gathers are slow on some older x86 cpus, so only catch
+    // pathological slowdowns.
+    if (t_fast > t_slow * 2) {
+        printf("%s is much slower with gathers than without.\n", name);
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+Buffer<T> make_table(int size) {
+    Buffer<T> table(size);
+    table.for_each_value([](T &v) {v = (T)(rand() % 100);});
+    return table;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.arch != Target::X86) {
+        printf("Not running on x86. Skipping test.\n");
+        return 0;
+    }
+
+    Buffer<uint16_t> in(W, H);
+    in.for_each_value([](uint16_t &v) {v = (uint16_t)(rand() & 0x3fff);});
+
+    if (!test("u8 16-entry", make_table<uint8_t>(16), in, 32) ||
+        !test("f32 8-entry", make_table<float>(8), in, 8) ||
+        !test("f32 4096-entry", make_table<float>(4096), in, 8) ||
+        !test("i64 4096-entry", make_table<int64_t>(4096), in, 8)) {
+        return -1;
+    }
+
+    // Indirect stores, as in a histogram, become scatters with
+    // AVX-512. Later stores to the same place must win.
+    {
+        Var x;
+        RDom r(0, W);
+        Func perm;
+        perm(x) = (x * 37) % 1024;
+        perm.compute_root();
+        Func g;
+        g(x) = 0;
+        g(perm(r)) = r;
+        g.update().allow_race_conditions().vectorize(r, 16);
+
+        Buffer<int> out = g.realize(1024);
+        for (int i = 0; i < 1024; i++) {
+            int correct = 0;
+            for (int j = 0; j < W; j++) {
+                if ((j * 37) % 1024 == i) correct = j;
+            }
+            if (out(i) != correct) {
+                printf("scatter: out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// Large intermediates read down their columns touch a new page for
+// every element. Compare such a pipeline with the intermediate backed
+// by ordinary pages and by huge pages.
+
+const int size = 4096;
+
+double run_with_threshold(Func f, const char *threshold, Buffer<float> out) {
+    // putenv keeps a pointer to the string.
+    static char buf[64];
+    snprintf(buf, sizeof(buf), "HL_HUGE_PAGE_THRESHOLD=%s", threshold);
+    putenv(buf);
+    Halide::Internal::JITSharedRuntime::release_all();
+    f.compile_jit();
+    return benchmark(3, 3, [&]() { f.realize(out); });
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    if (t.os != Target::Linux) {
+        printf("Huge pages are only used on Linux. Skipping test.\n");
+        return 0;
+    }
+
+    Func in, transposed;
+    Var x, y;
+    in(x, y) = cast<float>(x + y * size);
+    transposed(x, y) = in(y, x) * 2.0f;
+
+    in.compute_root().parallel(y).vectorize(x, 8);
+    transposed.parallel(y).vectorize(x, 8);
+
+    Buffer<float> out(size, size);
+    double t_small_pages = run_with_threshold(transposed, "0", out);
+    double t_huge_pages = run_with_threshold(transposed, "1048576", out);
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float correct = (float)(y + x * size) * 2.0f;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %f instead of %f\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Ordinary pages: %f ms  huge pages: %f ms  speedup: %f\n",
+           t_small_pages * 1e3, t_huge_pages * 1e3, t_small_pages / t_huge_pages);
+
+    // Whether huge pages are granted depends on the kernel's settings,
+    // so only catch huge pages making things much worse.
+    if (t_huge_pages > t_small_pages * 1.5) {
+        printf("Huge pages are much slower than ordinary pages.\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// Measure the latency of dispatching a parallel loop that does almost
+// no work, with idle worker threads going straight to sleep, and with
+// them spinning for a while first so that they are ready for the next
+// loop of a burst.
+
+const int stages = 16, tasks = 8;
+
+double dispatch_time(Func f, const char *spin_count, Buffer<int> out) {
+    // The environment refers to buf after putenv returns.
+    static char buf[64];
+    snprintf(buf, sizeof(buf), "HL_SPIN_COUNT=%s", spin_count);
+    putenv(buf);
+    Halide::Internal::JITSharedRuntime::release_all();
+    f.compile_jit();
+    // Start the thread pool.
+    f.realize(out);
+    double t = benchmark(10, 100, [&]() { f.realize(out); });
+    return t / stages;
+}
+
+int main(int argc, char **argv) {
+    // A chain of tiny stages, each computed by its own parallel loop.
+    Var x;
+    std::vector<Func> chain(stages);
+    chain[0](x) = x;
+    for (int i = 1; i < stages; i++) {
+        chain[i](x) = chain[i - 1](x) + 1;
+    }
+    for (Func f : chain) {
+        f.compute_root().parallel(x);
+    }
+    Func out_f = chain.back();
+
+    Buffer<int> out(tasks);
+    double t_sleep = dispatch_time(out_f, "0", out);
+    double t_default = dispatch_time(out_f, "40", out);
+    double t_hot = dispatch_time(out_f, "100000", out);
+
+    for (int i = 0; i < tasks; i++) {
+        if (out(i) != i + stages - 1) {
+            printf("out(%d) = %d instead of %d\n", i, out(i), i + stages - 1);
+            return -1;
+        }
+    }
+
+    printf("Dispatch latency per parallel loop:\n"
+           "  no spinning:          %f us\n"
+           "  default spin count:   %f us\n"
+           "  spin count of 100000: %f us\n",
+           t_sleep * 1e6, t_default * 1e6, t_hot * 1e6);
+
+    if (t_default > t_sleep * 1.5) {
+        printf("Spinning before sleeping made dispatch much slower.\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// A parallel loop over many rows whose cost grows along the loop. With
+// the dynamic schedule each row is a separate task, so the threads
+// contend for the thread pool lock. With the static schedule each
+// thread gets one contiguous block, and the thread with the last block
+// does most of the work. The guided schedule hands out large chunks
+// first and smaller ones towards the end.
+
+const int rows = 4096;
+
+Buffer<float> run(ParallelSchedule schedule, double *t) {
+    Func f;
+    Var y;
+    RDom r(0, rows);
+    r.where(r.x < y);
+    f(y) = 0.0f;
+    f(y) += sqrt(cast<float>(r.x + y));
+    f.update().parallel(y, schedule);
+
+    Buffer<float> out(rows);
+    f.compile_jit();
+    f.realize(out);
+    *t = benchmark(3, 10, [&]() { f.realize(out); });
+    return out;
+}
+
+int main(int argc, char **argv) {
+    double t_dynamic, t_static, t_guided;
+    Buffer<float> dynamic = run(ParallelSchedule::Dynamic, &t_dynamic);
+    Buffer<float> fixed = run(ParallelSchedule::Static, &t_static);
+    Buffer<float> guided = run(ParallelSchedule::Guided, &t_guided);
+
+    for (int y = 0; y < rows; y++) {
+        if (fixed(y) != dynamic(y) || guided(y) != dynamic(y)) {
+            printf("Schedules disagree at row %d: %f (dynamic) %f (static) %f (guided)\n",
+                   y, dynamic(y), fixed(y), guided(y));
+            return -1;
+        }
+    }
+
+    printf("Dynamic: %f ms\n"
+           "Static:  %f ms\n"
+           "Guided:  %f ms\n",
+           t_dynamic * 1e3, t_static * 1e3, t_guided * 1e3);
+
+    if (t_guided > 1.5 * std::min(t_dynamic, t_static)) {
+        printf("The guided schedule was much slower than the others.\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -79,6 +79,50 @@ void test_deinterleave() {
            dst_image.number_of_elements() / t2);
 }
 
+// Deinterleave images with more channels, e.g. RGBA to planar. The
+// loads from the input have a stride of the channel count.
+void test_deinterleave_channels(int channels) {
+    ImageParam src(UInt(8), 3);
+    Func dst;
+    Var x, y, c;
+
+    dst(x, y, c) = src(x, y, c);
+
+    src.dim(0).set_stride(channels)
+        .dim(2).set_stride(1).set_bounds(0, channels);
+
+    dst.output_buffer()
+        .dim(0).set_stride(1)
+        .dim(2).set_extent(channels);
+
+    dst.reorder(c, x, y).bound(c, 0, channels).unroll(c);
+    dst.vectorize(x, 16);
+
+    Buffer<uint8_t> src_image = Buffer<uint8_t>::make_interleaved(1 << 11, 1 << 11, channels);
+    Buffer<uint8_t> dst_image(1 << 11, 1 << 11, channels);
+
+    src_image.for_each_element([&](int x, int y, int c) {
+            src_image(x, y, c) = (uint8_t)(x + c * 37);
+        });
+    dst_image.fill(0);
+
+    src.set(src_image);
+
+    dst.compile_jit();
+    dst.realize(dst_image);
+
+    double t = benchmark(1, 20, [&]() {
+        dst.realize(dst_image);
+    });
+
+    printf("%d-channel interleaved to planar bandwidth %.3e byte/s.\n",
+           channels, dst_image.number_of_elements() / t);
+
+    dst_image.for_each_element([&](int x, int y, int c) {
+            assert(dst_image(x, y, c) == (uint8_t)(x + c * 37));
+        });
+}
+
 void test_interleave(bool fast) {
     ImageParam src(UInt(8), 3);
     Func dst;
@@ -142,6 +186,8 @@ void test_interleave(bool fast) {
 
 int main(int argc, char **argv) {
     test_deinterleave();
+    test_deinterleave_channels(4);
+    test_deinterleave_channels(8);
     test_interleave(false);
     test_interleave(true);
     printf("Success!\n");
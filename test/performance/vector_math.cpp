@@ -0,0 +1,139 @@
+#include "Halide.h"
+#include <cstdio>
+#include <cmath>
+#include <functional>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// The fast_ math functions are polynomial approximations that
+// vectorize, unlike calls to libm. Check they're accurate, and faster
+// than calling libm once per element.
+
+const int N = 1 << 18;
+
+template<typename T>
+Buffer<T> make_input(T lo, T hi) {
+    Buffer<T> buf(N);
+    buf.for_each_value([&](T &v) {v = lo + (hi - lo) * (T)rand() / (T)RAND_MAX;});
+    return buf;
+}
+
+template<typename T>
+bool test(const char *name,
+          std::function<Expr(Expr, Expr)> libm_fn,
+          std::function<Expr(Expr, Expr)> fast_fn,
+          std::function<T(T, T)> reference,
+          Buffer<T> a, Buffer<T> b) {
+    // Differences of this many ulps, or of this absolute size, are
+    // acceptable. The latter is for sin and cos near their zeros.
+    const double max_ulps = 4;
+    const double max_abs_error = sizeof(T) == 4 ? 2e-7 : 4e-16;
+
+    Var x;
+    Func scalar, vector;
+    scalar(x) = libm_fn(a(x), b(x));
+    vector(x) = fast_fn(a(x), b(x));
+    vector.vectorize(x, (int)(32 / sizeof(T)));
+
+    Buffer<T> scalar_out(N), vector_out(N);
+    scalar.compile_jit();
+    vector.compile_jit();
+    double t_scalar = benchmark(5, 10, [&]() { scalar.realize(scalar_out); });
+    double t_vector = benchmark(5, 10, [&]() { vector.realize(vector_out); });
+
+    double worst = 0;
+    for (int i = 0; i < N; i++) {
+        T correct = reference(a(i), b(i));
+        T actual = vector_out(i);
+        double err = std::abs((double)actual - (double)correct);
+        double ulp = std::nextafter(std::abs(correct), (T)INFINITY) - std::abs(correct);
+        if (err <= max_abs_error) {
+            continue;
+        }
+        worst = std::max(worst, err / ulp);
+        if (err > max_ulps * ulp) {
+            printf("%s(%.17g, %.17g) = %.17g instead of %.17g\n",
+                   name, (double)a(i), (double)b(i), (double)actual, (double)correct);
+            return false;
+        }
+    }
+
+    printf("%-8s scalar: %f ms  vector: %f ms  worst error: %f ulp\n",
+           name, t_scalar * 1e3, t_vector * 1e3, worst);
+
+    if (t_vector > t_scalar) {
+        printf("%s is slower when vectorized\n", name);
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+bool test_all(const char *type_name) {
+    printf("%s:\n", type_name);
+    using Fn = std::function<T(T, T)>;
+
+    Buffer<T> angles = make_input<T>(-100, 100);
+    Buffer<T> small = make_input<T>(-10, 10);
+    Buffer<T> positive = make_input<T>((T)1e-3, 1000);
+    Buffer<T> exponents = make_input<T>(sizeof(T) == 4 ? -80 : -700, sizeof(T) == 4 ? 80 : 700);
+
+    bool ok =
+        test<T>("sin", [](Expr x, Expr) {return sin(x);}, [](Expr x, Expr) {return fast_sin(x);},
+                Fn([](T x, T) {return std::sin(x);}), angles, angles) &&
+        test<T>("cos", [](Expr x, Expr) {return cos(x);}, [](Expr x, Expr) {return fast_cos(x);},
+                Fn([](T x, T) {return std::cos(x);}), angles, angles) &&
+        test<T>("atan", [](Expr x, Expr) {return atan(x);}, [](Expr x, Expr) {return fast_atan(x);},
+                Fn([](T x, T) {return std::atan(x);}), angles, angles) &&
+        test<T>("atan2", [](Expr y, Expr x) {return atan2(y, x);}, [](Expr y, Expr x) {return fast_atan2(y, x);},
+                Fn([](T y, T x) {return std::atan2(y, x);}), small, angles) &&
+        test<T>("tanh", [](Expr x, Expr) {return tanh(x);}, [](Expr x, Expr) {return fast_tanh(x);},
+                Fn([](T x, T) {return std::tanh(x);}), small, small);
+
+    // exp and log of Float(32) already vectorize, and fast_exp and
+    // fast_log of Float(32) are less accurate approximations, so only
+    // check Float(64).
+    if (ok && sizeof(T) == 8) {
+        ok =
+            test<T>("exp", [](Expr x, Expr) {return exp(x);}, [](Expr x, Expr) {return fast_exp(x);},
+                    Fn([](T x, T) {return std::exp(x);}), exponents, exponents) &&
+            test<T>("log", [](Expr x, Expr) {return log(x);}, [](Expr x, Expr) {return fast_log(x);},
+                    Fn([](T x, T) {return std::log(x);}), positive, positive);
+    }
+    return ok;
+}
+
+// The argument reduction of fast_sin and fast_cos should still get the
+// quadrant right for arguments whose multiple of pi/2 doesn't fit in
+// an int32.
+bool test_large_angles() {
+    Buffer<double> angles = make_input<double>(1e10, 1e11);
+    Var x;
+    Func f;
+    f(x) = Tuple(fast_sin(angles(x)), fast_cos(angles(x)));
+    f.vectorize(x, 4);
+    Realization r = f.realize(N);
+    Buffer<double> s = r[0], c = r[1];
+    for (int i = 0; i < N; i++) {
+        if (std::abs(s(i) - std::sin(angles(i))) > 1e-4 ||
+            std::abs(c(i) - std::cos(angles(i))) > 1e-4) {
+            printf("fast_sin, fast_cos(%.17g) = %.17g, %.17g instead of %.17g, %.17g\n",
+                   angles(i), s(i), c(i), std::sin(angles(i)), std::cos(angles(i)));
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!test_all<float>("Float(32)") ||
+        !test_all<double>("Float(64)") ||
+        !test_large_angles()) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -3,11 +3,13 @@
 #include "halide_benchmark.h"
 #include "halide_image_io.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <sstream>
@@ -662,10 +664,11 @@ struct ArgData {
     Buffer<> buffer_value;
 };
 
-// Run a bounds-query call with the given args, and return the shapes
+// Run a bounds-query call with the given args, using the given shape for
+// each buffer argument (indexed like the args), and return the shapes
 // to which we are constrained.
-std::vector<Shape> run_bounds_query(const std::map<std::string, ArgData> &args, 
-                                    const Shape &default_output_shape) {
+std::vector<Shape> run_bounds_query(const std::map<std::string, ArgData> &args,
+                                    const std::vector<Shape> &buffer_shapes) {
     std::vector<void*> filter_argv(args.size(), nullptr);
     // These vectors are larger than needed, but simplifies logic downstream.
     std::vector<Buffer<>> bounds_query_buffers(args.size());
@@ -678,10 +681,7 @@ std::vector<Shape> run_bounds_query(const std::map<std::string, ArgData> &args,
             break;
         case halide_argument_kind_input_buffer: 
         case halide_argument_kind_output_buffer:
-            Shape shape = (arg.metadata->kind == halide_argument_kind_input_buffer) ? 
-                           get_shape(arg.buffer_value) :
-                           choose_output_extents(arg.metadata->dimensions, default_output_shape);
-            bounds_query_buffers[arg.index] = make_with_shape(arg.metadata->type, shape);
+            bounds_query_buffers[arg.index] = make_with_shape(arg.metadata->type, buffer_shapes[arg.index]);
             filter_argv[arg.index] = bounds_query_buffers[arg.index].raw_buffer();
             break;
         }
@@ -705,6 +705,45 @@ std::vector<Shape> run_bounds_query(const std::map<std::string, ArgData> &args,
     return constrained_shapes;
 }
 
+// Run a bounds-query call with the loaded inputs, and outputs of the
+// default shape.
+std::vector<Shape> run_bounds_query(const std::map<std::string, ArgData> &args, 
+                                    const Shape &default_output_shape) {
+    std::vector<Shape> buffer_shapes(args.size());
+    for (auto &arg_pair : args) {
+        auto &arg = arg_pair.second;
+        switch (arg.metadata->kind) {
+        case halide_argument_kind_input_scalar:
+            break;
+        case halide_argument_kind_input_buffer:
+            buffer_shapes[arg.index] = get_shape(arg.buffer_value);
+            break;
+        case halide_argument_kind_output_buffer:
+            buffer_shapes[arg.index] = choose_output_extents(arg.metadata->dimensions, default_output_shape);
+            break;
+        }
+    }
+    return run_bounds_query(args, buffer_shapes);
+}
+
+// Gather the filter arguments into an argv for halide_rungen_redirect_argv().
+std::vector<void*> make_filter_argv(std::map<std::string, ArgData> &args) {
+    std::vector<void*> filter_argv(args.size(), nullptr);
+    for (auto &arg_pair : args) {
+        auto &arg = arg_pair.second;
+        switch (arg.metadata->kind) {
+            case halide_argument_kind_input_scalar:
+                filter_argv[arg.index] = &arg.scalar_value;
+                break;
+            case halide_argument_kind_input_buffer:
+            case halide_argument_kind_output_buffer:
+                filter_argv[arg.index] = arg.buffer_value.raw_buffer();
+                break;
+        }
+    }
+    return filter_argv;
+}
+
 uint64_t calc_pixels_out(const std::map<std::string, ArgData> &args) {
     uint64_t pixels_out = 0;
     for (auto &arg_pair : args) {
@@ -810,6 +849,18 @@ Flags:
         allocation during run; note that this may slow down execution, so 
         benchmarks may be inaccurate if you combine --benchmark with this.
 
+    --strip_rows=NUM:
+        Run the filter on strips of NUM rows of the output at a time, reading
+        only the rows of each input that the strip needs and writing each strip
+        to the output files as it is produced, so that images larger than
+        memory can be processed. Inputs must be PNG, PGM, PPM, TMP or NPY files
+        of exactly the type and dimensions the filter expects, and outputs are
+        saved with their own type and dimensions, with no conversion. Since the
+        inputs are not padded, the filter must handle its own boundary
+        conditions (e.g. by clamping to bounds passed in as scalar inputs) and
+        not rely on the extent of its input buffers. Cannot be combined with
+        --benchmark.
+
 Known Issues:
 
     * Filters running on GPU (vs CPU) have not been tested.
@@ -865,6 +916,160 @@ FormatInfo best_save_format(const Buffer<> &b, const std::set<FormatInfo> &info)
     return best;
 }
 
+// Run the filter one strip of output rows at a time: for each strip, read
+// only the rows of each input that a bounds query says it needs, and write
+// the strip to the output files before moving on, so that images larger
+// than memory can be processed. Inputs must be files in a format that
+// can be streamed (png, pgm, ppm, tmp or npy), and must be exactly the
+// type and dimensionality the filter expects.
+int run_in_strips(std::map<std::string, ArgData> &args, Shape default_output_shape,
+                  int strip_rows, bool track_memory) {
+    using StreamReader = Halide::Tools::ImageStreamReader<Buffer<>, IOCheckFail>;
+    using StreamWriter = Halide::Tools::ImageStreamWriter<Buffer<>, IOCheckFail>;
+
+    // Indexed like the args.
+    std::vector<std::unique_ptr<StreamReader>> readers(args.size());
+    std::vector<std::unique_ptr<StreamWriter>> writers(args.size());
+    std::vector<Shape> full_shapes(args.size());
+
+    for (auto &arg_pair : args) {
+        auto &arg_name = arg_pair.first;
+        auto &arg = arg_pair.second;
+        if (arg.metadata->kind != halide_argument_kind_input_buffer) {
+            continue;
+        }
+        std::vector<std::string> v = split_string(arg.raw_string, ":");
+        if (v.size() == 2 && v[0].size() != 1) {
+            fail() << "Input " << arg_name << " must be a file when using --strip_rows: " << arg.raw_string;
+        }
+        info() << "Opening input " << arg_name << " from " << arg.raw_string << " ...";
+        readers[arg.index].reset(new StreamReader);
+        if (!readers[arg.index]->open(arg.raw_string)) {
+            fail() << "Unable to open input: " << arg.raw_string;
+        }
+        const std::vector<int> &extents = readers[arg.index]->extents();
+        if (readers[arg.index]->type() != arg.metadata->type ||
+            (int) extents.size() != arg.metadata->dimensions) {
+            fail() << "Image for input \"" << arg_name << "\" must be of type "
+                   << arg.metadata->type << " with " << arg.metadata->dimensions
+                   << " dimensions when using --strip_rows.";
+        }
+        Shape shape;
+        for (size_t i = 0; i < extents.size(); i++) {
+            const int stride = (i == 0) ? 1 : shape[i-1].stride * shape[i-1].extent;
+            shape.push_back({0, extents[i], stride});
+        }
+        full_shapes[arg.index] = shape;
+        info() << "Input " << arg_name << ": Shape is " << shape;
+        if (default_output_shape.empty()) {
+            default_output_shape = shape;
+        }
+    }
+
+    int height = 0;
+    for (auto &arg_pair : args) {
+        auto &arg_name = arg_pair.first;
+        auto &arg = arg_pair.second;
+        if (arg.metadata->kind != halide_argument_kind_output_buffer) {
+            continue;
+        }
+        if (arg.metadata->dimensions < 2) {
+            fail() << "Output " << arg_name << " must have at least two dimensions when using --strip_rows.";
+        }
+        Shape shape = choose_output_extents(arg.metadata->dimensions, default_output_shape);
+        full_shapes[arg.index] = shape;
+        height = shape[1].extent;
+        info() << "Output " << arg_name << ": Shape is " << shape;
+        if (arg.raw_string.empty()) {
+            info() << "(Output " << arg_name << " will not be saved.)";
+            continue;
+        }
+        std::vector<int> extents;
+        for (const halide_dimension_t &d : shape) {
+            extents.push_back(d.extent);
+        }
+        writers[arg.index].reset(new StreamWriter);
+        if (!writers[arg.index]->open(arg.raw_string, arg.metadata->type, extents)) {
+            fail() << "Unable to save output: " << arg.raw_string;
+        }
+    }
+
+    HalideMemoryTracker tracker;
+    if (track_memory) {
+        tracker.install();
+    }
+
+    info() << "Running filter in strips of " << strip_rows << " rows...";
+    for (int y = 0; y < height; y += strip_rows) {
+        const int rows = std::min(strip_rows, height - y);
+        std::vector<Shape> strip_shapes = full_shapes;
+        for (auto &arg_pair : args) {
+            auto &arg = arg_pair.second;
+            if (arg.metadata->kind == halide_argument_kind_output_buffer) {
+                strip_shapes[arg.index][1].min = y;
+                strip_shapes[arg.index][1].extent = rows;
+            }
+        }
+        std::vector<Shape> constrained_shapes = run_bounds_query(args, strip_shapes);
+
+        for (auto &arg_pair : args) {
+            auto &arg_name = arg_pair.first;
+            auto &arg = arg_pair.second;
+            const Shape &constrained_shape = constrained_shapes[arg.index];
+            switch (arg.metadata->kind) {
+                case halide_argument_kind_input_buffer: {
+                    // There's no way to pad the input, so the filter must
+                    // keep within the image by itself, e.g. by clamping to
+                    // its bounds as given by some scalar parameters.
+                    const Shape &full_shape = full_shapes[arg.index];
+                    for (size_t d = 0; d < full_shape.size(); d++) {
+                        if (constrained_shape[d].min < 0 ||
+                            constrained_shape[d].min + constrained_shape[d].extent > full_shape[d].extent) {
+                            fail() << "Input " << arg_name << " is required over " << constrained_shape
+                                   << " for output rows [" << y << ", " << y + rows
+                                   << "), which is outside the image; when using --strip_rows "
+                                   << "the filter must handle its own boundary conditions.";
+                        }
+                    }
+                    Buffer<> band;
+                    if (!readers[arg.index]->read_rows(constrained_shape[1].min, constrained_shape[1].extent, &band)) {
+                        fail() << "Unable to read input: " << arg.raw_string;
+                    }
+                    for (int d = 0; d < band.dimensions(); d++) {
+                        if (d != 1) {
+                            band.crop(d, constrained_shape[d].min, constrained_shape[d].extent);
+                        }
+                    }
+                    adapt_input_buffer_layout(constrained_shape, &band);
+                    arg.buffer_value = band;
+                    break;
+                }
+                case halide_argument_kind_output_buffer: {
+                    arg.buffer_value = allocate_buffer(arg.metadata->type, make_legal_output_buffer_shape(constrained_shape));
+                    break;
+                }
+            }
+        }
+
+        std::vector<void*> filter_argv = make_filter_argv(args);
+        // Ignore result since our halide_error() should catch everything.
+        (void) halide_rungen_redirect_argv(&filter_argv[0]);
+
+        for (auto &arg_pair : args) {
+            auto &arg = arg_pair.second;
+            if (writers[arg.index] && !writers[arg.index]->write_rows(arg.buffer_value)) {
+                fail() << "Unable to save output: " << arg.raw_string;
+            }
+        }
+    }
+
+    if (track_memory) {
+        std::cout << "Maximum Halide memory: " << tracker.highwater()
+            << " bytes for strips of " << strip_rows << " rows.\n";
+    }
+    return 0;
+}
+
 }  // namespace
 
 int main(int argc, char **argv) {
@@ -902,6 +1107,7 @@ int main(int argc, char **argv) {
     int benchmark_samples = 3;
     int benchmark_iterations = 10;
     int benchmark_warmup = 1;
+    int strip_rows = 0;
     for (int i = 1; i < argc; ++i) {
         if (argv[i][0] == '-') {
             const char *p = argv[i] + 1; // skip -
@@ -961,6 +1167,10 @@ int main(int argc, char **argv) {
                 if (!parse_scalar(flag_value, &benchmark_warmup)) {
                     fail() << "Invalid value for flag: " << flag_name;
                 }
+            } else if (flag_name == "strip_rows") {
+                if (!parse_scalar(flag_value, &strip_rows) || strip_rows < 1) {
+                    fail() << "Invalid value for flag: " << flag_name;
+                }
             } else if (flag_name == "output_extents") {
                 default_output_shape = parse_extents(flag_value);
             } else {
@@ -1007,6 +1217,10 @@ int main(int argc, char **argv) {
         warn() << "Using --track_memory with --benchmark will produce inaccurate benchmark results.";
     }
 
+    if (benchmark && strip_rows) {
+        fail() << "--strip_rows cannot be combined with --benchmark.";
+    }
+
     // Check to be sure that all required arguments are specified.
     if (found.size() != args.size() || !unknown_args.empty()) {
         std::ostringstream o;
@@ -1042,6 +1256,10 @@ int main(int argc, char **argv) {
             break;
         }
         case halide_argument_kind_input_buffer: {
+            if (strip_rows) {
+                // Opened and read a strip at a time by run_in_strips().
+                break;
+            }
             arg.buffer_value = load_input(arg.raw_string, *arg.metadata);
             info() << "Input " << arg_name << ": Shape is " << get_shape(arg.buffer_value);
             // If there was no default_output_shape specified, use the shape of
@@ -1058,6 +1276,10 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (strip_rows) {
+        return run_in_strips(args, default_output_shape, strip_rows, track_memory);
+    }
+
     // Run a bounds query: we need to figure out how to allocate the output buffers,
     // and the input buffers might need reshaping to satisfy constraints (e.g. a chunky/interleaved layout).
     std::vector<Shape> constrained_shapes = run_bounds_query(args, default_output_shape);
@@ -1095,19 +1317,7 @@ int main(int argc, char **argv) {
     }
 
     {
-        std::vector<void*> filter_argv(args.size(), nullptr);
-        for (auto &arg_pair : args) {
-            auto &arg = arg_pair.second;
-            switch (arg.metadata->kind) {
-                case halide_argument_kind_input_scalar:
-                    filter_argv[arg.index] = &arg.scalar_value;
-                    break;
-                case halide_argument_kind_input_buffer:
-                case halide_argument_kind_output_buffer:
-                    filter_argv[arg.index] = arg.buffer_value.raw_buffer();
-                    break;
-            }
-        }
+        std::vector<void*> filter_argv = make_filter_argv(args);
 
         if (benchmark) {
             info() << "Benchmarking filter...";
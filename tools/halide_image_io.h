@@ -8,8 +8,10 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -22,7 +24,15 @@
 #include "jpeglib.h"
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "HalideRuntime.h"  // for halide_type_t
+#include "HalideBuffer.h"   // for AllocationHeader
 
 namespace Halide {
 namespace Tools {
@@ -310,6 +320,24 @@ struct FileOpener {
         return write_bytes((const uint8_t *)v.data(), v.size() * sizeof(T));
     }
 
+    // Seek to a byte offset from the start of the file, which may be
+    // more than 2GB.
+    bool seek(int64_t offset) {
+#ifdef _WIN32
+        return _fseeki64(f, offset, SEEK_SET) == 0;
+#else
+        return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+    }
+
+    int64_t tell() {
+#ifdef _WIN32
+        return _ftelli64(f);
+#else
+        return (int64_t)ftello(f);
+#endif
+    }
+
 
     FILE * const f;
 };
@@ -929,6 +957,380 @@ bool save_tmp(ImageType &im, const std::string &filename) {
     return true;
 }
 
+// ".npy" is the file format NumPy uses for a single array (see
+// https://docs.scipy.org/doc/numpy/neps/npy-format.html). Only
+// little-endian data is supported.
+inline const std::vector<std::pair<std::string, halide_type_t>> &npy_types() {
+    static const std::vector<std::pair<std::string, halide_type_t>> types = {
+      { "b1", halide_type_t(halide_type_uint, 1) },
+      { "i1", halide_type_t(halide_type_int, 8) },
+      { "i2", halide_type_t(halide_type_int, 16) },
+      { "i4", halide_type_t(halide_type_int, 32) },
+      { "i8", halide_type_t(halide_type_int, 64) },
+      { "u1", halide_type_t(halide_type_uint, 8) },
+      { "u2", halide_type_t(halide_type_uint, 16) },
+      { "u4", halide_type_t(halide_type_uint, 32) },
+      { "u8", halide_type_t(halide_type_uint, 64) },
+      { "f2", halide_type_t(halide_type_float, 16) },
+      { "f4", halide_type_t(halide_type_float, 32) },
+      { "f8", halide_type_t(halide_type_float, 64) },
+    };
+    return types;
+}
+
+// Find the value for a key in the Python dict literal that makes up
+// a .npy header, e.g. "'shape': (3, 4), " for "shape". Returns the
+// text following the colon.
+inline std::string npy_header_value(const std::string &header, const std::string &key) {
+    size_t pos = header.find("'" + key + "'");
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos = header.find(':', pos);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos = header.find_first_not_of(' ', pos + 1);
+    return pos == std::string::npos ? "" : header.substr(pos);
+}
+
+// Read the header of a .npy file, leaving the file positioned at the
+// start of the data. The shape is returned in Halide's order, with the
+// fastest-varying dimension first.
+template<CheckFunc check>
+bool read_npy_header(FileOpener &f, halide_type_t *type, std::vector<int> *shape, size_t *data_offset) {
+    uint8_t preamble[10];
+    if (!check(f.read_bytes(preamble, sizeof(preamble)), "Could not read .npy header")) {
+        return false;
+    }
+    if (!check(memcmp(preamble, "\x93NUMPY", 6) == 0, "Bad header on .npy file")) {
+        return false;
+    }
+
+    // Version 1 has a two byte header length. Later versions have four.
+    const int major_version = preamble[6];
+    size_t header_len = preamble[8] | (preamble[9] << 8);
+    *data_offset = sizeof(preamble) + header_len;
+    if (major_version > 1) {
+        uint8_t high[2];
+        if (!check(f.read_bytes(high, sizeof(high)), "Could not read .npy header")) {
+            return false;
+        }
+        header_len |= (size_t)(high[0] | (high[1] << 8)) << 16;
+        *data_offset = sizeof(preamble) + sizeof(high) + header_len;
+    }
+    std::string header(header_len, ' ');
+    if (!check(f.read_bytes((uint8_t *)&header[0], header_len), "Could not read .npy header")) {
+        return false;
+    }
+
+    std::string descr = npy_header_value(header, "descr");
+    size_t descr_end = descr.find('\'', 1);
+    if (!check(descr.size() > 2 && descr[0] == '\'' && descr_end != std::string::npos,
+               "Bad descr in .npy header")) {
+        return false;
+    }
+    descr = descr.substr(1, descr_end - 1);
+    char byte_order = '|';
+    if (descr[0] == '<' || descr[0] == '>' || descr[0] == '|' || descr[0] == '=') {
+        byte_order = descr[0];
+        descr = descr.substr(1);
+    }
+    if (descr == "?") {
+        descr = "b1";
+    }
+    bool found = false;
+    for (const auto &t : npy_types()) {
+        if (t.first == descr) {
+            *type = t.second;
+            found = true;
+        }
+    }
+    if (!check(found, "Unsupported type in .npy file")) {
+        return false;
+    }
+    if (!check(byte_order != '>' || type->bytes() == 1, "Big-endian .npy files are not supported")) {
+        return false;
+    }
+
+    const bool fortran_order = npy_header_value(header, "fortran_order").compare(0, 4, "True") == 0;
+    std::string shape_str = npy_header_value(header, "shape");
+    size_t shape_end = shape_str.find(')');
+    if (!check(!shape_str.empty() && shape_str[0] == '(' && shape_end != std::string::npos,
+               "Bad shape in .npy header")) {
+        return false;
+    }
+    shape->clear();
+    const char *p = shape_str.c_str() + 1;
+    const char *end = shape_str.c_str() + shape_end;
+    while (p < end) {
+        char *next;
+        long extent = strtol(p, &next, 10);
+        if (next == p) {
+            // Skip commas and spaces.
+            p++;
+            continue;
+        }
+        if (!check(extent >= 0 && extent <= 0x7fffffff, "Bad shape in .npy header")) {
+            return false;
+        }
+        shape->push_back((int)extent);
+        p = next;
+    }
+    // In C order the last dimension varies fastest.
+    if (!fortran_order) {
+        std::reverse(shape->begin(), shape->end());
+    }
+    return true;
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool load_npy(const std::string &filename, ImageType *im) {
+    static_assert(!ImageType::has_static_halide_type, "");
+
+    FileOpener f(filename, "rb");
+    if (!check(f.f != nullptr, "File could not be opened for reading")) {
+        return false;
+    }
+
+    halide_type_t im_type;
+    std::vector<int> im_dimensions;
+    size_t data_offset;
+    if (!read_npy_header<check>(f, &im_type, &im_dimensions, &data_offset)) {
+        return false;
+    }
+    *im = ImageType(im_type, im_dimensions);
+
+    // This should never fail unless the default Buffer<> constructor behavior changes.
+    if (!check(buffer_is_compact_planar(*im), "load_npy() requires compact planar images")) {
+        return false;
+    }
+
+    size_t count = im_type.bytes() * im->number_of_elements();
+    if (!check(f.read_bytes(im->raw_buffer()->host, count), "Could not read .npy payload")) {
+        return false;
+    }
+
+    im->set_host_dirty();
+    return true;
+}
+
+inline const std::set<FormatInfo> &query_npy() {
+    // Any supported type, with any number of dimensions up to 8.
+    static std::set<FormatInfo> info = []() {
+        std::set<FormatInfo> info;
+        for (const auto &t : npy_types()) {
+            for (int d = 0; d <= 8; d++) {
+                info.insert({ t.second, d });
+            }
+        }
+        return info;
+    }();
+    return info;
+}
+
+// Make the header of a version 1.0 .npy file for data of the given
+// type and extents, in Halide's order. Returns an empty string if the
+// type isn't supported.
+inline std::string make_npy_header(halide_type_t type, const std::vector<int> &extents) {
+    std::string descr;
+    for (const auto &t : npy_types()) {
+        if (t.second == type) {
+            descr = (type.bytes() == 1 ? "|" : "<") + t.first;
+        }
+    }
+    if (descr.empty()) {
+        return "";
+    }
+
+    // Write the shape in C order, with the slowest-varying dimension
+    // first. Pad the header so that the data is 64-byte aligned.
+    std::string shape;
+    for (int i = (int)extents.size() - 1; i >= 0; i--) {
+        shape += std::to_string(extents[i]);
+        if (i > 0 || extents.size() == 1) {
+            shape += ",";
+        }
+        if (i > 0) {
+            shape += " ";
+        }
+    }
+    std::string header = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (" + shape + "), }";
+    const size_t preamble_size = 10;
+    header += std::string((64 - (preamble_size + header.size() + 1) % 64) % 64, ' ') + "\n";
+    const char preamble[preamble_size] = { '\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                           (char)(header.size() & 0xff),
+                                           (char)(header.size() >> 8) };
+    return std::string(preamble, preamble_size) + header;
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool save_npy(ImageType &im, const std::string &filename) {
+    static_assert(!ImageType::has_static_halide_type, "");
+
+    im.copy_to_host();
+
+    const halide_type_t im_type = im.type();
+    std::vector<int> im_dimensions;
+    for (int i = 0; i < im.dimensions(); i++) {
+        im_dimensions.push_back(im.dim(i).extent());
+    }
+    const std::string header = make_npy_header(im_type, im_dimensions);
+    if (!check(!header.empty(), "Unsupported type for .npy file")) {
+        return false;
+    }
+
+    FileOpener f(filename, "wb");
+    if (!check(f.f != nullptr, "File could not be opened for writing")) {
+        return false;
+    }
+    if (!check(f.write_bytes((const uint8_t *)header.data(), header.size()), "Could not write .npy header")) {
+        return false;
+    }
+
+    const size_t elem_size = im_type.bytes();
+    if (buffer_is_compact_planar(im)) {
+        size_t count = elem_size * im.number_of_elements();
+        if (!check(f.write_bytes(im.raw_buffer()->host, count), "Could not write .npy payload")) {
+            return false;
+        }
+    } else {
+        const halide_buffer_t *buf = im.raw_buffer();
+        bool ok = true;
+        im.for_each_element([&](const int *pos) {
+            ptrdiff_t offset = 0;
+            for (int i = 0; i < buf->dimensions; i++) {
+                offset += (ptrdiff_t)(pos[i] - buf->dim[i].min) * buf->dim[i].stride;
+            }
+            ok = ok && f.write_bytes(buf->host + offset * elem_size, elem_size);
+        });
+        if (!check(ok, "Could not write .npy payload")) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#ifndef _WIN32
+// The allocation behind an image that aliases a memory-mapped
+// file. The image's deallocate_fn unmaps the file.
+struct MappedFile {
+    Halide::Runtime::AllocationHeader header;
+    void *addr;
+    size_t length;
+};
+
+inline void unmap_file(void *p) {
+    MappedFile *m = (MappedFile *)p;
+    munmap(m->addr, m->length);
+    delete m;
+}
+#endif
+
+// Make an image of the given type and shape that aliases the file's
+// contents, starting at the given offset. The mapping is private and
+// copy-on-write, so the pages are shared with other processes mapping
+// the same file until they are written to, and writes never reach the
+// file. Where mmap isn't available, the data is read instead.
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool map_file(const std::string &filename, size_t offset, halide_type_t im_type,
+              const std::vector<int> &im_dimensions, ImageType *im) {
+    static_assert(!ImageType::has_static_halide_type, "");
+
+    size_t count = im_type.bytes();
+    for (int extent : im_dimensions) {
+        count *= extent;
+    }
+
+#ifndef _WIN32
+    if (count > 0) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (!check(fd >= 0, "File could not be opened for reading")) {
+            return false;
+        }
+        struct stat st;
+        if (!check(fstat(fd, &st) == 0 && (size_t)st.st_size >= offset + count,
+                   "File is too small for the image")) {
+            close(fd);
+            return false;
+        }
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        const size_t map_offset = offset & ~(page_size - 1);
+        const size_t length = offset + count - map_offset;
+        void *addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, map_offset);
+        close(fd);
+        if (!check(addr != MAP_FAILED, "File could not be mapped")) {
+            return false;
+        }
+
+        MappedFile *m = new MappedFile;
+        m->header.deallocate_fn = unmap_file;
+        m->addr = addr;
+        m->length = length;
+        void *host = (uint8_t *)addr + (offset - map_offset);
+        *im = ImageType(im_type, host, im_dimensions);
+        im->adopt_allocation(&m->header, host);
+        im->set_host_dirty();
+        return true;
+    }
+#endif
+
+    FileOpener f(filename, "rb");
+    if (!check(f.f != nullptr, "File could not be opened for reading")) {
+        return false;
+    }
+    if (!check(fseek(f.f, (long)offset, SEEK_SET) == 0, "File is too small for the image")) {
+        return false;
+    }
+    *im = ImageType(im_type, im_dimensions);
+    if (!check(f.read_bytes(im->raw_buffer()->host, count), "File is too small for the image")) {
+        return false;
+    }
+    im->set_host_dirty();
+    return true;
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool map_tmp(const std::string &filename, ImageType *im) {
+    int32_t header[5];
+    {
+        FileOpener f(filename, "rb");
+        if (!check(f.f != nullptr, "File could not be opened for reading")) {
+            return false;
+        }
+        if (!check(f.read_bytes((uint8_t*) &header[0], sizeof(header)), "Count not read .tmp header")) {
+            return false;
+        }
+    }
+
+    if (!check(header[0] > 0 && header[1] > 0 && header[2] > 0 && header[3] > 0 &&
+               header[4] >= 0 && header[4] < kNumTmpCodes, "Bad header on .tmp file")) {
+        return false;
+    }
+
+    const halide_type_t im_type = tmp_code_to_halide_type()[header[4]];
+    std::vector<int> im_dimensions = { header[0], header[1], header[2], header[3] };
+    return map_file<ImageType, check>(filename, sizeof(header), im_type, im_dimensions, im);
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool map_npy(const std::string &filename, ImageType *im) {
+    halide_type_t im_type;
+    std::vector<int> im_dimensions;
+    size_t data_offset;
+    {
+        FileOpener f(filename, "rb");
+        if (!check(f.f != nullptr, "File could not be opened for reading")) {
+            return false;
+        }
+        if (!read_npy_header<check>(f, &im_type, &im_dimensions, &data_offset)) {
+            return false;
+        }
+    }
+    return map_file<ImageType, check>(filename, data_offset, im_type, im_dimensions, im);
+}
+
 template<typename ImageType, Internal::CheckFunc check>
 struct ImageIO {
     std::function<bool(const std::string &, ImageType *)> load;
@@ -945,6 +1347,7 @@ bool find_imageio(const std::string &filename, ImageIO<ImageType, check> *result
         {"jpeg", {load_jpg<ImageType, check>, save_jpg<ImageType, check>, query_jpg}},
         {"jpg", {load_jpg<ImageType, check>, save_jpg<ImageType, check>, query_jpg}},
 #endif
+        {"npy", {load_npy<ImageType, check>, save_npy<ImageType, check>, query_npy}},
         {"pgm", {load_pgm<ImageType, check>, save_pgm<ImageType, check>, query_pgm}},
 #ifndef HALIDE_NO_PNG
         {"png", {load_png<ImageType, check>, save_png<ImageType, check>, query_png}},
@@ -967,6 +1370,381 @@ bool find_imageio(const std::string &filename, ImageIO<ImageType, check> *result
     return check(false, err.c_str());
 }
 
+// Readers and writers for one row of an image file at a time, used by
+// ImageStreamReader and ImageStreamWriter. Rows are numbered from zero.
+template<typename ImageType, CheckFunc check>
+class RowReader {
+public:
+    virtual ~RowReader() {}
+
+    // Read row y of the file into row y of an image with the full
+    // width of the file.
+    virtual bool read_row(int y, ImageType *im) = 0;
+
+    halide_type_t type;
+    std::vector<int> extents;
+};
+
+template<typename ImageType, CheckFunc check>
+class RowWriter {
+public:
+    virtual ~RowWriter() {}
+
+    // Write row y of an image, which has the full width of the file,
+    // to row y of the file. Rows are written in increasing order.
+    virtual bool write_row(const ImageType &im, int y) = 0;
+
+    // Finish writing the file.
+    virtual bool finish() {
+        return true;
+    }
+};
+
+#ifndef HALIDE_NO_PNG
+
+// PNG rows can only be decoded in order, so reading an earlier row
+// starts again from the beginning of the file.
+template<typename ImageType, CheckFunc check>
+class PngRowReader : public RowReader<ImageType, check> {
+    std::string filename;
+    std::unique_ptr<FileOpener> f;
+    png_structp png_ptr = nullptr;
+    png_infop info_ptr = nullptr;
+    std::vector<uint8_t> row;
+    int next_row = 0;
+
+    void close() {
+        if (png_ptr) {
+            png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+        }
+        png_ptr = nullptr;
+        info_ptr = nullptr;
+        f.reset();
+    }
+
+public:
+    bool open(const std::string &name) {
+        close();
+        filename = name;
+        f.reset(new FileOpener(filename, "rb"));
+        if (!check(f->f != nullptr, "File could not be opened for reading")) {
+            return false;
+        }
+        png_byte header[8];
+        if (!check(f->read_bytes(header, sizeof(header)), "File ended before end of header")) {
+            return false;
+        }
+        if (!check(!png_sig_cmp(header, 0, 8), "File is not recognized as a PNG file")) {
+            return false;
+        }
+        png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+        if (!check(png_ptr != nullptr, "png_create_read_struct failed")) {
+            return false;
+        }
+        info_ptr = png_create_info_struct(png_ptr);
+        if (!check(info_ptr != nullptr, "png_create_info_struct failed")) {
+            return false;
+        }
+        if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error loading PNG")) {
+            return false;
+        }
+        png_init_io(png_ptr, f->f);
+        png_set_sig_bytes(png_ptr, 8);
+        png_read_info(png_ptr, info_ptr);
+
+        const int channels = png_get_channels(png_ptr, info_ptr);
+        this->type = halide_type_t(halide_type_uint, png_get_bit_depth(png_ptr, info_ptr));
+        this->extents = { (int)png_get_image_width(png_ptr, info_ptr), (int)png_get_image_height(png_ptr, info_ptr) };
+        if (channels != 1) {
+            this->extents.push_back(channels);
+        }
+        png_read_update_info(png_ptr, info_ptr);
+        row.resize(png_get_rowbytes(png_ptr, info_ptr));
+        next_row = 0;
+        return true;
+    }
+
+    bool read_row(int y, ImageType *im) override {
+        if (y < next_row && !open(filename)) {
+            return false;
+        }
+        if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error loading PNG")) {
+            return false;
+        }
+        while (next_row <= y) {
+            png_read_row(png_ptr, row.data(), nullptr);
+            next_row++;
+        }
+        if (this->type.bits == 8) {
+            read_big_endian_row<uint8_t, ImageType>(row.data(), y, im);
+        } else {
+            read_big_endian_row<uint16_t, ImageType>(row.data(), y, im);
+        }
+        return true;
+    }
+
+    ~PngRowReader() override {
+        close();
+    }
+};
+
+template<typename ImageType, CheckFunc check>
+class PngRowWriter : public RowWriter<ImageType, check> {
+    std::unique_ptr<FileOpener> f;
+    png_structp png_ptr = nullptr;
+    png_infop info_ptr = nullptr;
+    std::vector<uint8_t> row;
+    int bit_depth = 0;
+
+public:
+    bool open(const std::string &filename, halide_type_t type, const std::vector<int> &extents) {
+        const int channels = extents.size() > 2 ? extents[2] : 1;
+        if (!check(channels >= 1 && channels <= 4,
+                   "Can't write PNG files that have other than 1, 2, 3, or 4 channels")) {
+            return false;
+        }
+        const png_byte color_types[4] = {
+            PNG_COLOR_TYPE_GRAY,
+            PNG_COLOR_TYPE_GRAY_ALPHA,
+            PNG_COLOR_TYPE_RGB,
+            PNG_COLOR_TYPE_RGB_ALPHA
+        };
+
+        f.reset(new FileOpener(filename, "wb"));
+        if (!check(f->f != nullptr, "File could not be opened for writing")) {
+            return false;
+        }
+        png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+        if (!check(png_ptr != nullptr, "png_create_write_struct failed")) {
+            return false;
+        }
+        info_ptr = png_create_info_struct(png_ptr);
+        if (!check(info_ptr != nullptr, "png_create_info_struct failed")) {
+            return false;
+        }
+        if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error saving PNG")) {
+            return false;
+        }
+        png_init_io(png_ptr, f->f);
+        bit_depth = type.bits;
+        png_set_IHDR(png_ptr, info_ptr, extents[0], extents[1],
+                     bit_depth, color_types[channels - 1], PNG_INTERLACE_NONE,
+                     PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+        png_write_info(png_ptr, info_ptr);
+        row.resize(png_get_rowbytes(png_ptr, info_ptr));
+        return true;
+    }
+
+    bool write_row(const ImageType &im, int y) override {
+        if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error saving PNG")) {
+            return false;
+        }
+        if (bit_depth == 8) {
+            write_big_endian_row<uint8_t, ImageType>(im, y, row.data());
+        } else {
+            write_big_endian_row<uint16_t, ImageType>(im, y, row.data());
+        }
+        png_write_row(png_ptr, row.data());
+        return true;
+    }
+
+    bool finish() override {
+        if (!check(!setjmp(png_jmpbuf(png_ptr)), "Error saving PNG")) {
+            return false;
+        }
+        png_write_end(png_ptr, NULL);
+        return true;
+    }
+
+    ~PngRowWriter() override {
+        if (png_ptr) {
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+        }
+    }
+};
+
+#endif  // not HALIDE_NO_PNG
+
+template<typename ImageType, CheckFunc check>
+class PnmRowReader : public RowReader<ImageType, check> {
+    std::unique_ptr<FileOpener> f;
+    std::vector<uint8_t> row;
+    int64_t data_offset = 0;
+
+public:
+    bool open(const std::string &filename, int channels) {
+        f.reset(new FileOpener(filename, "rb"));
+        int width, height, bit_depth;
+        if (!read_pnm_header<check>(*f, channels == 3 ? "P6" : "P5", &width, &height, &bit_depth)) {
+            return false;
+        }
+        this->type = halide_type_t(halide_type_uint, bit_depth);
+        this->extents = { width, height };
+        if (channels > 1) {
+            this->extents.push_back(channels);
+        }
+        row.resize(width * channels * (bit_depth / 8));
+        data_offset = f->tell();
+        return true;
+    }
+
+    bool read_row(int y, ImageType *im) override {
+        if (!check(f->seek(data_offset + (int64_t)y * row.size()) && f->read_vector(&row),
+                   "Could not read data")) {
+            return false;
+        }
+        if (this->type.bits == 8) {
+            read_big_endian_row<uint8_t, ImageType>(row.data(), y, im);
+        } else {
+            read_big_endian_row<uint16_t, ImageType>(row.data(), y, im);
+        }
+        return true;
+    }
+};
+
+template<typename ImageType, CheckFunc check>
+class PnmRowWriter : public RowWriter<ImageType, check> {
+    std::unique_ptr<FileOpener> f;
+    std::vector<uint8_t> row;
+    int bit_depth = 0;
+
+public:
+    bool open(const std::string &filename, int channels, halide_type_t type, const std::vector<int> &extents) {
+        if (!check((extents.size() > 2 ? extents[2] : 1) == channels, "Wrong number of channels")) {
+            return false;
+        }
+        f.reset(new FileOpener(filename, "wb"));
+        if (!check(f->f != nullptr, "File could not be opened for writing")) {
+            return false;
+        }
+        bit_depth = type.bits;
+        fprintf(f->f, "%s\n%d %d\n%d\n", channels == 3 ? "P6" : "P5", extents[0], extents[1], (1<<bit_depth)-1);
+        row.resize(extents[0] * channels * (bit_depth / 8));
+        return true;
+    }
+
+    bool write_row(const ImageType &im, int y) override {
+        if (bit_depth == 8) {
+            write_big_endian_row<uint8_t, ImageType>(im, y, row.data());
+        } else {
+            write_big_endian_row<uint16_t, ImageType>(im, y, row.data());
+        }
+        return check(f->write_vector(row), "Could not write data");
+    }
+};
+
+// .tmp and .npy files store the image in planar order after a header,
+// so a row is one run of pixels in each plane.
+template<typename ImageType, CheckFunc check>
+class PlanarRowReader : public RowReader<ImageType, check> {
+    std::unique_ptr<FileOpener> f;
+    int64_t data_offset = 0;
+
+public:
+    bool open(const std::string &filename) {
+        f.reset(new FileOpener(filename, "rb"));
+        if (!check(f->f != nullptr, "File could not be opened for reading")) {
+            return false;
+        }
+        if (get_lowercase_extension(filename) == "npy") {
+            size_t offset;
+            if (!read_npy_header<check>(*f, &this->type, &this->extents, &offset)) {
+                return false;
+            }
+            data_offset = offset;
+        } else {
+            int32_t header[5];
+            if (!check(f->read_bytes((uint8_t*) &header[0], sizeof(header)), "Count not read .tmp header")) {
+                return false;
+            }
+            if (!check(header[0] > 0 && header[1] > 0 && header[2] > 0 && header[3] > 0 &&
+                       header[4] >= 0 && header[4] < kNumTmpCodes, "Bad header on .tmp file")) {
+                return false;
+            }
+            this->type = tmp_code_to_halide_type()[header[4]];
+            this->extents = { header[0], header[1], header[2], header[3] };
+            data_offset = sizeof(header);
+        }
+        return check(this->extents.size() >= 2, "Streaming requires at least two dimensions");
+    }
+
+    bool read_row(int y, ImageType *im) override {
+        const halide_buffer_t *buf = im->raw_buffer();
+        const size_t elem_size = this->type.bytes();
+        const int64_t width = this->extents[0], height = this->extents[1];
+        const int64_t planes = im->number_of_elements() / (width * im->dim(1).extent());
+        uint8_t *dst = buf->host + (int64_t)(y - buf->dim[1].min) * buf->dim[1].stride * elem_size;
+        const int64_t plane_stride = buf->dimensions > 2 ? buf->dim[2].stride : 0;
+        for (int64_t p = 0; p < planes; p++) {
+            int64_t offset = data_offset + ((p * height + y) * width) * elem_size;
+            if (!check(f->seek(offset) && f->read_bytes(dst + p * plane_stride * elem_size, width * elem_size),
+                       "Could not read data")) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<typename ImageType, CheckFunc check>
+class PlanarRowWriter : public RowWriter<ImageType, check> {
+    std::unique_ptr<FileOpener> f;
+    int64_t data_offset = 0;
+    std::vector<int> extents;
+    size_t elem_size = 0;
+
+public:
+    bool open(const std::string &filename, halide_type_t type, const std::vector<int> &extents) {
+        this->extents = extents;
+        elem_size = type.bytes();
+        std::string header;
+        if (get_lowercase_extension(filename) == "npy") {
+            header = make_npy_header(type, extents);
+            if (!check(!header.empty(), "Unsupported type for .npy file")) {
+                return false;
+            }
+        } else {
+            int32_t tmp_header[5] = { 1, 1, 1, 1, -1 };
+            for (size_t i = 0; i < extents.size() && i < 4; ++i) {
+                tmp_header[i] = extents[i];
+            }
+            auto *table = tmp_code_to_halide_type();
+            for (int i = 0; i < kNumTmpCodes; i++) {
+                if (type == table[i]) {
+                    tmp_header[4] = i;
+                    break;
+                }
+            }
+            if (!check(tmp_header[4] >= 0, "Unsupported type for .tmp file")) {
+                return false;
+            }
+            header = std::string((const char *)tmp_header, sizeof(tmp_header));
+        }
+        f.reset(new FileOpener(filename, "wb"));
+        if (!check(f->f != nullptr, "File could not be opened for writing")) {
+            return false;
+        }
+        data_offset = header.size();
+        return check(f->write_bytes((const uint8_t *)header.data(), header.size()), "Could not write header");
+    }
+
+    bool write_row(const ImageType &im, int y) override {
+        const halide_buffer_t *buf = im.raw_buffer();
+        const int64_t width = extents[0], height = extents[1];
+        const int64_t planes = im.number_of_elements() / (width * im.dim(1).extent());
+        const uint8_t *src = buf->host + (int64_t)(y - buf->dim[1].min) * buf->dim[1].stride * elem_size;
+        const int64_t plane_stride = buf->dimensions > 2 ? buf->dim[2].stride : 0;
+        for (int64_t p = 0; p < planes; p++) {
+            int64_t offset = data_offset + ((p * height + y) * width) * elem_size;
+            if (!check(f->seek(offset) && f->write_bytes(src + p * plane_stride * elem_size, width * elem_size),
+                       "Could not write data")) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
 // Given something like ImageType<Foo>, produce typedef ImageType<Bar>
 template<typename ImageType, typename ElemType>
 struct ImageTypeWithElemType {
@@ -1242,6 +2020,273 @@ bool save_query(const std::string &filename, std::set<FormatInfo> *info) {
     return true;
 }
 
+// Load a .tmp or .npy file by mapping it into memory, rather than by
+// reading it. The Image aliases the mapping, and unmaps it when the
+// last reference to it is destroyed, so loading is nearly free and the
+// pages are shared with other processes that map the same file. The
+// mapping is copy-on-write, so changes to the Image never reach the
+// file. The Image's host pointer is aligned only as well as the data
+// in the file. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_mapped(const std::string &filename, ImageType *im) {
+    using DynamicImageType = typename Internal::ImageTypeWithElemType<ImageType, void>::type;
+    DynamicImageType im_d;
+    std::string ext = Internal::get_lowercase_extension(filename);
+    bool ok;
+    if (ext == "tmp") {
+        ok = Internal::map_tmp<DynamicImageType, check>(filename, &im_d);
+    } else if (ext == "npy") {
+        ok = Internal::map_npy<DynamicImageType, check>(filename, &im_d);
+    } else {
+        std::string err = "unsupported file extension \"" + ext + "\" for load_mapped(), supported are: npy tmp\n";
+        ok = check(false, err.c_str());
+    }
+    if (!ok) {
+        return false;
+    }
+    if (ImageType::has_static_halide_type) {
+        const halide_type_t expected_type = ImageType::static_halide_type();
+        if (!check(im_d.type() == expected_type, "Image loaded did not match the expected type")) {
+            return false;
+        }
+    }
+    *im = im_d.template as<typename ImageType::ElemType>();
+    return true;
+}
+
+// Like load_mapped, but for a file of raw, headerless data, which is
+// treated as a compact planar image of the given type and size
+// starting at the given byte offset. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool load_mapped_raw(const std::string &filename, halide_type_t type, const std::vector<int> &sizes,
+                     size_t offset, ImageType *im) {
+    using DynamicImageType = typename Internal::ImageTypeWithElemType<ImageType, void>::type;
+    if (ImageType::has_static_halide_type) {
+        const halide_type_t expected_type = ImageType::static_halide_type();
+        if (!check(type == expected_type, "Image loaded did not match the expected type")) {
+            return false;
+        }
+    }
+    DynamicImageType im_d;
+    if (!Internal::map_file<DynamicImageType, check>(filename, offset, type, sizes, &im_d)) {
+        return false;
+    }
+    *im = im_d.template as<typename ImageType::ElemType>();
+    return true;
+}
+
+// Read an image in bands of rows, so that images larger than memory
+// can be processed a band at a time. Supports png, pgm, ppm, tmp and
+// npy files. Rows are dimension 1 of the image, and each band spans
+// all of the other dimensions. Bands may be read in any order, but
+// increasing order is fastest: rows in common with the previous band
+// are copied rather than read again, and reading a png file from an
+// earlier row starts decoding again from the top.
+//
+//    ImageStreamReader<Buffer<uint8_t>> reader;
+//    reader.open("huge.png");
+//    const int height = reader.extents()[1];
+//    for (int y = 0; y < height; y += 64) {
+//        Buffer<uint8_t> band;
+//        reader.read_rows(y, std::min(64, height - y), &band);
+//        ...
+//    }
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+class ImageStreamReader {
+    using DynamicImageType = typename Internal::ImageTypeWithElemType<ImageType, void>::type;
+
+    std::unique_ptr<Internal::RowReader<DynamicImageType, check>> reader;
+    DynamicImageType last_band;
+    int last_min = 0, last_max = -1;
+
+public:
+    // Open a file and read its header. Returns false upon failure.
+    bool open(const std::string &filename) {
+        last_band = DynamicImageType();
+        last_min = 0;
+        last_max = -1;
+        reader.reset();
+        const std::string ext = Internal::get_lowercase_extension(filename);
+        if (ext == "pgm" || ext == "ppm") {
+            auto *r = new Internal::PnmRowReader<DynamicImageType, check>;
+            reader.reset(r);
+            if (!r->open(filename, ext == "ppm" ? 3 : 1)) {
+                return false;
+            }
+        } else if (ext == "tmp" || ext == "npy") {
+            auto *r = new Internal::PlanarRowReader<DynamicImageType, check>;
+            reader.reset(r);
+            if (!r->open(filename)) {
+                return false;
+            }
+#ifndef HALIDE_NO_PNG
+        } else if (ext == "png") {
+            auto *r = new Internal::PngRowReader<DynamicImageType, check>;
+            reader.reset(r);
+            if (!r->open(filename)) {
+                return false;
+            }
+#endif
+        } else {
+            std::string err = "unsupported file extension \"" + ext + "\" for streaming, supported are: npy pgm png ppm tmp\n";
+            return check(false, err.c_str());
+        }
+        if (ImageType::has_static_halide_type) {
+            const halide_type_t expected_type = ImageType::static_halide_type();
+            if (!check(reader->type == expected_type, "Image loaded did not match the expected type")) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The type of the image in the file.
+    halide_type_t type() const {
+        return reader->type;
+    }
+
+    // The extents of the whole image in the file.
+    const std::vector<int> &extents() const {
+        return reader->extents;
+    }
+
+    // Read rows [y, y + rows) of the file into a newly-allocated band,
+    // whose min coordinate in dimension 1 is y. Returns false upon
+    // failure.
+    bool read_rows(int y, int rows, ImageType *band) {
+        if (!check(reader != nullptr, "No file is open for reading")) {
+            return false;
+        }
+        if (!check(y >= 0 && rows > 0 && y + rows <= reader->extents[1], "Rows are outside the image")) {
+            return false;
+        }
+        std::vector<int> band_extents = reader->extents;
+        band_extents[1] = rows;
+        DynamicImageType b(reader->type, band_extents);
+        b.translate(1, y);
+
+        if (last_max >= y && last_min < y + rows) {
+            b.copy_from(last_band);
+        }
+        for (int row = y; row < y + rows; row++) {
+            if (row >= last_min && row <= last_max) {
+                continue;
+            }
+            if (!reader->read_row(row, &b)) {
+                return false;
+            }
+        }
+        b.set_host_dirty();
+
+        last_band = b;
+        last_min = y;
+        last_max = y + rows - 1;
+        *band = b.template as<typename ImageType::ElemType>();
+        return true;
+    }
+};
+
+// Write an image in bands of rows, in increasing order, so that
+// images larger than memory can be produced a band at a time. Supports
+// png, pgm, ppm, tmp and npy files. Each band must span the whole image
+// in every dimension other than dimension 1. The file is complete once
+// every row has been written.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+class ImageStreamWriter {
+    using DynamicImageType = typename Internal::ImageTypeWithElemType<ImageType, void>::type;
+
+    std::unique_ptr<Internal::RowWriter<DynamicImageType, check>> writer;
+    halide_type_t im_type;
+    std::vector<int> im_extents;
+    int next_row = 0;
+
+public:
+    // Create a file for an image of the given type and extents, and
+    // write its header. Returns false upon failure.
+    bool open(const std::string &filename, halide_type_t type, const std::vector<int> &extents) {
+        writer.reset();
+        im_type = type;
+        im_extents = extents;
+        next_row = 0;
+
+        Internal::ImageIO<DynamicImageType, check> imageio;
+        if (!Internal::find_imageio<DynamicImageType, check>(filename, &imageio)) {
+            return false;
+        }
+        if (!check(imageio.query().count({type, (int)extents.size()}) > 0, "Image cannot be saved in this format")) {
+            return false;
+        }
+        if (!check(extents.size() >= 2, "Streaming requires at least two dimensions")) {
+            return false;
+        }
+
+        const std::string ext = Internal::get_lowercase_extension(filename);
+        if (ext == "pgm" || ext == "ppm") {
+            auto *w = new Internal::PnmRowWriter<DynamicImageType, check>;
+            writer.reset(w);
+            return w->open(filename, ext == "ppm" ? 3 : 1, type, extents);
+        } else if (ext == "tmp" || ext == "npy") {
+            auto *w = new Internal::PlanarRowWriter<DynamicImageType, check>;
+            writer.reset(w);
+            return w->open(filename, type, extents);
+#ifndef HALIDE_NO_PNG
+        } else if (ext == "png") {
+            auto *w = new Internal::PngRowWriter<DynamicImageType, check>;
+            writer.reset(w);
+            return w->open(filename, type, extents);
+#endif
+        }
+        std::string err = "unsupported file extension \"" + ext + "\" for streaming, supported are: npy pgm png ppm tmp\n";
+        return check(false, err.c_str());
+    }
+
+    // Write the next band of rows. The band's rows in dimension 1 must
+    // start where the last band ended. Returns false upon failure.
+    bool write_rows(ImageType &band) {
+        if (!check(writer != nullptr, "No file is open for writing")) {
+            return false;
+        }
+        band.copy_to_host();
+        auto b = band.template as<void>();
+        if (!check(b.type() == im_type && b.dimensions() == (int)im_extents.size(), "Band does not match the image")) {
+            return false;
+        }
+        for (int d = 0; d < b.dimensions(); d++) {
+            if (d != 1 && !check(b.dim(d).min() == 0 && b.dim(d).extent() == im_extents[d],
+                                 "Band does not span the whole image")) {
+                return false;
+            }
+        }
+        if (!check(b.dim(1).min() == next_row && b.dim(1).max() < im_extents[1], "Bands must be written in order")) {
+            return false;
+        }
+
+        // The row writers need a compact planar band.
+        if (!Internal::buffer_is_compact_planar(b)) {
+            std::vector<int> band_extents = im_extents;
+            band_extents[1] = b.dim(1).extent();
+            DynamicImageType compact(im_type, band_extents);
+            compact.translate(1, b.dim(1).min());
+            compact.copy_from(b);
+            b = compact;
+        }
+
+        for (int row = b.dim(1).min(); row <= b.dim(1).max(); row++) {
+            if (!writer->write_row(b, row)) {
+                return false;
+            }
+        }
+        next_row = b.dim(1).max() + 1;
+        if (next_row == im_extents[1]) {
+            // Close the file once the last row is written.
+            bool ok = writer->finish();
+            writer.reset();
+            return ok;
+        }
+        return true;
+    }
+};
+
 // Fancy wrapper to call load() with CheckFail, inferring the return type;
 // this allows you to simply use
 //
@@ -1267,6 +2312,24 @@ private:
   const std::string filename;
 };
 
+// Fancy wrapper to call load_mapped() with CheckFail, inferring the
+// return type, as for load_image.
+class load_mapped_image {
+public:
+    load_mapped_image(const std::string &f) : filename(f) {}
+
+    template<typename ImageType>
+    operator ImageType() {
+        using DynamicImageType = typename Internal::ImageTypeWithElemType<ImageType, void>::type;
+        DynamicImageType im_d;
+        (void) load_mapped<DynamicImageType, Internal::CheckFail>(filename, &im_d);
+        return im_d.template as<typename ImageType::ElemType>();
+    }
+
+private:
+  const std::string filename;
+};
+
 // Like load_image, but quietly convert the loaded image to the type of the LHS
 // if necessary, discarding information if necessary.
 class load_and_convert_image {